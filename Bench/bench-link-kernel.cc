@@ -0,0 +1,160 @@
+#include "uav-bench.h"
+#include "../Common/uav-link-kernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct BenchPos {
+    double x, y, z;
+};
+
+typedef std::vector<std::pair<uint32_t, uint32_t>> LinkList;
+
+// 原 UpdateTopology 的逐对扫描（AoS，逐对开方）
+void LoopLinks(const std::vector<BenchPos>& pos, double range, LinkList& links) {
+    links.clear();
+    for (uint32_t i = 0; i < pos.size(); ++i) {
+        for (uint32_t j = i + 1; j < pos.size(); ++j) {
+            double dx = pos[i].x - pos[j].x;
+            double dy = pos[i].y - pos[j].y;
+            double dz = pos[i].z - pos[j].z;
+            if (std::sqrt(dx * dx + dy * dy + dz * dz) <= range) {
+                links.emplace_back(i, j);
+            }
+        }
+    }
+}
+
+void KernelLinks(UavLinkKernel& kernel, const std::vector<double>& x, const std::vector<double>& y,
+                 const std::vector<double>& z, LinkList& links) {
+    links.clear();
+    kernel.ForEachLink(x.data(), y.data(), z.data(), x.size(), [&](uint32_t i, uint32_t j) {
+        links.emplace_back(i, j);
+    });
+}
+
+// 整群掩码 + RSSI，返回所有链路 RSSI 之和（防止被优化掉）并记录每行掩码
+double KernelMatrix(UavLinkKernel& kernel, const std::vector<double>& x, const std::vector<double>& y,
+                    const std::vector<double>& z, std::vector<uint64_t>& masks, std::vector<float>& rssiRow0) {
+    uint32_t n = x.size();
+    uint32_t words = UavLinkKernel::MaskWords(n);
+    masks.resize(static_cast<size_t>(n) * words);
+    double sum = 0.0;
+    kernel.ComputeAll(x.data(), y.data(), z.data(), n, true,
+                      [&](uint32_t i, const uint64_t* mask, const float* rssi) {
+        std::copy(mask, mask + words, masks.begin() + static_cast<size_t>(i) * words);
+        for (uint32_t w = 0; w < words; ++w) {
+            for (uint64_t bits = mask[w]; bits != 0; bits &= bits - 1) {
+                sum += rssi[w * 64 + __builtin_ctzll(bits)];
+            }
+        }
+        if (i == 0) {
+            rssiRow0.assign(rssi, rssi + n);
+        }
+    });
+    return sum;
+}
+
+} // namespace
+
+// 对比向量化链路内核与逐对循环：
+//   links  固定半径判定链路（Second 的拓扑更新），与逐对开方的结果必须一致
+//   rssi   按 log-distance 链路预算计算整群掩码与 RSSI 矩阵（逐行），AVX2 与标量掩码必须逐位一致
+int RunLinkKernelBench(const BenchOptions& opt) {
+    std::mt19937_64 rng(12345);
+    UavLinkKernel scalar, simd;
+    UavLinkBudget rangeBudget;
+    rangeBudget.range = opt.range;
+    scalar.Configure(rangeBudget);
+    simd.Configure(rangeBudget);
+    scalar.SetIsa(UavLinkKernel::SCALAR);
+
+    // 与 Second 的 Wi-Fi 信道相同：YansWifiChannelHelper::Default，23 dBm，灵敏度 -85 dBm
+    UavLinkBudget powerBudget;
+    powerBudget.model = UAV_PATHLOSS_LOG_DISTANCE;
+    powerBudget.txPowerDbm = 23.0;
+    powerBudget.rxSensitivityDbm = -85.0;
+    UavLinkKernel scalarPower, simdPower;
+    scalarPower.Configure(powerBudget);
+    simdPower.Configure(powerBudget);
+    scalarPower.SetIsa(UavLinkKernel::SCALAR);
+
+    std::cout << "kernel: " << UavLinkKernel::IsaName(simd.GetIsa())
+              << ", log-distance range " << std::fixed << std::setprecision(1) << simdPower.GetRange() << " m\n";
+    std::cout << std::setw(8) << "nodes" << std::setw(10) << "links"
+              << std::setw(12) << "loop(ms)" << std::setw(12) << "scalar(ms)" << std::setw(12) << "simd(ms)"
+              << std::setw(9) << "speedup"
+              << std::setw(14) << "rssi-sc(ms)" << std::setw(14) << "rssi-simd(ms)" << std::setw(9) << "speedup"
+              << std::setw(12) << "max-dB-diff" << std::setw(8) << "match" << "\n";
+
+    int failures = 0;
+    LinkList loop, scalarLinks, simdLinks;
+    std::vector<uint64_t> scalarMasks, simdMasks;
+    std::vector<float> scalarRow, simdRow;
+    for (uint32_t n : opt.sizes) {
+        double area = opt.areaSize > 0 ? opt.areaSize : 500.0 * std::sqrt(n / 20.0);
+        std::uniform_real_distribution<double> xy(0.0, area);
+        std::uniform_real_distribution<double> zr(50.0, 150.0);
+
+        double loopTime = 0.0, scalarTime = 0.0, simdTime = 0.0, rssiScalarTime = 0.0, rssiSimdTime = 0.0;
+        double maxDiff = 0.0;
+        bool match = true;
+        for (uint32_t r = 0; r < opt.repeat; ++r) {
+            std::vector<BenchPos> pos(n);
+            std::vector<double> x(n), y(n), z(n);
+            for (uint32_t i = 0; i < n; ++i) {
+                pos[i] = BenchPos{xy(rng), xy(rng), zr(rng)};
+                x[i] = pos[i].x;
+                y[i] = pos[i].y;
+                z[i] = pos[i].z;
+            }
+
+            double t0 = BenchNow();
+            LoopLinks(pos, opt.range, loop);
+            double t1 = BenchNow();
+            KernelLinks(scalar, x, y, z, scalarLinks);
+            double t2 = BenchNow();
+            KernelLinks(simd, x, y, z, simdLinks);
+            double t3 = BenchNow();
+            KernelMatrix(scalarPower, x, y, z, scalarMasks, scalarRow);
+            double t4 = BenchNow();
+            KernelMatrix(simdPower, x, y, z, simdMasks, simdRow);
+            double t5 = BenchNow();
+
+            loopTime += t1 - t0;
+            scalarTime += t2 - t1;
+            simdTime += t3 - t2;
+            rssiScalarTime += t4 - t3;
+            rssiSimdTime += t5 - t4;
+            // 距离正好落在半径上时开方与平方比较可能差一位，随机位置下不会出现
+            match = match && loop == scalarLinks && scalarLinks == simdLinks && scalarMasks == simdMasks;
+            for (uint32_t j = 1; j < n; ++j) {
+                maxDiff = std::max(maxDiff, static_cast<double>(std::fabs(scalarRow[j] - simdRow[j])));
+            }
+        }
+        if (!match) {
+            ++failures;
+        }
+
+        double repeat = std::max<uint32_t>(opt.repeat, 1);
+        std::cout << std::setw(8) << n << std::setw(10) << loop.size() << std::fixed << std::setprecision(3)
+                  << std::setw(12) << loopTime * 1e3 / repeat
+                  << std::setw(12) << scalarTime * 1e3 / repeat
+                  << std::setw(12) << simdTime * 1e3 / repeat
+                  << std::setw(9) << std::setprecision(1) << (simdTime > 0 ? loopTime / simdTime : 0.0)
+                  << std::setprecision(3)
+                  << std::setw(14) << rssiScalarTime * 1e3 / repeat
+                  << std::setw(14) << rssiSimdTime * 1e3 / repeat
+                  << std::setw(9) << std::setprecision(1) << (rssiSimdTime > 0 ? rssiScalarTime / rssiSimdTime : 0.0)
+                  << std::setw(12) << std::scientific << std::setprecision(1) << maxDiff << std::fixed
+                  << std::setw(8) << (match ? "yes" : "NO") << "\n";
+    }
+    return failures == 0 ? 0 : 1;
+}
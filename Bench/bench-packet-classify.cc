@@ -0,0 +1,129 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "uav-bench.h"
+#include "../Common/uav-packet-classifier.h"
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+namespace {
+
+// 原 Ipv4Tracer 的做法：复制数据包后逐个 RemoveHeader
+bool CopyClassify(Ptr<const Packet> packet, UavPacketInfo& info) {
+    Ptr<Packet> pktCopy = packet->Copy();
+    Ipv4Header ipHeader;
+    pktCopy->RemoveHeader(ipHeader);
+    if (ipHeader.GetProtocol() != 6) {
+        return false;
+    }
+    TcpHeader tcpHeader;
+    pktCopy->RemoveHeader(tcpHeader);
+    info.protocol = ipHeader.GetProtocol();
+    info.tcpFlags = tcpHeader.GetFlags();
+    info.isAck = tcpHeader.GetFlags() & TcpHeader::ACK;
+    info.payloadSize = pktCopy->GetSize();
+    info.source = ipHeader.GetSource();
+    info.destination = ipHeader.GetDestination();
+    return true;
+}
+
+Ptr<Packet> MakeTcpPacket(uint32_t payload, uint8_t flags, bool timestamps, uint32_t src, uint32_t dst) {
+    Ptr<Packet> p = Create<Packet>(payload);
+    TcpHeader tcp;
+    tcp.SetSourcePort(49153);
+    tcp.SetDestinationPort(9999);
+    tcp.SetSequenceNumber(SequenceNumber32(1000 + src));
+    tcp.SetAckNumber(SequenceNumber32(2000 + dst));
+    tcp.SetFlags(flags);
+    tcp.SetWindowSize(65535);
+    if (timestamps) {
+        Ptr<TcpOptionTS> ts = CreateObject<TcpOptionTS>();
+        ts->SetTimestamp(12345);
+        ts->SetEcho(6789);
+        tcp.AppendOption(ts);
+    }
+    p->AddHeader(tcp);
+
+    Ipv4Header ip;
+    ip.SetSource(Ipv4Address(0x0a000001 + src));
+    ip.SetDestination(Ipv4Address(0x0a000001 + dst));
+    ip.SetProtocol(6);
+    ip.SetPayloadSize(p->GetSize());
+    ip.SetTtl(64);
+    p->AddHeader(ip);
+    return p;
+}
+
+Ptr<Packet> MakeUdpPacket(uint32_t payload, uint32_t src, uint32_t dst) {
+    Ptr<Packet> p = Create<Packet>(payload);
+    UdpHeader udp;
+    udp.SetSourcePort(654);
+    udp.SetDestinationPort(654);
+    p->AddHeader(udp);
+
+    Ipv4Header ip;
+    ip.SetSource(Ipv4Address(0x0a000001 + src));
+    ip.SetDestination(Ipv4Address(0x0a000001 + dst));
+    ip.SetProtocol(17);
+    ip.SetPayloadSize(p->GetSize());
+    p->AddHeader(ip);
+    return p;
+}
+
+template <typename Classify>
+double EventsPerSecond(const std::vector<Ptr<Packet>>& packets, uint32_t iterations,
+                       Classify classify, uint64_t& accepted) {
+    UavPacketInfo info;
+    accepted = 0;
+    double t0 = BenchNow();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        if (classify(packets[i % packets.size()], info)) {
+            accepted += info.payloadSize + info.isAck;
+        }
+    }
+    return iterations / (BenchNow() - t0);
+}
+
+} // namespace
+
+// 高负载下 Ipv4Tracer 报文分类的吞吐：复制+反序列化 vs 按偏移只读解析
+int RunPacketClassifyBench(const BenchOptions& opt) {
+    // 报文组合：TCP 数据、纯 ACK、SYN，以及 AODV 等 UDP 报文
+    std::vector<Ptr<Packet>> packets;
+    for (uint32_t i = 0; i < 64; ++i) {
+        uint32_t src = i % 20, dst = (i * 7 + 3) % 20;
+        switch (i % 4) {
+        case 0: packets.push_back(MakeTcpPacket(512, TcpHeader::ACK | TcpHeader::PSH, true, src, dst)); break;
+        case 1: packets.push_back(MakeTcpPacket(0, TcpHeader::ACK, true, src, dst)); break;
+        case 2: packets.push_back(MakeTcpPacket(0, TcpHeader::SYN, false, src, dst)); break;
+        default: packets.push_back(MakeUdpPacket(64, src, dst)); break;
+        }
+    }
+
+    // 两种实现的分类结果必须一致
+    for (Ptr<Packet> p : packets) {
+        UavPacketInfo a, b;
+        bool okA = CopyClassify(p, a);
+        bool okB = UavClassifyTcp(p, b);
+        if (okA != okB || (okA && (a.isAck != b.isAck || a.payloadSize != b.payloadSize ||
+                                   a.source != b.source || a.destination != b.destination))) {
+            std::cerr << "classification mismatch" << std::endl;
+            return 1;
+        }
+    }
+
+    uint64_t acceptedCopy = 0, acceptedPeek = 0;
+    double copyRate = EventsPerSecond(packets, opt.iterations, &CopyClassify, acceptedCopy);
+    double peekRate = EventsPerSecond(packets, opt.iterations, &UavClassifyTcp, acceptedPeek);
+
+    std::cout << std::setw(16) << "method" << std::setw(18) << "events/s" << "\n"
+              << std::fixed << std::setprecision(0)
+              << std::setw(16) << "copy+remove" << std::setw(18) << copyRate << "\n"
+              << std::setw(16) << "peek" << std::setw(18) << peekRate << "\n"
+              << std::setprecision(1) << "speedup: " << peekRate / copyRate << "x" << std::endl;
+    return acceptedCopy == acceptedPeek ? 0 : 1;
+}
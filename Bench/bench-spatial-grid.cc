@@ -0,0 +1,97 @@
+#include "uav-bench.h"
+#include "../Common/uav-spatial-grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct BenchPos {
+    double x, y, z;
+};
+
+typedef std::vector<std::pair<uint32_t, uint32_t>> LinkList;
+
+// 原 UpdateTopology 的逐对扫描
+void BruteForceLinks(const std::vector<BenchPos>& pos, double range, LinkList& links) {
+    links.clear();
+    for (uint32_t i = 0; i < pos.size(); ++i) {
+        for (uint32_t j = i + 1; j < pos.size(); ++j) {
+            double dx = pos[i].x - pos[j].x;
+            double dy = pos[i].y - pos[j].y;
+            double dz = pos[i].z - pos[j].z;
+            if (std::sqrt(dx * dx + dy * dy + dz * dz) <= range) {
+                links.emplace_back(i, j);
+            }
+        }
+    }
+}
+
+void GridLinks(UavSpatialGrid& grid, const std::vector<BenchPos>& pos, double range, LinkList& links) {
+    links.clear();
+    grid.Build(pos, range);
+    grid.ForEachPairWithin(pos, range, [&](uint32_t i, uint32_t j) {
+        links.emplace_back(i, j);
+    });
+    std::sort(links.begin(), links.end());
+}
+
+} // namespace
+
+// 对比空间网格与逐对扫描：链路集合必须完全一致，并给出耗时
+int RunSpatialGridBench(const BenchOptions& opt) {
+    std::mt19937_64 rng(12345);
+    UavSpatialGrid grid;
+    LinkList brute, fast;
+    int failures = 0;
+
+    std::cout << std::setw(8) << "nodes" << std::setw(10) << "area(m)"
+              << std::setw(10) << "links" << std::setw(14) << "brute(ms)"
+              << std::setw(14) << "grid(ms)" << std::setw(10) << "speedup"
+              << std::setw(8) << "match" << "\n";
+
+    for (uint32_t n : opt.sizes) {
+        // 默认按规模缩放区域，保持与 20 架 / 500 米场景相同的平面密度
+        double area = opt.areaSize > 0 ? opt.areaSize : 500.0 * std::sqrt(n / 20.0);
+        std::uniform_real_distribution<double> xy(0.0, area);
+        std::uniform_real_distribution<double> z(50.0, 150.0);
+
+        double bruteTime = 0.0, gridTime = 0.0;
+        bool match = true;
+        for (uint32_t r = 0; r < opt.repeat; ++r) {
+            std::vector<BenchPos> pos(n);
+            for (BenchPos& p : pos) {
+                p.x = xy(rng);
+                p.y = xy(rng);
+                p.z = z(rng);
+            }
+
+            double t0 = BenchNow();
+            BruteForceLinks(pos, opt.range, brute);
+            double t1 = BenchNow();
+            GridLinks(grid, pos, opt.range, fast);
+            double t2 = BenchNow();
+
+            bruteTime += t1 - t0;
+            gridTime += t2 - t1;
+            match = match && (brute == fast);
+        }
+        if (!match) {
+            ++failures;
+        }
+
+        double repeat = std::max<uint32_t>(opt.repeat, 1);
+        std::cout << std::setw(8) << n << std::setw(10) << std::fixed << std::setprecision(0) << area
+                  << std::setw(10) << brute.size() << std::setprecision(3)
+                  << std::setw(14) << bruteTime * 1e3 / repeat
+                  << std::setw(14) << gridTime * 1e3 / repeat
+                  << std::setw(10) << std::setprecision(1) << (gridTime > 0 ? bruteTime / gridTime : 0.0)
+                  << std::setw(8) << (match ? "yes" : "NO") << "\n";
+    }
+    return failures == 0 ? 0 : 1;
+}
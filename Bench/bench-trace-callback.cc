@@ -0,0 +1,82 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "uav-bench.h"
+
+#include <iomanip>
+#include <iostream>
+
+using namespace ns3;
+
+namespace {
+
+volatile uint64_t g_sink = 0;
+
+// 旧实现：Config::Connect 带 context，回调里解析 "/NodeList/N/..."（First/Second）
+void ContextMacTx(std::string context, Ptr<const Packet> packet) {
+    std::string prefix = "/NodeList/";
+    size_t startPos = context.find(prefix) + prefix.size();
+    size_t endPos = context.find('/', startPos);
+    g_sink = g_sink + std::stoul(context.substr(startPos, endPos - startPos));
+}
+
+// 旧实现：Third 的 Ipv4Tracer 还要再查找 "/Tx" 判断方向
+void ContextIpv4(std::string context, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface) {
+    size_t pos1 = context.find("/NodeList/") + 10;
+    size_t pos2 = context.find("/", pos1);
+    uint32_t nodeId = atoi(context.substr(pos1, pos2 - pos1).c_str());
+    bool isTx = context.find("/Tx") != std::string::npos;
+    g_sink = g_sink + nodeId + isTx;
+}
+
+// 新实现：节点号和方向已绑定
+void BoundMacTx(uint32_t nodeId, Ptr<const Packet> packet) {
+    g_sink = g_sink + nodeId;
+}
+
+void BoundIpv4(uint32_t nodeId, bool isTx, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface) {
+    g_sink = g_sink + nodeId + isTx;
+}
+
+template <typename Fire>
+double TimePerCall(uint32_t iterations, Fire fire) {
+    double t0 = BenchNow();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        fire();
+    }
+    return (BenchNow() - t0) * 1e9 / iterations;
+}
+
+} // namespace
+
+// 通过真实的 TracedCallback 触发，比较两种挂接方式每次回调的开销
+int RunTraceCallbackBench(const BenchOptions& opt) {
+    Ptr<const Packet> packet = Create<Packet>(512);
+    Ptr<Ipv4> ipv4;
+    uint32_t nodeId = 1234;
+
+    TracedCallback<Ptr<const Packet>> macOld, macNew;
+    macOld.Connect(MakeCallback(&ContextMacTx),
+                   "/NodeList/" + std::to_string(nodeId) + "/DeviceList/0/$ns3::WifiNetDevice/Mac/MacTx");
+    macNew.ConnectWithoutContext(MakeBoundCallback(&BoundMacTx, nodeId));
+
+    TracedCallback<Ptr<const Packet>, Ptr<Ipv4>, uint32_t> ipOld, ipNew;
+    ipOld.Connect(MakeCallback(&ContextIpv4),
+                  "/NodeList/" + std::to_string(nodeId) + "/$ns3::Ipv4L3Protocol/Tx");
+    ipNew.ConnectWithoutContext(MakeBoundCallback(&BoundIpv4, nodeId, true));
+
+    uint32_t n = opt.iterations;
+    double macOldNs = TimePerCall(n, [&]() { macOld(packet); });
+    double macNewNs = TimePerCall(n, [&]() { macNew(packet); });
+    double ipOldNs = TimePerCall(n, [&]() { ipOld(packet, ipv4, 1); });
+    double ipNewNs = TimePerCall(n, [&]() { ipNew(packet, ipv4, 1); });
+
+    std::cout << std::setw(10) << "trace" << std::setw(16) << "context(ns)"
+              << std::setw(14) << "bound(ns)" << std::setw(10) << "speedup" << "\n"
+              << std::fixed << std::setprecision(1)
+              << std::setw(10) << "MacTx" << std::setw(16) << macOldNs << std::setw(14) << macNewNs
+              << std::setw(10) << macOldNs / macNewNs << "\n"
+              << std::setw(10) << "Ipv4Tx" << std::setw(16) << ipOldNs << std::setw(14) << ipNewNs
+              << std::setw(10) << ipOldNs / ipNewNs << "\n";
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include "ns3/core-module.h"
+#include "uav-bench.h"
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("UavBench");
+
+int main(int argc, char *argv[]) {
+    std::string benchCase = "grid";
+    std::string sizes = "20,100,500,1000,2000,5000";
+    BenchOptions opt;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("case", "Benchmark case: grid|callback|classify|kernel", benchCase);
+    cmd.AddValue("sizes", "Comma-separated swarm sizes", sizes);
+    cmd.AddValue("repeat", "Repetitions per size", opt.repeat);
+    cmd.AddValue("area", "Area side in meters (0 = scale with size)", opt.areaSize);
+    cmd.AddValue("range", "Communication range in meters", opt.range);
+    cmd.AddValue("iterations", "Calls per microbenchmark", opt.iterations);
+    cmd.Parse(argc, argv);
+
+    opt.sizes = ParseSizeList(sizes);
+
+    if (benchCase == "grid") {
+        return RunSpatialGridBench(opt);
+    }
+    if (benchCase == "callback") {
+        return RunTraceCallbackBench(opt);
+    }
+    if (benchCase == "classify") {
+        return RunPacketClassifyBench(opt);
+    }
+    if (benchCase == "kernel") {
+        return RunLinkKernelBench(opt);
+    }
+    std::cerr << "Unknown benchmark case: " << benchCase << std::endl;
+    return 1;
+}
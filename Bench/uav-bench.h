@@ -0,0 +1,44 @@
+#ifndef UAV_BENCH_H
+#define UAV_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 基准测试公共参数
+struct BenchOptions {
+    std::vector<uint32_t> sizes;  // 待测试的集群规模
+    uint32_t repeat = 5;          // 每个规模重复次数（取平均）
+    double areaSize = 0.0;        // 区域边长（米），0 表示按规模缩放保持密度不变
+    double range = 250.0;         // 通信半径（米）
+    uint32_t iterations = 1000000; // 微基准的调用次数
+};
+
+// 解析 "20,50,100" 形式的规模列表
+inline std::vector<uint32_t> ParseSizeList(const std::string& text) {
+    std::vector<uint32_t> sizes;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            sizes.push_back(std::stoul(item));
+        }
+    }
+    return sizes;
+}
+
+// 单调时钟计时（秒）
+inline double BenchNow() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 各基准用例，返回 0 表示通过
+int RunSpatialGridBench(const BenchOptions& opt);
+int RunTraceCallbackBench(const BenchOptions& opt);
+int RunPacketClassifyBench(const BenchOptions& opt);
+int RunLinkKernelBench(const BenchOptions& opt);
+
+#endif // UAV_BENCH_H
@@ -0,0 +1,251 @@
+#ifndef UAV_ABSTRACT_PHY_H
+#define UAV_ABSTRACT_PHY_H
+
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/double.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/mac48-address.h"
+#include "ns3/mobility-model.h"
+#include "ns3/net-device-container.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/pointer.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/traced-callback.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 抽象物理层（--phyMode=abstract）
+// 用轻量的链路抽象替代 YansWifiPhy + 802.11ac MAC，只回答“谁能在什么时候听到谁”：
+//   - 接收功率 = 发射功率 - 传播损耗（沿用各场景 Wi-Fi 信道的 Friis / LogDistance 模型），
+//     低于接收灵敏度的节点听不到；
+//   - 空口时间按固定速率计算，同一接收端上重叠的两帧都丢弃（无载波侦听和重传）；
+//   - 另可按固定概率随机丢帧。
+// 设备在 IP 层之下的接口与 SimpleNetDevice 相同（ARP、AODV 广播照常工作），
+// 并提供与 WifiMac 同名的 "MacTx" trace，已有的 trace 回调和输出格式不变。
+// MacTx 报文不含 Wi-Fi 的 LLC/SNAP 头，记录的包长比 Wi-Fi 模式少 8 字节。
+
+namespace ns3 {
+
+// 带 MacTx trace 的 SimpleNetDevice
+class UavLinkNetDevice : public SimpleNetDevice {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::UavLinkNetDevice")
+            .SetParent<SimpleNetDevice>()
+            .SetGroupName("Network")
+            .AddConstructor<UavLinkNetDevice>()
+            .AddTraceSource("MacTx",
+                            "A packet has been received from higher layers for transmission",
+                            MakeTraceSourceAccessor(&UavLinkNetDevice::m_macTxTrace),
+                            "ns3::Packet::TracedCallback");
+        return tid;
+    }
+
+    bool SendFrom(Ptr<Packet> packet, const Address& source, const Address& dest,
+                  uint16_t protocolNumber) override {
+        m_macTxTrace(packet);
+        return SimpleNetDevice::SendFrom(packet, source, dest, protocolNumber);
+    }
+
+private:
+    TracedCallback<Ptr<const Packet>> m_macTxTrace;
+};
+
+// 按传播损耗判定可达、按接收端空口占用判定冲突的广播信道
+class UavRangeChannel : public SimpleChannel {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::UavRangeChannel")
+            .SetParent<SimpleChannel>()
+            .SetGroupName("Network")
+            .AddConstructor<UavRangeChannel>()
+            .AddAttribute("PropagationLossModel", "Loss model deciding who can hear whom",
+                          PointerValue(),
+                          MakePointerAccessor(&UavRangeChannel::m_loss),
+                          MakePointerChecker<PropagationLossModel>())
+            .AddAttribute("TxPower", "Transmit power in dBm",
+                          DoubleValue(23.0),
+                          MakeDoubleAccessor(&UavRangeChannel::m_txPowerDbm),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("RxSensitivity", "Minimum received power in dBm",
+                          DoubleValue(-101.0),
+                          MakeDoubleAccessor(&UavRangeChannel::m_rxSensitivityDbm),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("DataRate", "Air rate used for frame durations",
+                          DataRateValue(DataRate("29.3Mbps")),
+                          MakeDataRateAccessor(&UavRangeChannel::m_dataRate),
+                          MakeDataRateChecker())
+            .AddAttribute("Collisions", "Drop frames that overlap at a receiver",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&UavRangeChannel::m_collisions),
+                          MakeBooleanChecker())
+            .AddAttribute("LossProbability", "Probability of losing a frame that was heard",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&UavRangeChannel::m_lossProbability),
+                          MakeDoubleChecker<double>(0.0, 1.0));
+        return tid;
+    }
+
+    UavRangeChannel() : m_random(CreateObject<UniformRandomVariable>()) {}
+
+    void Add(Ptr<SimpleNetDevice> device) override {
+        SimpleChannel::Add(device);
+        m_devices.push_back(device);
+        m_mobility.push_back(nullptr);
+        m_receivers.push_back(Receiver());
+    }
+
+    void Send(Ptr<Packet> p, uint16_t protocol, Mac48Address to, Mac48Address from,
+              Ptr<SimpleNetDevice> sender) override {
+        NS_ASSERT_MSG(m_loss, "UavRangeChannel needs a PropagationLossModel");
+        Ptr<MobilityModel> txMobility = sender->GetNode()->GetObject<MobilityModel>();
+        Time now = Simulator::Now();
+        Time txTime = m_dataRate.CalculateBytesTxTime(p->GetSize());
+        bool group = to.IsBroadcast() || to.IsGroup();
+        for (uint32_t k = 0; k < m_devices.size(); ++k) {
+            Ptr<SimpleNetDevice> device = m_devices[k];
+            if (device == sender) {
+                continue;
+            }
+            if (!m_mobility[k]) {
+                m_mobility[k] = device->GetNode()->GetObject<MobilityModel>();
+            }
+            if (m_loss->CalcRxPower(m_txPowerDbm, txMobility, m_mobility[k]) < m_rxSensitivityDbm) {
+                continue;
+            }
+            // 听得到的帧都占用接收端，无论是否发给它
+            Time start = now + Seconds(txMobility->GetDistanceFrom(m_mobility[k]) / SPEED_OF_LIGHT);
+            Receiver& rx = m_receivers[k];
+            if (m_collisions && start < rx.busyUntil) {
+                rx.collided = true;   // 正在接收的帧也被破坏
+                ++m_collisionCount;
+                // 被丢弃的帧同样占用信道，与它重叠的后续帧也算碰撞
+                rx.busyUntil = std::max(rx.busyUntil, start + txTime);
+                continue;
+            }
+            rx.busyUntil = start + txTime;
+            rx.id = ++m_nextId;
+            rx.collided = m_lossProbability > 0.0 && m_random->GetValue() < m_lossProbability;
+            if (group || device->GetAddress() == to) {
+                Simulator::ScheduleWithContext(device->GetNode()->GetId(), rx.busyUntil - now,
+                                               &UavRangeChannel::Deliver, this, k, rx.id,
+                                               p->Copy(), protocol, to, from);
+            }
+        }
+    }
+
+    // 随机丢帧使用的随机流，返回占用的流数
+    int64_t AssignStreams(int64_t stream) {
+        m_random->SetStream(stream);
+        return 1;
+    }
+
+    uint64_t GetDelivered() const { return m_delivered; }
+    uint64_t GetCollisions() const { return m_collisionCount; }
+    uint64_t GetLost() const { return m_lost; }
+
+private:
+    static constexpr double SPEED_OF_LIGHT = 299792458.0;
+
+    // 接收端状态：当前帧的结束时刻、编号和是否已损坏
+    struct Receiver {
+        Time busyUntil;
+        uint64_t id = 0;
+        bool collided = false;
+    };
+
+    void Deliver(uint32_t k, uint64_t id, Ptr<Packet> p, uint16_t protocol,
+                 Mac48Address to, Mac48Address from) {
+        const Receiver& rx = m_receivers[k];
+        if (rx.id == id && rx.collided) {
+            ++m_lost;
+            return;
+        }
+        ++m_delivered;
+        m_devices[k]->Receive(p, protocol, to, from);
+    }
+
+    Ptr<PropagationLossModel> m_loss;
+    double m_txPowerDbm;
+    double m_rxSensitivityDbm;
+    DataRate m_dataRate;
+    bool m_collisions;
+    double m_lossProbability;
+    Ptr<UniformRandomVariable> m_random;
+
+    std::vector<Ptr<SimpleNetDevice>> m_devices;
+    std::vector<Ptr<MobilityModel>> m_mobility;   // 首次发送时缓存
+    std::vector<Receiver> m_receivers;
+    uint64_t m_nextId = 0;
+    uint64_t m_delivered = 0;
+    uint64_t m_collisionCount = 0;
+    uint64_t m_lost = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(UavLinkNetDevice);
+NS_OBJECT_ENSURE_REGISTERED(UavRangeChannel);
+
+// 为所有节点安装 UavLinkNetDevice，连到同一个 UavRangeChannel
+class UavAbstractPhyHelper {
+public:
+    UavAbstractPhyHelper() {
+        m_channelFactory.SetTypeId("ns3::UavRangeChannel");
+        m_lossFactory.SetTypeId("ns3::LogDistancePropagationLossModel");
+    }
+
+    template <typename... Args>
+    void SetPropagationLoss(const std::string& type, Args&&... args) {
+        m_lossFactory.SetTypeId(type);
+        m_lossFactory.Set(std::forward<Args>(args)...);
+    }
+
+    // TxPower / RxSensitivity / DataRate / Collisions / LossProbability
+    void SetChannelAttribute(const std::string& name, const AttributeValue& value) {
+        m_channelFactory.Set(name, value);
+    }
+
+    NetDeviceContainer Install(const NodeContainer& nodes) {
+        m_channel = m_channelFactory.Create<UavRangeChannel>();
+        m_channel->SetAttribute("PropagationLossModel", PointerValue(m_lossFactory.Create<PropagationLossModel>()));
+        DataRateValue rate;
+        m_channel->GetAttribute("DataRate", rate);
+        NetDeviceContainer devices;
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+            Ptr<UavLinkNetDevice> device = CreateObject<UavLinkNetDevice>();
+            device->SetAttribute("DataRate", rate);
+            device->SetAddress(Mac48Address::Allocate());
+            (*it)->AddDevice(device);
+            device->SetChannel(m_channel);
+            Ptr<Queue<Packet>> queue = CreateObject<DropTailQueue<Packet>>();
+            device->SetQueue(queue);
+            // 与 SimpleNetDeviceHelper 相同，开启流控
+            Ptr<NetDeviceQueueInterface> queueInterface = CreateObject<NetDeviceQueueInterface>();
+            queueInterface->GetTxQueue(0)->ConnectQueueTraces(queue);
+            device->AggregateObject(queueInterface);
+            devices.Add(device);
+        }
+        return devices;
+    }
+
+    Ptr<UavRangeChannel> GetChannel() const { return m_channel; }
+
+private:
+    ObjectFactory m_channelFactory;
+    ObjectFactory m_lossFactory;
+    Ptr<UavRangeChannel> m_channel;
+};
+
+} // namespace ns3
+
+#endif // UAV_ABSTRACT_PHY_H
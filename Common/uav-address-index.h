@@ -0,0 +1,167 @@
+#ifndef UAV_ADDRESS_INDEX_H
+#define UAV_ADDRESS_INDEX_H
+
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/node-container.h"
+
+#include <cstdint>
+#include <vector>
+
+// IPv4 地址 → 节点索引
+// 开放寻址（线性探测）的扁平哈希表，在 Ipv4AddressHelper::Assign 之后构建一次，
+// 收包回调中 O(1) 查找，替代逐节点调用 GetAddress 的线性扫描。
+// 节点的每个接口、每个地址都会登记，支持多接口（多电台）节点。
+
+namespace ns3 {
+
+class UavAddressIndex {
+public:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    // 登记 nodes 中所有节点所有接口上的非回环地址
+    void Build(const NodeContainer& nodes) {
+        Clear();
+        uint32_t count = 0;
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+            Ptr<Ipv4> ipv4 = (*it)->GetObject<Ipv4>();
+            if (ipv4) {
+                for (uint32_t i = 0; i < ipv4->GetNInterfaces(); ++i) {
+                    count += ipv4->GetNAddresses(i);
+                }
+            }
+        }
+        Reserve(count);
+
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+            Ptr<Node> node = *it;
+            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+            if (!ipv4) {
+                continue;
+            }
+            for (uint32_t i = 0; i < ipv4->GetNInterfaces(); ++i) {
+                for (uint32_t a = 0; a < ipv4->GetNAddresses(i); ++a) {
+                    Ipv4Address local = ipv4->GetAddress(i, a).GetLocal();
+                    if (!local.IsLocalhost()) {
+                        Insert(local, node->GetId(), i);
+                    }
+                }
+            }
+        }
+    }
+
+    void Clear() {
+        m_slots.clear();
+        m_mask = 0;
+        m_size = 0;
+        m_primary.clear();
+    }
+
+    // 预留至少 count 个地址的空间（负载因子 ≤ 0.5）
+    void Reserve(uint32_t count) {
+        uint32_t capacity = 16;
+        while (capacity < 2 * count) {
+            capacity *= 2;
+        }
+        if (capacity <= m_slots.size()) {
+            return;
+        }
+        std::vector<Slot> old;
+        old.swap(m_slots);
+        m_slots.assign(capacity, Slot());
+        m_mask = capacity - 1;
+        m_size = 0;
+        for (const Slot& s : old) {
+            if (s.key != EMPTY) {
+                Place(s);
+            }
+        }
+    }
+
+    void Insert(Ipv4Address address, uint32_t nodeId, uint32_t interface) {
+        if (2 * (m_size + 1) > m_slots.size()) {
+            Reserve(m_size + 1);
+        }
+        Slot s;
+        s.key = address.Get();
+        s.nodeId = nodeId;
+        s.interface = interface;
+        Place(s);
+
+        // 每个节点第一个登记的地址作为其主地址
+        if (nodeId >= m_primary.size()) {
+            m_primary.resize(nodeId + 1, Ipv4Address::GetAny());
+        }
+        if (m_primary[nodeId] == Ipv4Address::GetAny()) {
+            m_primary[nodeId] = address;
+        }
+    }
+
+    // 地址所属节点，未登记时返回 NOT_FOUND
+    uint32_t GetNodeId(Ipv4Address address) const {
+        const Slot* s = Find(address.Get());
+        return s ? s->nodeId : NOT_FOUND;
+    }
+
+    // 地址所在接口编号，未登记时返回 NOT_FOUND
+    uint32_t GetInterface(Ipv4Address address) const {
+        const Slot* s = Find(address.Get());
+        return s ? s->interface : NOT_FOUND;
+    }
+
+    // 节点的主地址（第一个登记的地址）
+    Ipv4Address GetAddress(uint32_t nodeId) const {
+        return nodeId < m_primary.size() ? m_primary[nodeId] : Ipv4Address::GetAny();
+    }
+
+    uint32_t GetSize() const { return m_size; }
+
+private:
+    // 0.0.0.0 不会分配给接口，作为空槽标记
+    static constexpr uint32_t EMPTY = 0;
+
+    struct Slot {
+        uint32_t key = EMPTY;
+        uint32_t nodeId = NOT_FOUND;
+        uint32_t interface = NOT_FOUND;
+    };
+
+    static uint32_t Hash(uint32_t key) {
+        // 同一子网的地址只有低位不同，乘法散列把连续地址打散到各槽位
+        return (key * 0x9E3779B1u) ^ (key >> 16);
+    }
+
+    void Place(const Slot& s) {
+        uint32_t i = Hash(s.key) & m_mask;
+        while (m_slots[i].key != EMPTY && m_slots[i].key != s.key) {
+            i = (i + 1) & m_mask;
+        }
+        if (m_slots[i].key == EMPTY) {
+            ++m_size;
+        }
+        m_slots[i] = s;
+    }
+
+    const Slot* Find(uint32_t key) const {
+        if (m_slots.empty() || key == EMPTY) {
+            return nullptr;
+        }
+        uint32_t i = Hash(key) & m_mask;
+        while (m_slots[i].key != EMPTY) {
+            if (m_slots[i].key == key) {
+                return &m_slots[i];
+            }
+            i = (i + 1) & m_mask;
+        }
+        return nullptr;
+    }
+
+    std::vector<Slot> m_slots;
+    uint32_t m_mask = 0;
+    uint32_t m_size = 0;
+    std::vector<Ipv4Address> m_primary;  // 节点号 → 主地址
+};
+
+} // namespace ns3
+
+#endif // UAV_ADDRESS_INDEX_H
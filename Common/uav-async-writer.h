@@ -0,0 +1,320 @@
+#ifndef UAV_ASYNC_WRITER_H
+#define UAV_ASYNC_WRITER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 异步 trace 写盘
+// 仿真线程把数据写进预分配的缓冲块，写满后交给后台线程 fwrite，自身不碰磁盘。
+// 缓冲块组成单生产者/单消费者环：生产者只推进 m_submitted，写盘线程只推进 m_drained，
+// 数据路径上没有锁；互斥量只用于写盘线程空闲时睡眠。
+// 内存上限为 numBuffers * bufferKb，环满时按背压策略阻塞仿真线程或丢弃整块数据。
+// Close（或析构）保证所有已写入的数据落盘，场景里通过 Simulator::ScheduleDestroy 调用。
+
+enum UavBackPressure {
+    UAV_BACKPRESSURE_BLOCK = 0,  // 环满时仿真线程等待写盘线程腾出缓冲块（默认，不丢数据）
+    UAV_BACKPRESSURE_DROP        // 环满时丢弃当前缓冲块中已完成的记录/行，并计数
+};
+
+struct UavAsyncOptions {
+    bool async = true;           // false 时在调用线程同步写盘（原行为）
+    uint32_t bufferKb = 1024;    // 每个缓冲块大小
+    uint32_t numBuffers = 4;     // 缓冲块个数（至少 2）
+    UavBackPressure policy = UAV_BACKPRESSURE_BLOCK;
+};
+
+// 解析 "block" / "drop"
+inline bool UavParseBackPressure(const std::string& text, UavBackPressure& policy) {
+    if (text == "block") {
+        policy = UAV_BACKPRESSURE_BLOCK;
+    } else if (text == "drop") {
+        policy = UAV_BACKPRESSURE_DROP;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 缓冲块环 + 写盘线程
+// 两种用法（同一个对象只用其一）：
+//   Write(data, n)        定长记录，一次调用的数据不会被拆到两个块里，也不会被部分丢弃；
+//   GetBuffer / Commit    由调用方直接往当前块里写（见 UavAsyncStreamBuf）。
+class UavAsyncFileWriter {
+public:
+    UavAsyncFileWriter() = default;
+    UavAsyncFileWriter(const UavAsyncFileWriter&) = delete;
+    UavAsyncFileWriter& operator=(const UavAsyncFileWriter&) = delete;
+
+    ~UavAsyncFileWriter() { Close(); }
+
+    bool Open(const std::string& path, const UavAsyncOptions& options = UavAsyncOptions()) {
+        Close();
+        m_file = std::fopen(path.c_str(), "wb");
+        if (!m_file) {
+            return false;
+        }
+        m_options = options;
+        m_bufferSize = std::max<size_t>(options.bufferKb, 1) * 1024;
+        uint32_t count = options.async ? std::max<uint32_t>(options.numBuffers, 2) : 1;
+        m_buffers.assign(count, std::vector<char>(m_bufferSize));
+        m_lengths.assign(count, 0);
+        m_submitted.store(0, std::memory_order_relaxed);
+        m_drained.store(0, std::memory_order_relaxed);
+        m_used = 0;
+        m_stop = false;
+        m_ioError = false;
+        m_bytesWritten = 0;
+        m_bytesDropped = 0;
+        m_stallNanoseconds = 0;
+        if (options.async) {
+            m_thread = std::thread(&UavAsyncFileWriter::DrainLoop, this);
+        }
+        return true;
+    }
+
+    bool IsOpen() const { return m_file != nullptr; }
+
+    // 定长记录写入
+    void Write(const void* data, size_t n) {
+        const char* p = static_cast<const char*>(data);
+        while (n > 0) {
+            if (m_used + n <= m_bufferSize) {
+                std::memcpy(GetBuffer() + m_used, p, n);
+                m_used += n;
+                return;
+            }
+            if (m_used > 0) {
+                Commit(m_used, 0);
+                m_used = 0;
+                continue;
+            }
+            // 单条数据比整个缓冲块还大：按块切开
+            std::memcpy(GetBuffer(), p, m_bufferSize);
+            Commit(m_bufferSize, 0);
+            p += m_bufferSize;
+            n -= m_bufferSize;
+        }
+    }
+
+    // 当前正在填充的缓冲块
+    char* GetBuffer() { return m_buffers[Slot(m_submitted.load(std::memory_order_relaxed))].data(); }
+    size_t GetBufferSize() const { return m_bufferSize; }
+
+    // 把当前块的前 length 字节交给写盘线程，紧随其后的 carry 字节（未完成的记录/行）
+    // 搬到下一个块的开头；返回接下来要填充的块
+    char* Commit(size_t length, size_t carry) {
+        char* current = GetBuffer();
+        if (!m_options.async) {
+            WriteOut(current, length);
+            std::memmove(current, current + length, carry);
+            return current;
+        }
+        uint64_t submitted = m_submitted.load(std::memory_order_relaxed);
+        // 下一个块仍在等待写盘：环已满
+        if (submitted + 1 >= m_drained.load(std::memory_order_acquire) + m_buffers.size()) {
+            if (m_options.policy == UAV_BACKPRESSURE_DROP) {
+                m_bytesDropped += length;
+                std::memmove(current, current + length, carry);
+                return current;
+            }
+            auto start = std::chrono::steady_clock::now();
+            while (submitted + 1 >= m_drained.load(std::memory_order_acquire) + m_buffers.size()) {
+                m_wakeup.notify_one();
+                std::this_thread::yield();
+            }
+            m_stallNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        }
+        char* next = m_buffers[Slot(submitted + 1)].data();
+        std::memcpy(next, current + length, carry);
+        m_lengths[Slot(submitted)] = length;
+        m_submitted.store(submitted + 1, std::memory_order_release);
+        m_wakeup.notify_one();
+        return next;
+    }
+
+    // 仅供 GetBuffer/Commit 用法在关闭前登记当前块中尚未提交的字节数
+    void SetUsed(size_t used) { m_used = used; }
+
+    // 提交剩余数据，等待写盘线程写完并关闭文件
+    void Close() {
+        if (!m_file) {
+            return;
+        }
+        if (m_options.async) {
+            if (m_used > 0) {
+                uint64_t submitted = m_submitted.load(std::memory_order_relaxed);
+                m_lengths[Slot(submitted)] = m_used;
+                m_submitted.store(submitted + 1, std::memory_order_release);
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_wakeup.notify_one();
+            m_thread.join();
+        } else if (m_used > 0) {
+            WriteOut(GetBuffer(), m_used);
+        }
+        m_used = 0;
+        std::fclose(m_file);
+        m_file = nullptr;
+        m_buffers.clear();
+        m_buffers.shrink_to_fit();
+    }
+
+    // 以下统计在 Close 之后读取才是最终值
+    uint64_t GetBytesWritten() const { return m_bytesWritten; }
+    uint64_t GetBytesDropped() const { return m_bytesDropped; }
+    double GetStallSeconds() const { return m_stallNanoseconds * 1e-9; }
+    bool HasError() const { return m_ioError; }
+
+private:
+    size_t Slot(uint64_t index) const { return index % m_buffers.size(); }
+
+    void WriteOut(const char* data, size_t length) {
+        if (length > 0 && std::fwrite(data, 1, length, m_file) != length) {
+            m_ioError = true;
+        }
+        m_bytesWritten += length;
+    }
+
+    // 写盘线程：按顺序取出已提交的块写盘，没有数据时睡眠
+    // 生产者提交时不加锁地 notify，可能错过一次唤醒，由 wait_for 的超时兜底
+    void DrainLoop() {
+        uint64_t drained = 0;
+        for (;;) {
+            uint64_t submitted = m_submitted.load(std::memory_order_acquire);
+            if (drained < submitted) {
+                WriteOut(m_buffers[Slot(drained)].data(), m_lengths[Slot(drained)]);
+                m_drained.store(++drained, std::memory_order_release);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_stop && drained == m_submitted.load(std::memory_order_acquire)) {
+                break;
+            }
+            m_wakeup.wait_for(lock, std::chrono::milliseconds(2));
+        }
+        std::fflush(m_file);
+    }
+
+    UavAsyncOptions m_options;
+    size_t m_bufferSize = 0;
+    std::vector<std::vector<char>> m_buffers;
+    std::vector<size_t> m_lengths;
+    std::atomic<uint64_t> m_submitted{0};   // 已提交的块数（生产者写）
+    std::atomic<uint64_t> m_drained{0};     // 已写盘的块数（写盘线程写）
+    size_t m_used = 0;                       // 当前块已写字节数（Write 用法）
+
+    std::FILE* m_file = nullptr;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    bool m_stop = false;
+
+    uint64_t m_bytesWritten = 0;             // 同步模式下由调用线程写，异步模式下由写盘线程写
+    uint64_t m_bytesDropped = 0;
+    uint64_t m_stallNanoseconds = 0;
+    bool m_ioError = false;
+};
+
+// 以缓冲块为放置区的 streambuf：ostream 的格式化结果直接写进缓冲块，
+// 块满时只提交到最后一个换行为止，未完成的行搬到下一个块，
+// 因此写盘线程拿到的每个块都由完整的行组成，丢弃策略也只会丢整行。
+// sync（std::endl / std::flush）不触发写盘，数据在块满或 Close 时交出。
+class UavAsyncStreamBuf : public std::streambuf {
+public:
+    bool Open(const std::string& path, const UavAsyncOptions& options) {
+        if (!m_writer.Open(path, options)) {
+            return false;
+        }
+        setp(m_writer.GetBuffer(), m_writer.GetBuffer() + m_writer.GetBufferSize());
+        return true;
+    }
+
+    bool IsOpen() const { return m_writer.IsOpen(); }
+
+    void Close() {
+        if (m_writer.IsOpen()) {
+            m_committed += pptr() - pbase();
+            m_writer.SetUsed(pptr() - pbase());
+            m_writer.Close();
+            setp(nullptr, nullptr);
+        }
+    }
+
+    const UavAsyncFileWriter& GetWriter() const { return m_writer; }
+
+    // 已格式化进缓冲区的总字节数（调用线程可随时读取）
+    uint64_t GetBytesProduced() const { return m_committed + (pptr() - pbase()); }
+
+protected:
+    int_type overflow(int_type c) override {
+        if (!m_writer.IsOpen()) {
+            return traits_type::eof();
+        }
+        size_t used = pptr() - pbase();
+        size_t length = used;
+        while (length > 0 && pbase()[length - 1] != '\n') {
+            --length;
+        }
+        // 整块都没有换行（超长行）时只能整块提交
+        if (length == 0) {
+            length = used;
+        }
+        m_committed += length;
+        char* next = m_writer.Commit(length, used - length);
+        setp(next, next + m_writer.GetBufferSize());
+        pbump(static_cast<int>(used - length));
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override { return 0; }
+
+private:
+    UavAsyncFileWriter m_writer;
+    uint64_t m_committed = 0;
+};
+
+// 与 std::ofstream 用法相同的异步文本输出流
+class UavAsyncOfstream : public std::ostream {
+public:
+    UavAsyncOfstream() : std::ostream(nullptr) { rdbuf(&m_buf); }
+    ~UavAsyncOfstream() { close(); }
+
+    void open(const std::string& path, const UavAsyncOptions& options = UavAsyncOptions()) {
+        if (m_buf.Open(path, options)) {
+            clear();
+        } else {
+            setstate(std::ios::failbit);
+        }
+    }
+
+    bool is_open() const { return m_buf.IsOpen(); }
+
+    void close() { m_buf.Close(); }
+
+    const UavAsyncFileWriter& GetWriter() const { return m_buf.GetWriter(); }
+    uint64_t GetBytesProduced() const { return m_buf.GetBytesProduced(); }
+
+private:
+    UavAsyncStreamBuf m_buf;
+};
+
+#endif // UAV_ASYNC_WRITER_H
@@ -0,0 +1,185 @@
+#ifndef UAV_BINARY_TRACE_H
+#define UAV_BINARY_TRACE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "uav-async-writer.h"
+
+// 二进制传输事件记录格式（三个场景共用）
+// 文件 = 32 字节文件头 + 若干定长 48 字节记录，小端序。
+// 写入端把记录攒进缓冲块由后台线程写盘，回调中不做任何浮点格式化；
+// 需要文本时用 Tools 中的 convert 子命令还原为各场景原有的文本/CSV 格式。
+
+// 事件类型
+enum UavTraceEvent : uint16_t {
+    UAV_EVENT_MAC_TX = 0,        // First: MAC 层发送
+    UAV_EVENT_DATA = 1,          // Second: "DATA"
+    UAV_EVENT_ACK = 2,           // Second: "ACK"
+    UAV_EVENT_ACK_RECEIVED = 3,  // Second: "ACK_RECEIVED"
+    UAV_EVENT_TX_DATA = 4,       // Third: "Tx Data"
+    UAV_EVENT_TX_ACK = 5,        // Third: "Tx Ack"
+    UAV_EVENT_RX_DATA = 6,       // Third: "Rx Data"
+    UAV_EVENT_RX_ACK = 7,        // Third: "Rx Ack"
+    UAV_EVENT_COUNT
+};
+
+// 场景编号，决定转换回文本时使用的格式
+enum UavTraceScenario : uint32_t {
+    UAV_SCENARIO_GENERIC = 0,
+    UAV_SCENARIO_FIRST = 1,
+    UAV_SCENARIO_SECOND = 2,
+    UAV_SCENARIO_THIRD = 3
+};
+
+const uint32_t UAV_TRACE_NO_PEER = 0xffffffffu;
+const uint32_t UAV_TRACE_VERSION = 1;
+const char UAV_TRACE_MAGIC[8] = {'U', 'A', 'V', 'T', 'R', 'A', 'C', 'E'};
+
+struct UavTraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t scenario;
+    uint32_t reserved[3];
+};
+
+struct UavTraceRecord {
+    double time;      // 仿真时间（秒）
+    double x, y, z;   // 节点位置（米）
+    uint32_t node;    // 记录事件的节点
+    uint32_t peer;    // 对端节点，未知时为 UAV_TRACE_NO_PEER
+    uint16_t event;   // UavTraceEvent
+    uint16_t flags;   // 保留
+    uint32_t bytes;   // 负载字节数（未知为 0）
+};
+
+static_assert(sizeof(UavTraceFileHeader) == 32, "trace header must be 32 bytes");
+static_assert(sizeof(UavTraceRecord) == 48, "trace record must be 48 bytes");
+
+// 事件类型在原文本格式中的名称
+inline const char* UavTraceEventName(uint16_t event) {
+    static const char* const kNames[UAV_EVENT_COUNT] = {
+        "TX", "DATA", "ACK", "ACK_RECEIVED", "Tx Data", "Tx Ack", "Rx Data", "Rx Ack"};
+    return event < UAV_EVENT_COUNT ? kNames[event] : "UNKNOWN";
+}
+
+// 二进制记录写入器，记录经 UavAsyncFileWriter 的缓冲块环交给后台线程写盘
+class UavBinaryTraceWriter {
+public:
+    bool Open(const std::string& path, UavTraceScenario scenario,
+              const UavAsyncOptions& options = UavAsyncOptions()) {
+        if (!m_writer.Open(path, options)) {
+            return false;
+        }
+        UavTraceFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, UAV_TRACE_MAGIC, sizeof(header.magic));
+        header.version = UAV_TRACE_VERSION;
+        header.recordSize = sizeof(UavTraceRecord);
+        header.scenario = scenario;
+        m_writer.Write(&header, sizeof(header));
+        return true;
+    }
+
+    bool IsOpen() const { return m_writer.IsOpen(); }
+
+    void Write(const UavTraceRecord& record) {
+        m_writer.Write(&record, sizeof(record));
+    }
+
+    void Write(double time, uint32_t node, uint16_t event, uint32_t peer,
+               double x, double y, double z, uint32_t bytes = 0) {
+        UavTraceRecord r;
+        r.time = time;
+        r.x = x;
+        r.y = y;
+        r.z = z;
+        r.node = node;
+        r.peer = peer;
+        r.event = event;
+        r.flags = 0;
+        r.bytes = bytes;
+        Write(r);
+    }
+
+    void Close() { m_writer.Close(); }
+
+    // 关闭后为最终值
+    uint64_t GetBytesWritten() const { return m_writer.GetBytesWritten(); }
+    const UavAsyncFileWriter& GetWriter() const { return m_writer; }
+
+private:
+    UavAsyncFileWriter m_writer;
+};
+
+// 顺序读取二进制记录文件
+class UavBinaryTraceReader {
+public:
+    explicit UavBinaryTraceReader(size_t chunkRecords = 32768)
+        : m_chunkRecords(chunkRecords) {}
+
+    ~UavBinaryTraceReader() { Close(); }
+
+    // 打开并校验文件头，失败时 error 给出原因
+    bool Open(const std::string& path, std::string* error = nullptr) {
+        Close();
+        m_file = std::fopen(path.c_str(), "rb");
+        if (!m_file) {
+            if (error) *error = "cannot open " + path;
+            return false;
+        }
+        if (std::fread(&m_header, sizeof(m_header), 1, m_file) != 1 ||
+            std::memcmp(m_header.magic, UAV_TRACE_MAGIC, sizeof(m_header.magic)) != 0) {
+            if (error) *error = path + " is not a UAV binary trace";
+            Close();
+            return false;
+        }
+        if (m_header.version != UAV_TRACE_VERSION || m_header.recordSize != sizeof(UavTraceRecord)) {
+            if (error) *error = path + " has an unsupported trace version";
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    const UavTraceFileHeader& GetHeader() const { return m_header; }
+
+    bool Next(UavTraceRecord& record) {
+        if (m_pos == m_buffer.size()) {
+            if (!m_file) {
+                return false;
+            }
+            m_buffer.resize(m_chunkRecords);
+            size_t n = std::fread(m_buffer.data(), sizeof(UavTraceRecord), m_chunkRecords, m_file);
+            m_buffer.resize(n);
+            m_pos = 0;
+            if (n == 0) {
+                return false;
+            }
+        }
+        record = m_buffer[m_pos++];
+        return true;
+    }
+
+    void Close() {
+        if (m_file) {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+        m_buffer.clear();
+        m_pos = 0;
+    }
+
+private:
+    size_t m_chunkRecords;
+    std::FILE* m_file = nullptr;
+    UavTraceFileHeader m_header;
+    std::vector<UavTraceRecord> m_buffer;
+    size_t m_pos = 0;
+};
+
+#endif // UAV_BINARY_TRACE_H
@@ -0,0 +1,410 @@
+#ifndef UAV_BURST_TRAFFIC_H
+#define UAV_BURST_TRAFFIC_H
+
+#include "ns3/application.h"
+#include "ns3/application-container.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/traced-callback.h"
+#include "ns3/type-id.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// 随机节点对突发流量（Third 的 --traffic=burst）
+// 原做法每次突发在发送节点上新装一个 TCP OnOffApplication，0.02 秒后停止：每次都要新建应用和 socket、
+// 走一遍三次握手和 FIN，停掉的应用一直留到仿真结束。这里改为：
+//   UavBurstSchedule  预先生成全部突发（时刻、收发节点、字节数），按发送节点分组，每条 16 字节；
+//   UavBurstApp       每节点一个，按计划逐个调度突发，同一时刻只有一个待执行事件。
+//                     TCP 下每个接收节点一条长连接，放在最多 MaxConnections 条的连接池中复用，
+//                     池满时关闭最久未用的连接；UDP 下只用一个 socket。
+// 建立连接和应用的开销只与节点数、连接池大小有关，与突发次数和仿真时长无关。
+
+namespace ns3 {
+
+struct UavBurst {
+    double time;
+    uint32_t receiver;
+    uint32_t bytes;
+};
+
+static_assert(sizeof(UavBurst) == 16, "burst entry must be 16 bytes");
+
+class UavBurstSchedule {
+public:
+    struct Options {
+        double start = 0.0;
+        double stop = 100.0;
+        double rate = 1.0;            // 每秒的抽签次数
+        double probability = 0.5;     // 每次抽签产生一次突发的概率
+        uint32_t minBytes = 25000;    // 突发字节数（默认取原 OnOff 会话的 10 Mbps × 0.02 秒），在 [minBytes, maxBytes] 内均匀抽取，
+        uint32_t maxBytes = 0;        // maxBytes 不大于 minBytes 时固定为 minBytes
+    };
+
+    // 在 [start, stop) 内每 1/rate 秒抽签一次；收发节点的抽取方式与原 OnOff 做法相同
+    void Generate(uint32_t numNodes, const Options& options, Ptr<UniformRandomVariable> rand) {
+        std::vector<uint32_t> senders;
+        std::vector<UavBurst> bursts;
+        m_numNodes = numNodes;
+        if (numNodes >= 2 && options.rate > 0.0) {
+            for (uint64_t k = 0;; ++k) {
+                double t = options.start + k / options.rate;
+                if (t >= options.stop) {
+                    break;
+                }
+                if (rand->GetValue() >= options.probability) {
+                    continue;
+                }
+                uint32_t sender = rand->GetInteger(0, numNodes - 1);
+                uint32_t receiver = rand->GetInteger(0, numNodes - 1);
+                while (receiver == sender) {
+                    receiver = rand->GetInteger(0, numNodes - 1);
+                }
+                uint32_t bytes = options.minBytes;
+                if (options.maxBytes > options.minBytes) {
+                    bytes = rand->GetInteger(options.minBytes, options.maxBytes);
+                }
+                senders.push_back(sender);
+                bursts.push_back(UavBurst{t, receiver, bytes});
+            }
+        }
+        // 按发送节点稳定分桶，桶内保持时间顺序
+        m_offsets.assign(numNodes + 1, 0);
+        for (uint32_t s : senders) {
+            ++m_offsets[s + 1];
+        }
+        for (uint32_t i = 0; i < numNodes; ++i) {
+            m_offsets[i + 1] += m_offsets[i];
+        }
+        m_bursts.resize(bursts.size());
+        std::vector<uint32_t> fill(m_offsets.begin(), m_offsets.end() - 1);
+        for (size_t k = 0; k < bursts.size(); ++k) {
+            m_bursts[fill[senders[k]]++] = bursts[k];
+        }
+    }
+
+    uint32_t GetNumNodes() const { return m_numNodes; }
+    size_t GetNumBursts() const { return m_bursts.size(); }
+
+    // 发送节点 sender 的突发，按时间升序
+    const UavBurst* Begin(uint32_t sender) const { return m_bursts.data() + m_offsets[sender]; }
+    const UavBurst* End(uint32_t sender) const { return m_bursts.data() + m_offsets[sender + 1]; }
+
+private:
+    uint32_t m_numNodes = 0;
+    std::vector<uint32_t> m_offsets;
+    std::vector<UavBurst> m_bursts;
+};
+
+class UavBurstApp : public Application {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::UavBurstApp")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<UavBurstApp>()
+            .AddAttribute("Protocol", "Socket factory: ns3::TcpSocketFactory or ns3::UdpSocketFactory",
+                          TypeIdValue(TcpSocketFactory::GetTypeId()),
+                          MakeTypeIdAccessor(&UavBurstApp::m_tid),
+                          MakeTypeIdChecker())
+            .AddAttribute("RemotePort", "Destination port of the sinks",
+                          UintegerValue(9999),
+                          MakeUintegerAccessor(&UavBurstApp::m_peerPort),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("PacketSize", "Largest single write to the socket",
+                          UintegerValue(512),
+                          MakeUintegerAccessor(&UavBurstApp::m_packetSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxConnections", "TCP connections kept open at the same time",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&UavBurstApp::m_maxConnections),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddTraceSource("Tx", "A packet was accepted by the socket (TCP Send or UDP SendTo succeeded)",
+                            MakeTraceSourceAccessor(&UavBurstApp::m_txTrace),
+                            "ns3::Packet::TracedCallback");
+        return tid;
+    }
+
+    // schedule 与 peers（节点号 → 地址）由所有节点的应用共享
+    void SetSchedule(std::shared_ptr<const UavBurstSchedule> schedule, uint32_t sender,
+                     std::shared_ptr<const std::vector<Ipv4Address>> peers) {
+        m_schedule = schedule;
+        m_sender = sender;
+        m_peers = peers;
+    }
+
+    uint64_t GetBurstsSent() const { return m_bursts; }
+    uint64_t GetBytesSent() const { return m_bytesSent; }
+    uint64_t GetBytesDropped() const { return m_bytesDropped; }
+    uint64_t GetConnectionsOpened() const { return m_opened; }
+
+protected:
+    void DoDispose() override {
+        m_pool.clear();
+        m_udpSocket = nullptr;
+        m_schedule.reset();
+        m_peers.reset();
+        Application::DoDispose();
+    }
+
+private:
+    // 连接池中的一条 TCP 连接；pending 为已排入、尚未写进 socket 的字节数
+    struct Connection {
+        uint32_t receiver;
+        Ptr<Socket> socket;
+        bool connected;
+        uint64_t pending;
+        double lastUse;
+    };
+
+    bool IsTcp() const { return m_tid == TcpSocketFactory::GetTypeId(); }
+
+    void StartApplication() override {
+        if (!m_schedule || m_sender >= m_schedule->GetNumNodes()) {
+            return;
+        }
+        m_next = m_schedule->Begin(m_sender);
+        m_end = m_schedule->End(m_sender);
+        double now = Simulator::Now().GetSeconds();
+        while (m_next != m_end && m_next->time < now) {
+            ++m_next;  // 启动前的突发不补发
+        }
+        ScheduleNext();
+    }
+
+    void StopApplication() override {
+        Simulator::Cancel(m_event);
+        for (Connection& c : m_pool) {
+            CloseConnection(c);
+        }
+        m_pool.clear();
+        if (m_udpSocket) {
+            m_udpSocket->Close();
+            m_udpSocket = nullptr;
+        }
+    }
+
+    void ScheduleNext() {
+        if (m_next == m_end) {
+            return;
+        }
+        m_event = Simulator::Schedule(Seconds(m_next->time) - Simulator::Now(), &UavBurstApp::SendBurst, this);
+    }
+
+    void SendBurst() {
+        const UavBurst& burst = *m_next++;
+        ++m_bursts;
+        if (IsTcp()) {
+            Connection* c = GetConnection(burst.receiver);
+            if (c) {
+                c->pending += burst.bytes;
+                c->lastUse = Simulator::Now().GetSeconds();
+                Flush(c->socket);
+            } else {
+                m_bytesDropped += burst.bytes;
+            }
+        } else {
+            SendDatagrams(burst.receiver, burst.bytes);
+        }
+        ScheduleNext();
+    }
+
+    void SendDatagrams(uint32_t receiver, uint32_t bytes) {
+        if (!m_udpSocket) {
+            m_udpSocket = Socket::CreateSocket(GetNode(), m_tid);
+            m_udpSocket->Bind();
+        }
+        InetSocketAddress to((*m_peers)[receiver], m_peerPort);
+        while (bytes > 0) {
+            uint32_t n = std::min(bytes, m_packetSize);
+            Ptr<Packet> p = Create<Packet>(n);
+            // 与 TCP 一样只在交给 socket 成功后触发 Tx
+            if (m_udpSocket->SendTo(p, 0, to) >= 0) {
+                m_txTrace(p);
+                m_bytesSent += n;
+            } else {
+                m_bytesDropped += n;
+            }
+            bytes -= n;
+        }
+    }
+
+    // 取到 receiver 的连接，没有时新建；池满时关闭最久未用的一条（优先选没有待发数据的）。
+    // 建连立即失败时返回 nullptr
+    Connection* GetConnection(uint32_t receiver) {
+        if (Connection* c = FindReceiver(receiver)) {
+            return c;
+        }
+        if (m_pool.size() >= m_maxConnections) {
+            auto victim = m_pool.begin();
+            for (auto it = m_pool.begin(); it != m_pool.end(); ++it) {
+                bool idle = it->pending == 0;
+                bool victimIdle = victim->pending == 0;
+                if ((idle && !victimIdle) || (idle == victimIdle && it->lastUse < victim->lastUse)) {
+                    victim = it;
+                }
+            }
+            CloseConnection(*victim);
+            *victim = m_pool.back();
+            m_pool.pop_back();
+        }
+        Ptr<Socket> socket = Socket::CreateSocket(GetNode(), m_tid);
+        socket->Bind();
+        socket->SetConnectCallback(MakeCallback(&UavBurstApp::ConnectionSucceeded, this),
+                                   MakeCallback(&UavBurstApp::ConnectionFailed, this));
+        socket->SetSendCallback(MakeCallback(&UavBurstApp::SendSpace, this));
+        socket->SetCloseCallbacks(MakeCallback(&UavBurstApp::ConnectionClosed, this),
+                                  MakeCallback(&UavBurstApp::ConnectionClosed, this));
+        // 先入池再建连，建连过程中的回调能找到这条连接
+        m_pool.push_back(Connection{receiver, socket, false, 0, Simulator::Now().GetSeconds()});
+        ++m_opened;
+        socket->Connect(InetSocketAddress((*m_peers)[receiver], m_peerPort));
+        return FindReceiver(receiver);
+    }
+
+    // 在发送缓冲允许的范围内把待发数据写进 socket，其余等 SendSpace 回调。
+    // Send 可能同步触发关闭回调而改动连接池，每轮重新查找
+    void Flush(Ptr<Socket> socket) {
+        while (true) {
+            Connection* c = Find(socket);
+            if (!c || !c->connected || c->pending == 0) {
+                return;
+            }
+            uint32_t space = socket->GetTxAvailable();
+            if (space == 0) {
+                return;
+            }
+            uint32_t n = static_cast<uint32_t>(std::min<uint64_t>(c->pending, std::min(m_packetSize, space)));
+            Ptr<Packet> p = Create<Packet>(n);
+            int sent = socket->Send(p);
+            if (sent <= 0) {
+                return;
+            }
+            m_txTrace(p);
+            m_bytesSent += sent;
+            if ((c = Find(socket))) {
+                c->pending -= sent;
+            }
+        }
+    }
+
+    void CloseConnection(Connection& c) {
+        m_bytesDropped += c.pending;
+        c.pending = 0;
+        c.socket->SetConnectCallback(MakeNullCallback<void, Ptr<Socket>>(), MakeNullCallback<void, Ptr<Socket>>());
+        c.socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+        c.socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket>>(), MakeNullCallback<void, Ptr<Socket>>());
+        c.socket->Close();
+    }
+
+    Connection* FindReceiver(uint32_t receiver) {
+        for (Connection& c : m_pool) {
+            if (c.receiver == receiver) {
+                return &c;
+            }
+        }
+        return nullptr;
+    }
+
+    Connection* Find(Ptr<Socket> socket) {
+        for (Connection& c : m_pool) {
+            if (c.socket == socket) {
+                return &c;
+            }
+        }
+        return nullptr;
+    }
+
+    void ConnectionSucceeded(Ptr<Socket> socket) {
+        if (Connection* c = Find(socket)) {
+            c->connected = true;
+            Flush(socket);
+        }
+    }
+
+    void SendSpace(Ptr<Socket> socket, uint32_t) {
+        Flush(socket);
+    }
+
+    // 连接失败或被关闭：丢弃待发数据，下一次突发重新建连
+    void ConnectionFailed(Ptr<Socket> socket) { Remove(socket); }
+    void ConnectionClosed(Ptr<Socket> socket) { Remove(socket); }
+
+    void Remove(Ptr<Socket> socket) {
+        for (size_t k = 0; k < m_pool.size(); ++k) {
+            if (m_pool[k].socket == socket) {
+                m_bytesDropped += m_pool[k].pending;
+                m_pool[k] = m_pool.back();
+                m_pool.pop_back();
+                return;
+            }
+        }
+    }
+
+    TypeId m_tid;
+    uint16_t m_peerPort = 9999;
+    uint32_t m_packetSize = 512;
+    uint32_t m_maxConnections = 8;
+
+    std::shared_ptr<const UavBurstSchedule> m_schedule;
+    std::shared_ptr<const std::vector<Ipv4Address>> m_peers;
+    uint32_t m_sender = 0;
+    const UavBurst* m_next = nullptr;
+    const UavBurst* m_end = nullptr;
+    EventId m_event;
+
+    std::vector<Connection> m_pool;
+    Ptr<Socket> m_udpSocket;
+
+    uint64_t m_bursts = 0;
+    uint64_t m_bytesSent = 0;
+    uint64_t m_bytesDropped = 0;
+    uint64_t m_opened = 0;
+
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(UavBurstApp);
+
+// 生成计划并为每个节点安装一个 UavBurstApp；节点 k 的地址取 interfaces 的第 k 个
+inline ApplicationContainer UavInstallBurstTraffic(const NodeContainer& nodes, const Ipv4InterfaceContainer& interfaces,
+                                                   const UavBurstSchedule::Options& options,
+                                                   Ptr<UniformRandomVariable> rand, TypeId protocol,
+                                                   uint16_t port, uint32_t maxConnections) {
+    auto schedule = std::make_shared<UavBurstSchedule>();
+    schedule->Generate(nodes.GetN(), options, rand);
+    auto peers = std::make_shared<std::vector<Ipv4Address>>();
+    for (uint32_t k = 0; k < interfaces.GetN(); ++k) {
+        peers->push_back(interfaces.GetAddress(k));
+    }
+    ApplicationContainer apps;
+    for (uint32_t k = 0; k < nodes.GetN(); ++k) {
+        Ptr<UavBurstApp> app = CreateObject<UavBurstApp>();
+        app->SetAttribute("Protocol", TypeIdValue(protocol));
+        app->SetAttribute("RemotePort", UintegerValue(port));
+        app->SetAttribute("MaxConnections", UintegerValue(maxConnections));
+        app->SetSchedule(schedule, k, peers);
+        nodes.Get(k)->AddApplication(app);
+        // 起止时间相对当前时刻；仿真开始后（如分副本时）追加安装也按绝对时间生效
+        app->SetStartTime(Seconds(options.start) - Simulator::Now());
+        app->SetStopTime(Seconds(options.stop) - Simulator::Now());
+        apps.Add(app);
+    }
+    return apps;
+}
+
+} // namespace ns3
+
+#endif // UAV_BURST_TRAFFIC_H
@@ -0,0 +1,107 @@
+#ifndef UAV_FLOW_STATS_H
+#define UAV_FLOW_STATS_H
+
+#include "ns3/event-id.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+#include "uav-async-writer.h"
+
+#include <iomanip>
+#include <set>
+#include <string>
+
+// 按区间流式输出 FlowMonitor 统计（--flowStats=stream）
+// 每隔 interval 秒先 CheckForLostPackets，把本区间有活动的流的增量写成一行 CSV，
+// 然后 ResetAllStats 清零计数器和直方图。内存只与流的数量有关，
+// 仿真运行中即可用 tail 跟踪结果，不再在结束时一次性写出完整的 XML。
+//   flow-stats.csv  start,end,flow,tx_packets,rx_packets,tx_bytes,rx_bytes,delay_sum,jitter_sum,lost_packets
+//   flow-index.csv  flow,source,destination,source_port,destination_port,protocol（流首次出现时追加）
+// 时间与时延单位均为秒。
+
+namespace ns3 {
+
+class UavFlowStatsExporter {
+public:
+    // 在 FlowMonitorHelper::InstallAll 之后、Simulator::Run 之前调用
+    bool Start(Ptr<FlowMonitor> monitor, Ptr<Ipv4FlowClassifier> classifier, const std::string& outputDir,
+               Time interval, const UavAsyncOptions& options = UavAsyncOptions()) {
+        m_monitor = monitor;
+        m_classifier = classifier;
+        m_interval = interval;
+        m_start = 0.0;
+        m_known.clear();
+        m_stats.open(outputDir + "/flow-stats.csv", options);
+        m_index.open(outputDir + "/flow-index.csv", options);
+        if (!m_stats.is_open() || !m_index.is_open()) {
+            return false;
+        }
+        m_stats << "start,end,flow,tx_packets,rx_packets,tx_bytes,rx_bytes,delay_sum,jitter_sum,lost_packets\n";
+        m_index << "flow,source,destination,source_port,destination_port,protocol\n";
+        m_event = Simulator::Schedule(m_interval, &UavFlowStatsExporter::Tick, this);
+        return true;
+    }
+
+    // Simulator::Run 返回后调用：输出最后一个（可能不完整的）区间并关闭文件
+    void Finish() {
+        if (!m_monitor) {
+            return;
+        }
+        Simulator::Cancel(m_event);
+        Emit(Simulator::Now().GetSeconds());
+        m_stats.close();
+        m_index.close();
+        m_monitor = nullptr;
+        m_classifier = nullptr;
+    }
+
+    uint64_t GetRowsWritten() const { return m_rows; }
+
+private:
+    void Tick() {
+        Emit(Simulator::Now().GetSeconds());
+        m_event = Simulator::Schedule(m_interval, &UavFlowStatsExporter::Tick, this);
+    }
+
+    void Emit(double end) {
+        if (end <= m_start) {
+            return;
+        }
+        m_monitor->CheckForLostPackets();
+        for (const auto& entry : m_monitor->GetFlowStats()) {
+            const FlowMonitor::FlowStats& s = entry.second;
+            if (s.txPackets == 0 && s.rxPackets == 0 && s.lostPackets == 0) {
+                continue;  // 本区间无活动
+            }
+            if (m_known.insert(entry.first).second) {
+                Ipv4FlowClassifier::FiveTuple t = m_classifier->FindFlow(entry.first);
+                m_index << entry.first << "," << t.sourceAddress << "," << t.destinationAddress << ","
+                        << t.sourcePort << "," << t.destinationPort << "," << uint32_t(t.protocol) << "\n";
+            }
+            m_stats << std::fixed << std::setprecision(3) << m_start << "," << end << ","
+                    << entry.first << "," << s.txPackets << "," << s.rxPackets << ","
+                    << s.txBytes << "," << s.rxBytes << "," << std::setprecision(9)
+                    << s.delaySum.GetSeconds() << "," << s.jitterSum.GetSeconds() << ","
+                    << s.lostPackets << "\n";
+            ++m_rows;
+        }
+        m_monitor->ResetAllStats();
+        m_start = end;
+    }
+
+    Ptr<FlowMonitor> m_monitor;
+    Ptr<Ipv4FlowClassifier> m_classifier;
+    Time m_interval;
+    double m_start = 0.0;            // 当前区间起点
+    std::set<FlowId> m_known;        // 已写入 flow-index.csv 的流
+    UavAsyncOfstream m_stats;
+    UavAsyncOfstream m_index;
+    EventId m_event;
+    uint64_t m_rows = 0;
+};
+
+} // namespace ns3
+
+#endif // UAV_FLOW_STATS_H
@@ -0,0 +1,123 @@
+#ifndef UAV_FORK_REPLICAS_H
+#define UAV_FORK_REPLICAS_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// 从同一个预热状态 fork 出多个副本（--replicas）
+// 预热跑完后由调用方关闭所有输出、确认只剩主线程，再调用 Run：
+// 父进程依次 fork，同时运行的子进程不超过 jobs 个，子进程与父进程写时复制共享预热后的全部仿真状态；
+// 子进程从 Run 直接返回自己的编号，继续仿真；父进程回收全部子进程后返回 0，
+// 退出状态、墙钟时间和资源占用见 GetResults / WriteCsv。
+
+struct UavReplicaResult {
+    uint32_t index;           // 副本编号 1..N
+    pid_t pid;                // fork 失败时为 -1
+    int status;               // waitpid 的状态
+    double wallSeconds;       // fork 到回收的墙钟时间
+    double userSeconds;
+    double systemSeconds;
+    long maxRssKb;
+    bool reaped;              // 已回收；未回收的副本算作失败
+
+    bool Succeeded() const { return reaped && WIFEXITED(status) && WEXITSTATUS(status) == 0; }
+};
+
+class UavForkReplicas {
+public:
+    // jobs 为 0 时取 CPU 数；返回值：子进程中为其编号，父进程中为 0
+    uint32_t Run(uint32_t count, uint32_t jobs) {
+        if (jobs == 0) {
+            jobs = std::max(1u, std::thread::hardware_concurrency());
+        }
+        m_results.assign(count, UavReplicaResult{0, -1, 0, 0.0, 0.0, 0.0, 0, false});
+        std::vector<double> started(count, 0.0);
+        uint32_t next = 0, running = 0;
+        while (next < count || running > 0) {
+            if (next < count && running < jobs) {
+                UavReplicaResult& r = m_results[next];
+                r.index = next + 1;
+                started[next] = Now();
+                pid_t pid = fork();
+                if (pid == 0) {
+                    return r.index;
+                }
+                r.pid = pid;
+                ++next;
+                if (pid > 0) {
+                    ++running;
+                }
+                continue;
+            }
+            int status = 0;
+            struct rusage usage;
+            pid_t pid = wait4(-1, &status, 0, &usage);
+            if (pid < 0) {
+                if (errno == EINTR) {
+                    continue;   // 被信号打断，继续等
+                }
+                break;          // ECHILD：没有可回收的子进程（不应发生）
+            }
+            for (uint32_t k = 0; k < next; ++k) {
+                UavReplicaResult& r = m_results[k];
+                if (r.pid == pid) {
+                    r.status = status;
+                    r.wallSeconds = Now() - started[k];
+                    r.userSeconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6;
+                    r.systemSeconds = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+                    r.maxRssKb = usage.ru_maxrss;
+                    r.reaped = true;
+                    --running;
+                    break;
+                }
+            }
+        }
+        return 0;
+    }
+
+    const std::vector<UavReplicaResult>& GetResults() const { return m_results; }
+
+    uint32_t GetFailures() const {
+        uint32_t failures = 0;
+        for (const UavReplicaResult& r : m_results) {
+            failures += !r.Succeeded();
+        }
+        return failures;
+    }
+
+    // 每个副本一行：编号、pid、退出码（被信号终止或未回收时为 -1）、信号、墙钟 / 用户 / 系统时间、峰值内存
+    bool WriteCsv(const std::string& path) const {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            return false;
+        }
+        std::fprintf(file, "replica,pid,exit,signal,wall_seconds,user_seconds,system_seconds,max_rss_kb\n");
+        for (const UavReplicaResult& r : m_results) {
+            int code = r.reaped && WIFEXITED(r.status) ? WEXITSTATUS(r.status) : -1;
+            int signal = r.reaped && WIFSIGNALED(r.status) ? WTERMSIG(r.status) : 0;
+            std::fprintf(file, "%u,%d,%d,%d,%.6f,%.6f,%.6f,%ld\n", r.index, static_cast<int>(r.pid), code, signal,
+                         r.wallSeconds, r.userSeconds, r.systemSeconds, r.maxRssKb);
+        }
+        return std::fclose(file) == 0;
+    }
+
+private:
+    static double Now() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::vector<UavReplicaResult> m_results;
+};
+
+#endif // UAV_FORK_REPLICAS_H
@@ -0,0 +1,126 @@
+#ifndef UAV_GRAPH_EXPORT_H
+#define UAV_GRAPH_EXPORT_H
+
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/system-path.h"
+#include "ns3/vector.h"
+
+#include "uav-graph-tensors.h"
+#include "uav-link-kernel.h"
+#include "uav-window-links.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+// 窗口图张量导出（--graphTensors，格式见 uav-graph-tensors.h）
+// 在窗口推断（uav-window-links.h）关闭每个窗口时写出一张图：
+//   - 边：窗口内的包数、字节数，以及窗口关闭时两端的距离和按链路预算算出的接收功率；
+//   - 点：窗口关闭时的位置和速度，窗口内记录到的收发包数。
+// 每节点收发计数与链路推断一样按 stride 分 pane 存放在环形缓冲里，窗口关闭时合并。
+// 接收功率是路径损耗模型给出的期望值，不含衰落，与 --linkModel=power 的判定一致。
+
+namespace ns3 {
+
+class UavGraphExporter {
+public:
+    // 在 MobilityHelper::Install 之后调用；window、stride 与 UavWindowLinkInference 相同
+    bool Open(const std::string& dir, const NodeContainer& nodes, double window, double stride,
+              uint32_t windowsPerChunk, const UavLinkBudget& budget) {
+        SystemPath::MakeDirectories(dir);
+        if (!m_writer.Open(dir, nodes.GetN(), windowsPerChunk, window, stride)) {
+            return false;
+        }
+        m_models.clear();
+        for (uint32_t k = 0; k < nodes.GetN(); ++k) {
+            m_models.push_back(nodes.Get(k)->GetObject<MobilityModel>());
+        }
+        m_kernel.Configure(budget);
+        m_stride = stride;
+        m_panes.assign(static_cast<size_t>(std::round(window / stride)), Pane());
+        for (Pane& pane : m_panes) {
+            pane.counts.assign(2 * nodes.GetN(), 0);
+        }
+        m_positions.resize(nodes.GetN());
+        m_nodes.resize(nodes.GetN() * UAV_GRAPH_NODE_DIM);
+        return true;
+    }
+
+    bool IsOpen() const { return m_writer.IsOpen(); }
+
+    // 记录一次收发；调用前窗口推断需已推进到 time（关闭了更早的窗口）
+    void CountPacket(double time, uint32_t nodeId, bool isTx) {
+        int64_t id = static_cast<int64_t>(std::floor(time / m_stride));
+        Pane& pane = m_panes[id % m_panes.size()];
+        if (pane.id != id) {
+            // 环形缓冲中的旧 pane 已不属于任何未关闭的窗口
+            std::fill(pane.counts.begin(), pane.counts.end(), 0);
+            pane.id = id;
+        }
+        ++pane.counts[2 * nodeId + (isTx ? 0 : 1)];
+    }
+
+    // 在窗口推断的回调中调用
+    void Write(const UavLinkWindow& window) {
+        uint32_t n = m_models.size();
+        for (uint32_t k = 0; k < n; ++k) {
+            Vector p = m_models[k]->GetPosition();
+            Vector v = m_models[k]->GetVelocity();
+            m_positions[k] = p;
+            float* row = &m_nodes[k * UAV_GRAPH_NODE_DIM];
+            row[0] = p.x; row[1] = p.y; row[2] = p.z;
+            row[3] = v.x; row[4] = v.y; row[5] = v.z;
+            row[6] = 0.0f; row[7] = 0.0f;
+        }
+        // 窗口 k 覆盖的 pane 为 [k, k + 窗口 pane 数)
+        int64_t first = static_cast<int64_t>(window.index);
+        for (const Pane& pane : m_panes) {
+            if (pane.id < first || pane.id >= first + static_cast<int64_t>(m_panes.size())) {
+                continue;
+            }
+            for (uint32_t k = 0; k < n; ++k) {
+                m_nodes[k * UAV_GRAPH_NODE_DIM + 6] += pane.counts[2 * k];
+                m_nodes[k * UAV_GRAPH_NODE_DIM + 7] += pane.counts[2 * k + 1];
+            }
+        }
+        m_edges.resize(window.edges.size());
+        for (size_t k = 0; k < window.edges.size(); ++k) {
+            const UavWindowEdge& e = window.edges[k];
+            Vector d = m_positions[e.i] - m_positions[e.j];
+            double d2 = d.x * d.x + d.y * d.y + d.z * d.z;
+            m_edges[k] = UavGraphTensorWriter::Edge{e.i, e.j, {static_cast<float>(e.packets), static_cast<float>(e.bytes),
+                                                               m_kernel.Rssi(d2), static_cast<float>(std::sqrt(d2))}};
+        }
+        m_writer.Write(window.start, window.end, m_edges, m_nodes.data());
+    }
+
+    // 写出索引并关闭；返回导出过程中是否有写入错误
+    bool Close() {
+        m_models.clear();
+        return m_writer.Close();
+    }
+
+    uint64_t GetWindows() const { return m_writer.GetWindows(); }
+    uint64_t GetEdges() const { return m_writer.GetEdges(); }
+
+private:
+    struct Pane {
+        int64_t id = -1;                 // pane 编号 floor(time / stride)
+        std::vector<uint32_t> counts;    // 每节点 [tx, rx]
+    };
+
+    UavGraphTensorWriter m_writer;
+    UavLinkKernel m_kernel;
+    std::vector<Ptr<MobilityModel>> m_models;
+    double m_stride = 1.0;
+    std::vector<Pane> m_panes;
+    std::vector<Vector> m_positions;    // 本窗口的节点位置（双精度，用于算距离）
+    std::vector<float> m_nodes;
+    std::vector<UavGraphTensorWriter::Edge> m_edges;
+};
+
+} // namespace ns3
+
+#endif // UAV_GRAPH_EXPORT_H
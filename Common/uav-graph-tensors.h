@@ -0,0 +1,270 @@
+#ifndef UAV_GRAPH_TENSORS_H
+#define UAV_GRAPH_TENSORS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 按时间窗口导出的图张量（GNN 训练数据）
+// 每个窗口是一张图：活动链路为边，全部节点为点。窗口按块（chunk）存放，
+// 每块是一组 NPY v1.0 文件，数据区紧接 128 字节的文件头，可直接 np.load(..., mmap_mode='r')：
+//   chunk-XXXXX.edge_index.npy   int32   (E, 2)     两端节点 i < j，无向边只存一次，PyG 用 .T
+//   chunk-XXXXX.edge_attr.npy    float32 (E, 4)     UAV_GRAPH_EDGE_FEATURES
+//   chunk-XXXXX.edge_ptr.npy     int64   (W + 1,)   第 w 个窗口的边为 [ptr[w], ptr[w+1])
+//   chunk-XXXXX.node_attr.npy    float32 (W, N, 8)  UAV_GRAPH_NODE_FEATURES
+//   chunk-XXXXX.window_time.npy  float64 (W, 2)     窗口起止时间
+// index.json 记录特征名和每块的窗口范围、边数、时间范围，数据加载器据此定位窗口。
+// 数组边写边追加，行数在块关闭时回填到文件头；写到一半的块形状为 0，不会被误读。
+
+const uint32_t UAV_GRAPH_TENSOR_VERSION = 1;
+const uint32_t UAV_GRAPH_EDGE_DIM = 4;
+const uint32_t UAV_GRAPH_NODE_DIM = 8;
+const char* const UAV_GRAPH_EDGE_FEATURES[UAV_GRAPH_EDGE_DIM] = {"packets", "bytes", "rssi_dbm", "distance_m"};
+const char* const UAV_GRAPH_NODE_FEATURES[UAV_GRAPH_NODE_DIM] = {"x", "y", "z", "vx", "vy", "vz",
+                                                                 "tx_packets", "rx_packets"};
+
+// 单个 NPY 数组文件：第一维随追加增长，其余维固定
+class UavNpyWriter {
+public:
+    static const size_t HEADER_SIZE = 128;   // 魔数 + 版本 + 长度 + 头部字典，64 字节对齐
+
+    ~UavNpyWriter() { Close(); }
+
+    // descr 为不带字节序的类型码（"i4"、"f4"、"i8"、"f8"），shape 为第一维之外的各维
+    bool Open(const std::string& path, const char* descr, const std::vector<uint64_t>& shape) {
+        Close();
+        m_file = std::fopen(path.c_str(), "wb");
+        if (!m_file) {
+            return false;
+        }
+        m_descr = descr;
+        m_shape = shape;
+        m_rows = 0;
+        return WriteHeader();
+    }
+
+    bool IsOpen() const { return m_file != nullptr; }
+
+    // 追加 rows 行，data 为连续存放的 rows × 行元素
+    template <typename T>
+    bool Append(const T* data, uint64_t rows) {
+        uint64_t count = rows * RowElements();
+        if (!m_file || std::fwrite(data, sizeof(T), count, m_file) != count) {
+            return false;
+        }
+        m_rows += rows;
+        return true;
+    }
+
+    uint64_t GetRows() const { return m_rows; }
+
+    // 回填行数并关闭
+    bool Close() {
+        if (!m_file) {
+            return true;
+        }
+        bool ok = std::fseek(m_file, 0, SEEK_SET) == 0 && WriteHeader();
+        ok = std::fclose(m_file) == 0 && ok;
+        m_file = nullptr;
+        return ok;
+    }
+
+private:
+    uint64_t RowElements() const {
+        uint64_t n = 1;
+        for (uint64_t d : m_shape) {
+            n *= d;
+        }
+        return n;
+    }
+
+    bool WriteHeader() {
+        std::ostringstream dict;
+        dict << "{'descr': '" << (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? '<' : '>') << m_descr
+             << "', 'fortran_order': False, 'shape': (" << m_rows << ",";
+        for (size_t k = 0; k < m_shape.size(); ++k) {
+            dict << (k ? ", " : " ") << m_shape[k];
+        }
+        dict << "), }";
+        std::string text = dict.str();
+        if (text.size() + 11 > HEADER_SIZE) {
+            return false;
+        }
+        text.resize(HEADER_SIZE - 11, ' ');
+        text += '\n';
+        char header[HEADER_SIZE];
+        std::memcpy(header, "\x93NUMPY\x01\x00", 8);
+        uint16_t length = static_cast<uint16_t>(text.size());
+        header[8] = static_cast<char>(length & 0xFF);
+        header[9] = static_cast<char>(length >> 8);
+        std::memcpy(header + 10, text.data(), text.size());
+        return std::fwrite(header, 1, HEADER_SIZE, m_file) == HEADER_SIZE;
+    }
+
+    std::FILE* m_file = nullptr;
+    std::string m_descr;
+    std::vector<uint64_t> m_shape;
+    uint64_t m_rows = 0;
+};
+
+class UavGraphTensorWriter {
+public:
+    struct Edge {
+        uint32_t i, j;
+        float attr[UAV_GRAPH_EDGE_DIM];
+    };
+
+    ~UavGraphTensorWriter() { Close(); }
+
+    // dir 需已存在；每 windowsPerChunk 个窗口换一个块
+    bool Open(const std::string& dir, uint32_t numNodes, uint32_t windowsPerChunk, double window, double stride) {
+        Close();
+        m_dir = dir;
+        m_numNodes = numNodes;
+        m_windowsPerChunk = std::max<uint32_t>(1, windowsPerChunk);
+        m_window = window;
+        m_stride = stride;
+        m_chunks.clear();
+        m_windows = 0;
+        m_edges = 0;
+        m_open = true;
+        m_ok = true;
+        return true;
+    }
+
+    bool IsOpen() const { return m_open; }
+
+    // 写出一个窗口：edges 为该窗口的边，nodes 为 numNodes × UAV_GRAPH_NODE_DIM 个节点特征
+    bool Write(double start, double end, const std::vector<Edge>& edges, const float* nodes) {
+        if (!m_open) {
+            return false;
+        }
+        if (m_chunks.empty() || m_chunks.back().windows == m_windowsPerChunk) {
+            m_ok = OpenChunk(start) && m_ok;
+        }
+        Chunk& chunk = m_chunks.back();
+        m_index.resize(edges.size() * 2);
+        m_attr.resize(edges.size() * UAV_GRAPH_EDGE_DIM);
+        for (size_t k = 0; k < edges.size(); ++k) {
+            m_index[2 * k] = static_cast<int32_t>(edges[k].i);
+            m_index[2 * k + 1] = static_cast<int32_t>(edges[k].j);
+            std::copy(edges[k].attr, edges[k].attr + UAV_GRAPH_EDGE_DIM, &m_attr[k * UAV_GRAPH_EDGE_DIM]);
+        }
+        chunk.edges += edges.size();
+        int64_t ptr = static_cast<int64_t>(chunk.edges);
+        double time[2] = {start, end};
+        m_ok = m_edgeIndex.Append(m_index.data(), edges.size()) && m_edgeAttr.Append(m_attr.data(), edges.size()) &&
+               m_edgePtr.Append(&ptr, 1) && m_nodeAttr.Append(nodes, 1) && m_windowTime.Append(time, 1) && m_ok;
+        ++chunk.windows;
+        chunk.end = end;
+        ++m_windows;
+        m_edges += edges.size();
+        return m_ok;
+    }
+
+    uint64_t GetWindows() const { return m_windows; }
+    uint64_t GetEdges() const { return m_edges; }
+
+    // 关闭最后一块并写出 index.json；返回整个导出过程是否无错
+    bool Close() {
+        if (!m_open) {
+            return m_ok;
+        }
+        m_ok = CloseChunk() && m_ok;
+        m_ok = WriteIndex() && m_ok;
+        m_open = false;
+        return m_ok;
+    }
+
+private:
+    struct Chunk {
+        std::string name;
+        uint64_t firstWindow;
+        uint32_t windows;
+        uint64_t edges;
+        double start, end;
+    };
+
+    bool OpenChunk(double start) {
+        bool ok = CloseChunk();
+        std::ostringstream name;
+        name << "chunk-" << std::setw(5) << std::setfill('0') << m_chunks.size();
+        m_chunks.push_back(Chunk{name.str(), m_windows, 0, 0, start, start});
+        std::string stem = m_dir + "/" + name.str();
+        ok = m_edgeIndex.Open(stem + ".edge_index.npy", "i4", {2}) && ok;
+        ok = m_edgeAttr.Open(stem + ".edge_attr.npy", "f4", {UAV_GRAPH_EDGE_DIM}) && ok;
+        ok = m_edgePtr.Open(stem + ".edge_ptr.npy", "i8", {}) && ok;
+        ok = m_nodeAttr.Open(stem + ".node_attr.npy", "f4", {m_numNodes, UAV_GRAPH_NODE_DIM}) && ok;
+        ok = m_windowTime.Open(stem + ".window_time.npy", "f8", {2}) && ok;
+        int64_t zero = 0;
+        return m_edgePtr.Append(&zero, 1) && ok;
+    }
+
+    bool CloseChunk() {
+        bool ok = m_edgeIndex.Close();
+        ok = m_edgeAttr.Close() && ok;
+        ok = m_edgePtr.Close() && ok;
+        ok = m_nodeAttr.Close() && ok;
+        return m_windowTime.Close() && ok;
+    }
+
+    bool WriteIndex() const {
+        std::FILE* file = std::fopen((m_dir + "/index.json").c_str(), "w");
+        if (!file) {
+            return false;
+        }
+        std::ostringstream os;
+        os << std::setprecision(9)
+           << "{\n"
+           << "  \"version\": " << UAV_GRAPH_TENSOR_VERSION << ",\n"
+           << "  \"nodes\": " << m_numNodes << ",\n"
+           << "  \"window\": " << m_window << ",\n"
+           << "  \"stride\": " << m_stride << ",\n"
+           << "  \"windows\": " << m_windows << ",\n"
+           << "  \"edges\": " << m_edges << ",\n"
+           << "  \"edge_features\": [";
+        for (uint32_t k = 0; k < UAV_GRAPH_EDGE_DIM; ++k) {
+            os << (k ? ", " : "") << "\"" << UAV_GRAPH_EDGE_FEATURES[k] << "\"";
+        }
+        os << "],\n  \"node_features\": [";
+        for (uint32_t k = 0; k < UAV_GRAPH_NODE_DIM; ++k) {
+            os << (k ? ", " : "") << "\"" << UAV_GRAPH_NODE_FEATURES[k] << "\"";
+        }
+        os << "],\n  \"chunks\": [";
+        for (size_t k = 0; k < m_chunks.size(); ++k) {
+            const Chunk& c = m_chunks[k];
+            os << (k ? ",\n" : "\n") << "    {\"name\": \"" << c.name << "\", \"first_window\": " << c.firstWindow
+               << ", \"windows\": " << c.windows << ", \"edges\": " << c.edges
+               << ", \"start\": " << c.start << ", \"end\": " << c.end << "}";
+        }
+        os << (m_chunks.empty() ? "]\n" : "\n  ]\n") << "}\n";
+        std::string text = os.str();
+        bool ok = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+        return std::fclose(file) == 0 && ok;
+    }
+
+    std::string m_dir;
+    uint32_t m_numNodes = 0;
+    uint32_t m_windowsPerChunk = 256;
+    double m_window = 0.0;
+    double m_stride = 0.0;
+    bool m_open = false;
+    bool m_ok = true;
+    std::vector<Chunk> m_chunks;
+    uint64_t m_windows = 0;
+    uint64_t m_edges = 0;
+    UavNpyWriter m_edgeIndex;
+    UavNpyWriter m_edgeAttr;
+    UavNpyWriter m_edgePtr;
+    UavNpyWriter m_nodeAttr;
+    UavNpyWriter m_windowTime;
+    std::vector<int32_t> m_index;     // 本窗口的边，按 NPY 行序排好后一次写出
+    std::vector<float> m_attr;
+};
+
+#endif // UAV_GRAPH_TENSORS_H
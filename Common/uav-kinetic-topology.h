@@ -0,0 +1,255 @@
+#ifndef UAV_KINETIC_TOPOLOGY_H
+#define UAV_KINETIC_TOPOLOGY_H
+
+#include "ns3/assert.h"
+#include "ns3/callback.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/vector.h"
+
+#include "uav-spatial-grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// 事件驱动的几何拓扑跟踪
+// 节点在两次速度更新之间做匀速直线运动，因此一对节点的距离平方是时间的二次函数，
+// 可以直接解出它穿过通信半径的时刻，只在这些时刻调度链路建立/断开事件，
+// 得到精确的变化时间，而不必以细粒度轮询所有节点对。
+//
+// - 速度变化（GaussMarkov 每个 TimeStep 触发 CourseChange）时，该节点的代号加一，
+//   之前为它调度的事件在触发时发现代号不符即作废，再对它的候选邻居重新预测；
+// - 每隔 horizon 做一次全局刷新：用最新位置重建网格并重新预测所有候选对。
+//   只调度本次刷新周期内的穿越，更远的穿越留给下一次刷新或速度变化时预测；
+// - 候选对来自网格。网格位置最多过时 horizon，加上预测窗口内的相对运动，
+//   格子边长取 range + 3 * maxSpeed * horizon 即可保证不漏掉任何穿越；
+//   观测到更高的速度时自动放大 maxSpeed，下次刷新生效。
+
+namespace ns3 {
+
+class UavKineticTopology {
+public:
+    // 链路变化回调：(i, j, up)，i < j
+    typedef Callback<void, uint32_t, uint32_t, bool> LinkChangeCallback;
+
+    // 在 MobilityHelper::Install 之后调用；节点号需为 0..N-1
+    void Install(const NodeContainer& nodes, double range, double maxSpeed, Time horizon = Seconds(1.0)) {
+        m_range = range;
+        m_maxSpeed = maxSpeed;
+        m_horizon = horizon;
+        m_numNodes = nodes.GetN();
+        m_words = (m_numNodes + 63) / 64;
+        m_links.assign(static_cast<size_t>(m_numNodes) * m_words, 0);
+        m_numLinks = 0;
+        m_models.assign(m_numNodes, nullptr);
+        m_position.assign(m_numNodes, Vector());
+        m_velocity.assign(m_numNodes, Vector());
+        m_updated.assign(m_numNodes, 0.0);
+        m_generation.assign(m_numNodes, 0);
+        for (uint32_t i = 0; i < m_numNodes; ++i) {
+            Ptr<Node> node = nodes.Get(i);
+            NS_ASSERT_MSG(node->GetId() < m_numNodes, "node ids must be 0..N-1");
+            m_models[node->GetId()] = node->GetObject<MobilityModel>();
+            m_models[node->GetId()]->TraceConnectWithoutContext(
+                "CourseChange", MakeCallback(&UavKineticTopology::CourseChanged, this));
+        }
+    }
+
+    // 在 at 时刻按几何距离建立初始拓扑，之后开始事件驱动跟踪
+    void Start(Time at) {
+        Simulator::Schedule(at, &UavKineticTopology::Initialize, this);
+    }
+
+    void SetLinkChangeCallback(LinkChangeCallback callback) { m_linkChange = callback; }
+
+    bool HasLink(uint32_t i, uint32_t j) const {
+        return (m_links[static_cast<size_t>(i) * m_words + (j >> 6)] >> (j & 63)) & 1;
+    }
+
+    // 按节点号升序枚举 i 的当前邻居
+    template <typename Fn>
+    void ForEachNeighbor(uint32_t i, Fn fn) const {
+        const uint64_t* row = &m_links[static_cast<size_t>(i) * m_words];
+        for (uint32_t w = 0; w < m_words; ++w) {
+            for (uint64_t bits = row[w]; bits != 0; bits &= bits - 1) {
+                fn(w * 64 + __builtin_ctzll(bits));
+            }
+        }
+    }
+
+    // 枚举当前所有链路，i < j
+    template <typename Fn>
+    void ForEachLink(Fn fn) const {
+        for (uint32_t i = 0; i < m_numNodes; ++i) {
+            ForEachNeighbor(i, [&](uint32_t j) {
+                if (i < j) {
+                    fn(i, j);
+                }
+            });
+        }
+    }
+
+    uint32_t GetNumNodes() const { return m_numNodes; }
+    uint64_t GetNumLinks() const { return m_numLinks; }
+    uint64_t GetLinkChanges() const { return m_changes; }
+    uint64_t GetEventsScheduled() const { return m_scheduled; }
+    uint64_t GetStaleEvents() const { return m_stale; }
+    double GetMaxSpeed() const { return m_maxSpeed; }
+
+private:
+    void Initialize() {
+        for (uint32_t i = 0; i < m_numNodes; ++i) {
+            UpdateState(i);
+        }
+        UavSpatialGrid grid;
+        grid.Build(m_position, m_range);
+        grid.ForEachPairWithin(m_position, m_range, [this](uint32_t i, uint32_t j) {
+            SetLink(i, j, true);
+        });
+        Sweep();
+    }
+
+    // 全局刷新：所有节点代号加一，重建网格，重新预测本周期内的穿越
+    void Sweep() {
+        double now = Simulator::Now().GetSeconds();
+        for (uint32_t i = 0; i < m_numNodes; ++i) {
+            UpdateState(i);
+            m_generation[i]++;
+        }
+        m_nextSweep = now + m_horizon.GetSeconds();
+        m_grid.Build(m_position, m_range + 3.0 * m_maxSpeed * m_horizon.GetSeconds());
+        m_grid.ForEachCandidatePair([this](uint32_t i, uint32_t j) {
+            PredictPair(i, j);
+        });
+        Simulator::Schedule(m_horizon, &UavKineticTopology::Sweep, this);
+    }
+
+    // 速度更新：作废该节点已调度的事件，重新预测它的候选对
+    void CourseChanged(Ptr<const MobilityModel> model) {
+        if (m_nextSweep < 0.0) {
+            return;  // 尚未开始跟踪
+        }
+        uint32_t id = model->GetObject<Node>()->GetId();
+        UpdateState(id);
+        m_generation[id]++;
+        const Vector& p = m_position[id];
+        m_grid.ForEachNear(p.x, p.y, p.z, [this, id](uint32_t j) {
+            if (j != id) {
+                PredictPair(std::min(id, j), std::max(id, j));
+            }
+        });
+    }
+
+    void UpdateState(uint32_t i) {
+        m_position[i] = m_models[i]->GetPosition();
+        m_velocity[i] = m_models[i]->GetVelocity();
+        m_updated[i] = Simulator::Now().GetSeconds();
+        double speed = m_velocity[i].GetLength();
+        if (speed > m_maxSpeed) {
+            m_maxSpeed = speed;
+        }
+    }
+
+    // 求解 |d + w t| = range 的下一次穿越，在本刷新周期内则调度
+    void PredictPair(uint32_t i, uint32_t j) {
+        double now = Simulator::Now().GetSeconds();
+        double ti = now - m_updated[i], tj = now - m_updated[j];
+        Vector d(m_position[j].x + m_velocity[j].x * tj - m_position[i].x - m_velocity[i].x * ti,
+                 m_position[j].y + m_velocity[j].y * tj - m_position[i].y - m_velocity[i].y * ti,
+                 m_position[j].z + m_velocity[j].z * tj - m_position[i].z - m_velocity[i].z * ti);
+        Vector w = m_velocity[j] - m_velocity[i];
+        double a = w.x * w.x + w.y * w.y + w.z * w.z;
+        double b = d.x * w.x + d.y * w.y + d.z * w.z;
+        double c = d.x * d.x + d.y * d.y + d.z * d.z - m_range * m_range;
+        // 正好落在边界上时（刚触发过穿越事件）不立即反向翻转
+        double tolerance = 2e-6 * m_range * m_range;
+        bool linked = HasLink(i, j);
+
+        double t;
+        if (linked) {
+            if (c > tolerance) {
+                t = 0.0;  // 已在范围外（例如速度超出预估），立即断开
+            } else if (a == 0.0) {
+                return;
+            } else {
+                t = (-b + std::sqrt(std::max(0.0, b * b - a * c))) / a;
+            }
+        } else {
+            if (c < -tolerance) {
+                t = 0.0;
+            } else if (b >= 0.0 || b * b - a * c < 0.0) {
+                return;  // 正在远离或最近距离仍超出范围
+            } else {
+                t = (-b - std::sqrt(b * b - a * c)) / a;
+            }
+        }
+        t = std::max(t, 0.0);
+        if (now + t > m_nextSweep) {
+            return;
+        }
+        Simulator::Schedule(Seconds(t), &UavKineticTopology::Crossing, this,
+                            i, j, m_generation[i], m_generation[j], !linked);
+        ++m_scheduled;
+    }
+
+    void Crossing(uint32_t i, uint32_t j, uint32_t genI, uint32_t genJ, bool up) {
+        if (genI != m_generation[i] || genJ != m_generation[j]) {
+            ++m_stale;
+            return;
+        }
+        if (HasLink(i, j) == up) {
+            return;
+        }
+        SetLink(i, j, up);
+        ++m_changes;
+        if (!m_linkChange.IsNull()) {
+            m_linkChange(i, j, up);
+        }
+        PredictPair(i, j);  // 建立后预测断开时刻（断开后一般不会在本周期内再建立）
+    }
+
+    void SetLink(uint32_t i, uint32_t j, bool up) {
+        uint64_t bi = uint64_t(1) << (j & 63), bj = uint64_t(1) << (i & 63);
+        uint64_t& wi = m_links[static_cast<size_t>(i) * m_words + (j >> 6)];
+        uint64_t& wj = m_links[static_cast<size_t>(j) * m_words + (i >> 6)];
+        if (up) {
+            wi |= bi;
+            wj |= bj;
+            ++m_numLinks;
+        } else {
+            wi &= ~bi;
+            wj &= ~bj;
+            --m_numLinks;
+        }
+    }
+
+    double m_range = 0.0;
+    double m_maxSpeed = 0.0;
+    Time m_horizon;
+    double m_nextSweep = -1.0;              // 本刷新周期结束时刻，未开始时为 -1
+    uint32_t m_numNodes = 0;
+    uint32_t m_words = 0;
+    std::vector<uint64_t> m_links;           // 对称位矩阵
+    uint64_t m_numLinks = 0;
+
+    std::vector<Ptr<MobilityModel>> m_models;
+    std::vector<Vector> m_position;          // 最近一次更新时的位置
+    std::vector<Vector> m_velocity;          // 最近一次更新时的速度
+    std::vector<double> m_updated;           // 最近一次更新的时刻
+    std::vector<uint32_t> m_generation;      // 每次更新加一，用于作废旧事件
+    UavSpatialGrid m_grid;
+
+    LinkChangeCallback m_linkChange;
+    uint64_t m_changes = 0;
+    uint64_t m_scheduled = 0;
+    uint64_t m_stale = 0;
+};
+
+} // namespace ns3
+
+#endif // UAV_KINETIC_TOPOLOGY_H
@@ -0,0 +1,255 @@
+#ifndef UAV_LINK_KERNEL_H
+#define UAV_LINK_KERNEL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define UAV_LINK_KERNEL_AVX2 1
+#include <immintrin.h>
+#else
+#define UAV_LINK_KERNEL_AVX2 0
+#endif
+
+// 整群节点对的距离 / 接收功率向量化计算
+// 输入为 SoA 的 x/y/z 数组，按行（发送端 i）一次算出到所有 j 的距离平方，
+// 得到链路位掩码（接收功率不低于灵敏度，或距离不超过固定半径）和 RSSI。
+//   - 链路判定在距离平方上进行：损耗随距离单调，链路预算事先折算成距离平方阈值，
+//     因此 AVX2 与标量路径给出的掩码逐位相同；
+//   - RSSI = A - B * log10(d^2)，Friis 与 log-distance 都可写成这一形式；
+//     AVX2 路径用自带的多项式 log（相对误差约 1e-10），输出为 float，与标量路径至多差一个 float ulp；
+//   - AVX2 以 target 属性编译，运行时检测 CPU，不支持时走标量路径。
+// 逐行输出，整群的 RSSI 矩阵由调用方按需保存（1 万节点的完整矩阵约 400 MB）。
+
+// 路径损耗模型，参数默认值与 ns-3 对应模型一致
+enum UavPathLoss {
+    UAV_PATHLOSS_RANGE = 0,      // 固定通信半径，不计算功率
+    UAV_PATHLOSS_FRIIS,          // FriisPropagationLossModel
+    UAV_PATHLOSS_LOG_DISTANCE    // LogDistancePropagationLossModel（YansWifiChannelHelper::Default）
+};
+
+struct UavLinkBudget {
+    UavPathLoss model = UAV_PATHLOSS_RANGE;
+    double range = 250.0;               // UAV_PATHLOSS_RANGE 的通信半径（米）
+    double txPowerDbm = 16.0206;
+    double rxSensitivityDbm = -101.0;
+    double frequency = 5.15e9;          // Friis
+    double systemLoss = 1.0;            // Friis
+    double exponent = 3.0;              // log-distance
+    double referenceDistance = 1.0;     // log-distance
+    double referenceLoss = 46.6777;     // log-distance
+};
+
+class UavLinkKernel {
+public:
+    enum Isa {
+        SCALAR = 0,
+        AVX2
+    };
+
+    UavLinkKernel() { Configure(UavLinkBudget()); }
+
+    void Configure(const UavLinkBudget& budget) {
+        m_budget = budget;
+        m_isa = Detect();
+        switch (budget.model) {
+        case UAV_PATHLOSS_FRIIS: {
+            // rx = tx + 20 log10(lambda / 4 pi) - 10 log10(L) - 10 log10(d^2)，损耗不小于 0
+            double lambda = 299792458.0 / budget.frequency;
+            m_a = budget.txPowerDbm + 20.0 * std::log10(lambda / (4.0 * M_PI)) - 10.0 * std::log10(budget.systemLoss);
+            m_b = 10.0;
+            m_minD2 = 1e-300;
+            m_maxRssi = budget.txPowerDbm;
+            break;
+        }
+        case UAV_PATHLOSS_LOG_DISTANCE: {
+            // rx = tx - L0 - 10 n log10(d / d0)，d0 以内按 d0 计
+            double d0 = budget.referenceDistance;
+            m_a = budget.txPowerDbm - budget.referenceLoss + 10.0 * budget.exponent * std::log10(d0);
+            m_b = 5.0 * budget.exponent;
+            m_minD2 = d0 * d0;
+            m_maxRssi = budget.txPowerDbm - budget.referenceLoss;
+            break;
+        }
+        default:
+            m_a = budget.txPowerDbm;
+            m_b = 0.0;
+            m_minD2 = 1e-300;
+            m_maxRssi = budget.txPowerDbm;
+            m_thresholdD2 = budget.range * budget.range;
+            return;
+        }
+        // rx >= sensitivity  <=>  d^2 <= 10^((A - sensitivity) / B)
+        m_thresholdD2 = budget.rxSensitivityDbm > m_maxRssi ? -1.0
+                                                             : std::pow(10.0, (m_a - budget.rxSensitivityDbm) / m_b);
+    }
+
+    // 当前 CPU 可用的最快路径
+    static Isa Detect() {
+#if UAV_LINK_KERNEL_AVX2
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return AVX2;
+        }
+#endif
+        return SCALAR;
+    }
+
+    // 强制使用某条路径（基准对比用），不支持时保持标量
+    void SetIsa(Isa isa) { m_isa = (isa == AVX2 && Detect() != AVX2) ? SCALAR : isa; }
+    Isa GetIsa() const { return m_isa; }
+    static const char* IsaName(Isa isa) { return isa == AVX2 ? "avx2" : "scalar"; }
+
+    // 等效通信半径（米）
+    double GetRange() const { return m_thresholdD2 > 0.0 ? std::sqrt(m_thresholdD2) : 0.0; }
+    const UavLinkBudget& GetBudget() const { return m_budget; }
+
+    // 距离平方为 d2 时的接收功率（dBm），与 ComputeRow 的标量路径相同
+    float Rssi(double d2) const {
+        return static_cast<float>(std::min(m_a - m_b * std::log10(std::max(d2, m_minD2)), m_maxRssi));
+    }
+
+    // 每行掩码的 64 位字数
+    static uint32_t MaskWords(uint32_t n) { return (n + 63) / 64; }
+
+    // 计算第 i 行 j ∈ [begin, n) 的部分：mask 的第 j 位为 i→j 链路（不含自身），
+    // rssi[j] 为接收功率（dBm，rssi 可为空）。mask 需有 MaskWords(n) 个字，begin 之前的位清零，
+    // rssi 在 begin 之前的元素内容不确定。返回本行链路数。
+    uint32_t ComputeRow(const double* x, const double* y, const double* z, uint32_t n,
+                        uint32_t i, uint32_t begin, uint64_t* mask, float* rssi) const {
+        std::fill(mask, mask + MaskWords(n), 0);
+        begin = std::min(begin, n);
+#if UAV_LINK_KERNEL_AVX2
+        if (m_isa == AVX2) {
+            RowAvx2(x, y, z, n, i, begin, mask, rssi);
+        } else
+#endif
+        {
+            RowScalar(x, y, z, n, i, begin, mask, rssi);
+        }
+        if (begin < n) {
+            // 按 4 对齐计算的部分里 begin 之前的位不属于本次结果
+            mask[begin >> 6] &= ~((uint64_t(1) << (begin & 63)) - 1);
+        }
+        if (i < n) {
+            mask[i >> 6] &= ~(uint64_t(1) << (i & 63));
+        }
+        uint32_t links = 0;
+        for (uint32_t w = begin >> 6; w < MaskWords(n); ++w) {
+            links += __builtin_popcountll(mask[w]);
+        }
+        return links;
+    }
+
+    // 整群所有行：fn(i, maskRow, rssiRow)，rssiRow 在 withRssi 为 false 时为空
+    template <typename Fn>
+    void ComputeAll(const double* x, const double* y, const double* z, uint32_t n, bool withRssi, Fn fn) {
+        m_mask.resize(MaskWords(n));
+        m_rssi.resize(withRssi ? n : 0);
+        for (uint32_t i = 0; i < n; ++i) {
+            ComputeRow(x, y, z, n, i, 0, m_mask.data(), withRssi ? m_rssi.data() : nullptr);
+            fn(i, static_cast<const uint64_t*>(m_mask.data()), static_cast<const float*>(withRssi ? m_rssi.data() : nullptr));
+        }
+    }
+
+    // 枚举所有链路 (i, j)，i < j，按 (i, j) 升序；只计算上三角
+    template <typename Fn>
+    void ForEachLink(const double* x, const double* y, const double* z, uint32_t n, Fn fn) {
+        m_mask.resize(MaskWords(n));
+        for (uint32_t i = 0; i + 1 < n; ++i) {
+            if (ComputeRow(x, y, z, n, i, i + 1, m_mask.data(), nullptr) == 0) {
+                continue;
+            }
+            for (uint32_t w = (i + 1) >> 6; w < m_mask.size(); ++w) {
+                for (uint64_t bits = m_mask[w]; bits != 0; bits &= bits - 1) {
+                    fn(i, w * 64 + __builtin_ctzll(bits));
+                }
+            }
+        }
+    }
+
+private:
+    void RowScalar(const double* x, const double* y, const double* z, uint32_t n,
+                   uint32_t i, uint32_t begin, uint64_t* mask, float* rssi) const {
+        double xi = x[i], yi = y[i], zi = z[i];
+        for (uint32_t j = begin; j < n; ++j) {
+            double dx = x[j] - xi, dy = y[j] - yi, dz = z[j] - zi;
+            double d2 = dx * dx + dy * dy + dz * dz;
+            if (d2 <= m_thresholdD2) {
+                mask[j >> 6] |= uint64_t(1) << (j & 63);
+            }
+            if (rssi) {
+                rssi[j] = Rssi(d2);
+            }
+        }
+    }
+
+#if UAV_LINK_KERNEL_AVX2
+    // log10(v)，v 为正规正数：v = 2^e * m，m ∈ [sqrt(1/2), sqrt(2))，
+    // ln m = 2 atanh(t)，t = (m - 1) / (m + 1)，|t| < 0.172，级数取到 t^11
+    __attribute__((target("avx2"))) static __m256d Log10Avx2(__m256d v) {
+        const __m256i mantissaMask = _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll);
+        const __m256i one = _mm256_set1_epi64x(0x3FF0000000000000ll);
+        __m256i bits = _mm256_castpd_si256(v);
+        // 指数转 double：低位放入 2^52 的尾数后减去 2^52
+        __m256i biased = _mm256_srli_epi64(bits, 52);
+        __m256d e = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(biased, _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.0)))),
+                                  _mm256_set1_pd(4503599627370496.0 + 1023.0));
+        __m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, mantissaMask), one));
+        __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(M_SQRT2), _CMP_GT_OQ);
+        m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+        e = _mm256_add_pd(e, _mm256_and_pd(big, _mm256_set1_pd(1.0)));
+        __m256d t = _mm256_div_pd(_mm256_sub_pd(m, _mm256_set1_pd(1.0)), _mm256_add_pd(m, _mm256_set1_pd(1.0)));
+        __m256d t2 = _mm256_mul_pd(t, t);
+        __m256d p = _mm256_set1_pd(1.0 / 11.0);
+        p = _mm256_add_pd(_mm256_mul_pd(p, t2), _mm256_set1_pd(1.0 / 9.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, t2), _mm256_set1_pd(1.0 / 7.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, t2), _mm256_set1_pd(1.0 / 5.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, t2), _mm256_set1_pd(1.0 / 3.0));
+        p = _mm256_add_pd(_mm256_mul_pd(p, t2), _mm256_set1_pd(1.0));
+        __m256d lnm = _mm256_mul_pd(_mm256_mul_pd(t, _mm256_set1_pd(2.0)), p);
+        __m256d ln = _mm256_add_pd(_mm256_mul_pd(e, _mm256_set1_pd(M_LN2)), lnm);
+        return _mm256_mul_pd(ln, _mm256_set1_pd(1.0 / M_LN10));
+    }
+
+    // 每次 4 个 j；不用 FMA，距离平方与标量路径逐位相同
+    __attribute__((target("avx2"))) void RowAvx2(const double* x, const double* y, const double* z, uint32_t n,
+                                                 uint32_t i, uint32_t begin, uint64_t* mask, float* rssi) const {
+        __m256d xi = _mm256_set1_pd(x[i]), yi = _mm256_set1_pd(y[i]), zi = _mm256_set1_pd(z[i]);
+        __m256d threshold = _mm256_set1_pd(m_thresholdD2);
+        __m256d a = _mm256_set1_pd(m_a), b = _mm256_set1_pd(m_b);
+        __m256d minD2 = _mm256_set1_pd(m_minD2), maxRssi = _mm256_set1_pd(m_maxRssi);
+        uint32_t j = begin & ~3u;
+        for (; j + 4 <= n; j += 4) {
+            __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), xi);
+            __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), yi);
+            __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + j), zi);
+            __m256d d2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)),
+                                       _mm256_mul_pd(dz, dz));
+            uint64_t bits = static_cast<uint64_t>(_mm256_movemask_pd(_mm256_cmp_pd(d2, threshold, _CMP_LE_OQ)));
+            mask[j >> 6] |= bits << (j & 63);
+            if (rssi) {
+                __m256d level = _mm256_sub_pd(a, _mm256_mul_pd(b, Log10Avx2(_mm256_max_pd(d2, minD2))));
+                _mm_storeu_ps(rssi + j, _mm256_cvtpd_ps(_mm256_min_pd(level, maxRssi)));
+            }
+        }
+        // 尾部与对齐前的部分走标量
+        RowScalar(x, y, z, n, i, std::max(j, begin), mask, rssi);
+    }
+#endif
+
+    UavLinkBudget m_budget;
+    Isa m_isa = SCALAR;
+    double m_a = 0.0;              // RSSI = A - B * log10(d^2)
+    double m_b = 0.0;
+    double m_minD2 = 1e-300;       // log 前距离平方的下限
+    double m_maxRssi = 0.0;        // RSSI 上限（损耗不为负）
+    double m_thresholdD2 = 0.0;    // 链路判定的距离平方阈值，< 0 表示无链路
+    std::vector<uint64_t> m_mask;
+    std::vector<float> m_rssi;
+};
+
+#endif // UAV_LINK_KERNEL_H
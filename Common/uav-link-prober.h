@@ -0,0 +1,130 @@
+#ifndef UAV_LINK_PROBER_H
+#define UAV_LINK_PROBER_H
+
+#include "ns3/application.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/traced-callback.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+// 常驻的链路探测应用：每个节点安装一个，整个仿真期间复用同一个 UDP socket。
+// 每个周期通过回调向当前拓扑查询邻居地址，向每个邻居的回显服务器发一个探测包，
+// 收到的回显通过 "Rx" trace 上报。取代每 0.5 秒为每条链路新装 UdpEchoClient 的做法，
+// 应用数量和内存不随仿真时长增长。
+
+namespace ns3 {
+
+class UavLinkProber : public Application {
+public:
+    // 查询本节点当前的探测目标，结果写入（复用的）地址数组
+    typedef Callback<void, uint32_t, std::vector<Ipv4Address>&> DestinationCallback;
+
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::UavLinkProber")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<UavLinkProber>()
+            .AddAttribute("Interval", "Time between probe rounds",
+                          TimeValue(Seconds(0.5)),
+                          MakeTimeAccessor(&UavLinkProber::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("RemotePort", "Destination port of the echo servers",
+                          UintegerValue(2000),
+                          MakeUintegerAccessor(&UavLinkProber::m_peerPort),
+                          MakeUintegerChecker<uint16_t>())
+            .AddAttribute("PacketSize", "Size of each probe payload",
+                          UintegerValue(512),
+                          MakeUintegerAccessor(&UavLinkProber::m_size),
+                          MakeUintegerChecker<uint32_t>())
+            .AddTraceSource("Tx", "A probe is sent",
+                            MakeTraceSourceAccessor(&UavLinkProber::m_txTrace),
+                            "ns3::Packet::TracedCallback")
+            .AddTraceSource("Rx", "An echo reply is received",
+                            MakeTraceSourceAccessor(&UavLinkProber::m_rxTrace),
+                            "ns3::Packet::AddressTracedCallback");
+        return tid;
+    }
+
+    void SetDestinationCallback(DestinationCallback callback) {
+        m_destinations = callback;
+    }
+
+    uint64_t GetProbesSent() const { return m_sent; }
+
+protected:
+    void DoDispose() override {
+        m_socket = nullptr;
+        m_destinations = MakeNullCallback<void, uint32_t, std::vector<Ipv4Address>&>();
+        Application::DoDispose();
+    }
+
+private:
+    void StartApplication() override {
+        if (!m_socket) {
+            m_socket = Socket::CreateSocket(GetNode(), UdpSocketFactory::GetTypeId());
+            m_socket->Bind();
+            m_socket->SetRecvCallback(MakeCallback(&UavLinkProber::HandleRead, this));
+        }
+        // 所有探测包共享同一份负载，发送时只做写时复制的 Copy
+        m_probe = Create<Packet>(m_size);
+        Probe();
+    }
+
+    void StopApplication() override {
+        Simulator::Cancel(m_event);
+        if (m_socket) {
+            m_socket->Close();
+            m_socket->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+            m_socket = nullptr;   // 重新启动时另建 socket
+        }
+    }
+
+    void Probe() {
+        m_peers.clear();
+        if (!m_destinations.IsNull()) {
+            m_destinations(GetNode()->GetId(), m_peers);
+        }
+        for (const Ipv4Address& peer : m_peers) {
+            Ptr<Packet> p = m_probe->Copy();
+            m_txTrace(p);
+            m_socket->SendTo(p, 0, InetSocketAddress(peer, m_peerPort));
+            ++m_sent;
+        }
+        m_event = Simulator::Schedule(m_interval, &UavLinkProber::Probe, this);
+    }
+
+    void HandleRead(Ptr<Socket> socket) {
+        Ptr<Packet> packet;
+        Address from;
+        while ((packet = socket->RecvFrom(from))) {
+            m_rxTrace(packet, from);
+        }
+    }
+
+    Time m_interval;
+    uint16_t m_peerPort = 2000;
+    uint32_t m_size = 512;
+
+    Ptr<Socket> m_socket;
+    Ptr<Packet> m_probe;
+    EventId m_event;
+    DestinationCallback m_destinations;
+    std::vector<Ipv4Address> m_peers;  // 每轮复用的目标地址缓冲
+    uint64_t m_sent = 0;
+
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+    TracedCallback<Ptr<const Packet>, const Address&> m_rxTrace;
+};
+
+} // namespace ns3
+
+#endif // UAV_LINK_PROBER_H
@@ -0,0 +1,148 @@
+#ifndef UAV_LINK_TABLE_H
+#define UAV_LINK_TABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 紧凑的无向拓扑表，替代 std::map<pair, bool>
+// - 稠密集群：N×N 位矩阵，HasLink 为 O(1)
+// - 稀疏集群：CSR 邻接表（每个节点的邻居连续存放且升序）
+// 两种布局按内存占用在每次 Build 时自动选择，缓冲区在多次 Build 之间复用。
+class UavLinkTable {
+public:
+    enum Layout {
+        AUTO,
+        BIT_MATRIX,
+        CSR
+    };
+
+    typedef std::pair<uint32_t, uint32_t> Edge;
+
+    // 由无向边列表构建，edges 中每条边只出现一次（顺序、方向任意）
+    void Build(uint32_t numNodes, const std::vector<Edge>& edges, Layout layout = AUTO) {
+        m_numNodes = numNodes;
+        m_numEdges = edges.size();
+        m_layout = (layout == AUTO) ? ChooseLayout(numNodes, m_numEdges) : layout;
+
+        m_degree.assign(numNodes, 0);
+        for (const Edge& e : edges) {
+            m_degree[e.first]++;
+            m_degree[e.second]++;
+        }
+
+        if (m_layout == BIT_MATRIX) {
+            m_words = (numNodes + 63) / 64;
+            m_bits.assign(static_cast<size_t>(numNodes) * m_words, 0);
+            for (const Edge& e : edges) {
+                SetBit(e.first, e.second);
+                SetBit(e.second, e.first);
+            }
+            m_offsets.clear();
+            m_neighbors.clear();
+        } else {
+            m_offsets.assign(numNodes + 1, 0);
+            for (uint32_t i = 0; i < numNodes; ++i) {
+                m_offsets[i + 1] = m_offsets[i] + m_degree[i];
+            }
+            m_neighbors.resize(m_offsets[numNodes]);
+            m_fill.assign(m_offsets.begin(), m_offsets.end() - 1);
+            for (const Edge& e : edges) {
+                m_neighbors[m_fill[e.first]++] = e.second;
+                m_neighbors[m_fill[e.second]++] = e.first;
+            }
+            for (uint32_t i = 0; i < numNodes; ++i) {
+                std::sort(m_neighbors.begin() + m_offsets[i], m_neighbors.begin() + m_offsets[i + 1]);
+            }
+            m_words = 0;
+            m_bits.clear();
+        }
+    }
+
+    void Clear() {
+        std::vector<Edge> none;
+        Build(m_numNodes, none, m_layout);
+    }
+
+    bool HasLink(uint32_t i, uint32_t j) const {
+        if (m_layout == BIT_MATRIX) {
+            return (m_bits[static_cast<size_t>(i) * m_words + j / 64] >> (j % 64)) & 1;
+        }
+        auto begin = m_neighbors.begin() + m_offsets[i];
+        auto end = m_neighbors.begin() + m_offsets[i + 1];
+        return std::binary_search(begin, end, j);
+    }
+
+    uint32_t Degree(uint32_t i) const { return m_degree[i]; }
+
+    // 按升序遍历节点 i 的邻居
+    template <typename Fn>
+    void ForEachNeighbor(uint32_t i, Fn fn) const {
+        if (m_layout == BIT_MATRIX) {
+            const uint64_t* row = &m_bits[static_cast<size_t>(i) * m_words];
+            for (uint32_t w = 0; w < m_words; ++w) {
+                uint64_t bits = row[w];
+                while (bits) {
+                    fn(w * 64 + static_cast<uint32_t>(__builtin_ctzll(bits)));
+                    bits &= bits - 1;
+                }
+            }
+        } else {
+            for (uint32_t k = m_offsets[i]; k < m_offsets[i + 1]; ++k) {
+                fn(m_neighbors[k]);
+            }
+        }
+    }
+
+    // 遍历所有无向边，每条边回调一次 fn(i, j)，i < j，按 (i, j) 升序
+    template <typename Fn>
+    void ForEachEdge(Fn fn) const {
+        for (uint32_t i = 0; i < m_numNodes; ++i) {
+            ForEachNeighbor(i, [&](uint32_t j) {
+                if (i < j) {
+                    fn(i, j);
+                }
+            });
+        }
+    }
+
+    uint32_t GetNumNodes() const { return m_numNodes; }
+    uint64_t GetNumEdges() const { return m_numEdges; }
+    Layout GetLayout() const { return m_layout; }
+
+    // 当前布局占用的字节数（不含临时缓冲）
+    size_t GetMemoryBytes() const {
+        return m_bits.size() * sizeof(uint64_t) + m_offsets.size() * sizeof(uint32_t) +
+               m_neighbors.size() * sizeof(uint32_t) + m_degree.size() * sizeof(uint32_t);
+    }
+
+    // 位矩阵占用 N²/8 字节，CSR 占用 4(N+1) + 8E 字节，取较小者
+    static Layout ChooseLayout(uint32_t numNodes, uint64_t numEdges) {
+        uint64_t matrixBytes = static_cast<uint64_t>(numNodes) * ((numNodes + 63) / 64) * 8;
+        uint64_t csrBytes = 4 * (static_cast<uint64_t>(numNodes) + 1) + 8 * numEdges;
+        return matrixBytes <= csrBytes ? BIT_MATRIX : CSR;
+    }
+
+private:
+    void SetBit(uint32_t i, uint32_t j) {
+        m_bits[static_cast<size_t>(i) * m_words + j / 64] |= uint64_t(1) << (j % 64);
+    }
+
+    uint32_t m_numNodes = 0;
+    uint64_t m_numEdges = 0;
+    Layout m_layout = CSR;
+
+    std::vector<uint32_t> m_degree;     // 各节点度数
+
+    // 位矩阵布局
+    uint32_t m_words = 0;               // 每行 64 位字数
+    std::vector<uint64_t> m_bits;
+
+    // CSR 布局
+    std::vector<uint32_t> m_offsets;    // 长度 N+1
+    std::vector<uint32_t> m_neighbors;  // 长度 2E
+    std::vector<uint32_t> m_fill;       // 构建时的临时游标
+};
+
+#endif // UAV_LINK_TABLE_H
@@ -0,0 +1,143 @@
+#ifndef UAV_MOBILITY_SNAPSHOT_H
+#define UAV_MOBILITY_SNAPSHOT_H
+
+#include "ns3/assert.h"
+#include "ns3/event-id.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/vector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 节点位置快照
+// trace 回调和拓扑更新按节点号取位置，不再每包做一次 GetObject<MobilityModel>() 和位置外推。
+// 三种精度/速度档：
+//   exact        缓存 MobilityModel 指针，每次调用 GetPosition（结果与原来逐包查询完全一致）
+//   snapshot     每 step 秒把所有节点的位置/速度刷新到 SoA 数组，读取时直接返回快照位置
+//   interpolate  同上，读取时按快照速度线性外推到当前时刻
+// 数组按节点号索引。
+
+namespace ns3 {
+
+class UavMobilitySnapshot {
+public:
+    enum Mode {
+        EXACT = 0,
+        SNAPSHOT,
+        INTERPOLATE
+    };
+
+    // 解析 "exact" / "snapshot" / "interpolate"
+    static bool ParseMode(const std::string& text, Mode& mode) {
+        if (text == "exact") {
+            mode = EXACT;
+        } else if (text == "snapshot") {
+            mode = SNAPSHOT;
+        } else if (text == "interpolate") {
+            mode = INTERPOLATE;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // 在 MobilityHelper::Install 之后调用；非 exact 模式立即刷新一次并按 step 周期刷新
+    void Install(const NodeContainer& nodes, Mode mode = EXACT, Time step = Seconds(0.1)) {
+        Clear();
+        m_mode = mode;
+        m_step = step;
+        uint32_t size = 0;
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+            size = std::max(size, (*it)->GetId() + 1);
+        }
+        m_models.assign(size, nullptr);
+        for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+            Ptr<MobilityModel> model = (*it)->GetObject<MobilityModel>();
+            NS_ASSERT_MSG(model, "node " << (*it)->GetId() << " has no mobility model");
+            m_models[(*it)->GetId()] = model;
+        }
+        if (m_mode != EXACT) {
+            for (std::vector<double>* column : {&m_x, &m_y, &m_z, &m_vx, &m_vy, &m_vz}) {
+                column->assign(size, 0.0);
+            }
+            Refresh();
+        }
+    }
+
+    void Clear() {
+        Simulator::Cancel(m_event);
+        m_models.clear();
+        m_refreshes = 0;
+    }
+
+    Vector GetPosition(uint32_t nodeId) const {
+        switch (m_mode) {
+        case SNAPSHOT:
+            return Vector(m_x[nodeId], m_y[nodeId], m_z[nodeId]);
+        case INTERPOLATE: {
+            double dt = Simulator::Now().GetSeconds() - m_time;
+            return Vector(m_x[nodeId] + m_vx[nodeId] * dt,
+                          m_y[nodeId] + m_vy[nodeId] * dt,
+                          m_z[nodeId] + m_vz[nodeId] * dt);
+        }
+        default:
+            return m_models[nodeId]->GetPosition();
+        }
+    }
+
+    // 所有节点的位置，out[nodeId]
+    void GetPositions(std::vector<Vector>& out) const {
+        out.resize(m_models.size());
+        for (uint32_t i = 0; i < m_models.size(); ++i) {
+            out[i] = GetPosition(i);
+        }
+    }
+
+    // 按列访问快照（非 exact 模式），供批量计算使用
+    const std::vector<double>& GetX() const { return m_x; }
+    const std::vector<double>& GetY() const { return m_y; }
+    const std::vector<double>& GetZ() const { return m_z; }
+    double GetSnapshotTime() const { return m_time; }
+
+    Mode GetMode() const { return m_mode; }
+    uint32_t GetN() const { return m_models.size(); }
+    uint64_t GetRefreshCount() const { return m_refreshes; }
+
+private:
+    void Refresh() {
+        m_time = Simulator::Now().GetSeconds();
+        for (uint32_t i = 0; i < m_models.size(); ++i) {
+            if (!m_models[i]) {
+                continue;
+            }
+            Vector p = m_models[i]->GetPosition();
+            Vector v = m_models[i]->GetVelocity();
+            m_x[i] = p.x;
+            m_y[i] = p.y;
+            m_z[i] = p.z;
+            m_vx[i] = v.x;
+            m_vy[i] = v.y;
+            m_vz[i] = v.z;
+        }
+        ++m_refreshes;
+        m_event = Simulator::Schedule(m_step, &UavMobilitySnapshot::Refresh, this);
+    }
+
+    Mode m_mode = EXACT;
+    Time m_step;
+    std::vector<Ptr<MobilityModel>> m_models;
+    std::vector<double> m_x, m_y, m_z;       // 位置（SoA）
+    std::vector<double> m_vx, m_vy, m_vz;    // 速度（SoA）
+    double m_time = 0.0;                     // 快照时刻
+    EventId m_event;
+    uint64_t m_refreshes = 0;
+};
+
+} // namespace ns3
+
+#endif // UAV_MOBILITY_SNAPSHOT_H
@@ -0,0 +1,116 @@
+#ifndef UAV_PACKET_CLASSIFIER_H
+#define UAV_PACKET_CLASSIFIER_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/packet.h"
+
+#include <algorithm>
+#include <cstdint>
+
+// IP 层 trace 的只读报文分类
+// 直接按偏移读取已序列化的 IPv4/TCP/UDP 头部字段，不调用 packet->Copy()，
+// 也不反序列化 Ipv4Header/TcpHeader 对象。
+
+namespace ns3 {
+
+struct UavPacketInfo {
+    uint8_t protocol = 0;         // IPv4 协议号（6 = TCP，17 = UDP）
+    uint8_t tcpFlags = 0;         // TCP 标志位
+    bool isAck = false;           // 是否带 ACK 标志
+    uint32_t payloadSize = 0;     // 去掉 IP/TCP（UDP）头部后的负载字节数
+    Ipv4Address source;
+    Ipv4Address destination;
+};
+
+const uint8_t UAV_IPPROTO_TCP = 6;
+const uint8_t UAV_IPPROTO_UDP = 17;
+const uint32_t UAV_UDP_HEADER_SIZE = 8;
+const uint8_t UAV_TCP_FLAG_ACK = 0x10;
+
+// 解析从 IPv4 头部开始的字节。data 至少包含 IPv4 头部与 TCP 头部的前 14 字节，
+// packetSize 为整个报文长度。不是 TCP 首分片或头部不完整时返回 false。
+inline bool UavParseIpv4Tcp(const uint8_t* data, uint32_t length, uint32_t packetSize,
+                            UavPacketInfo& info) {
+    if (length < 20 || (data[0] >> 4) != 4) {
+        return false;
+    }
+    info.protocol = data[9];
+    if (info.protocol != UAV_IPPROTO_TCP) {
+        return false;
+    }
+    uint32_t ipHeaderSize = (data[0] & 0x0f) * 4;
+    uint16_t fragmentOffset = ((data[6] & 0x1f) << 8) | data[7];
+    if (ipHeaderSize < 20 || fragmentOffset != 0 || length < ipHeaderSize + 14) {
+        return false;
+    }
+    info.source.Set((uint32_t(data[12]) << 24) | (uint32_t(data[13]) << 16) |
+                    (uint32_t(data[14]) << 8) | data[15]);
+    info.destination.Set((uint32_t(data[16]) << 24) | (uint32_t(data[17]) << 16) |
+                         (uint32_t(data[18]) << 8) | data[19]);
+
+    const uint8_t* tcp = data + ipHeaderSize;
+    uint32_t tcpHeaderSize = (tcp[12] >> 4) * 4;
+    if (tcpHeaderSize < 20 || packetSize < ipHeaderSize + tcpHeaderSize) {
+        return false;
+    }
+    info.tcpFlags = tcp[13];
+    info.isAck = (info.tcpFlags & UAV_TCP_FLAG_ACK) != 0;
+    info.payloadSize = packetSize - ipHeaderSize - tcpHeaderSize;
+    return true;
+}
+
+// 对 Ipv4L3Protocol Tx/Rx trace 收到的报文（带 IPv4 头部）分类。
+// 先只取 IPv4 固定头部判断协议号，非 TCP 报文不再读取后续字节。
+inline bool UavClassifyTcp(Ptr<const Packet> packet, UavPacketInfo& info) {
+    uint8_t buffer[60 + 14];
+    uint32_t size = packet->GetSize();
+    uint32_t copied = packet->CopyData(buffer, std::min<uint32_t>(size, 20));
+    if (copied < 20 || buffer[9] != UAV_IPPROTO_TCP) {
+        return false;
+    }
+    uint32_t ipHeaderSize = (buffer[0] & 0x0f) * 4;
+    copied = packet->CopyData(buffer, std::min<uint32_t>(size, ipHeaderSize + 14));
+    return UavParseIpv4Tcp(buffer, copied, size, info);
+}
+
+// 同时接受 UDP 首分片：UDP 没有确认，isAck 为 false，负载为去掉 8 字节 UDP 头部后的长度。
+// data 对 UDP 只需包含 IPv4 头部
+inline bool UavParseIpv4Transport(const uint8_t* data, uint32_t length, uint32_t packetSize,
+                                  UavPacketInfo& info) {
+    if (length < 20 || (data[0] >> 4) != 4 || data[9] != UAV_IPPROTO_UDP) {
+        return UavParseIpv4Tcp(data, length, packetSize, info);
+    }
+    info.protocol = UAV_IPPROTO_UDP;
+    uint32_t ipHeaderSize = (data[0] & 0x0f) * 4;
+    uint16_t fragmentOffset = ((data[6] & 0x1f) << 8) | data[7];
+    if (ipHeaderSize < 20 || fragmentOffset != 0 || length < ipHeaderSize ||
+        packetSize < ipHeaderSize + UAV_UDP_HEADER_SIZE) {
+        return false;
+    }
+    info.source.Set((uint32_t(data[12]) << 24) | (uint32_t(data[13]) << 16) |
+                    (uint32_t(data[14]) << 8) | data[15]);
+    info.destination.Set((uint32_t(data[16]) << 24) | (uint32_t(data[17]) << 16) |
+                         (uint32_t(data[18]) << 8) | data[19]);
+    info.tcpFlags = 0;
+    info.isAck = false;
+    info.payloadSize = packetSize - ipHeaderSize - UAV_UDP_HEADER_SIZE;
+    return true;
+}
+
+// TCP 和 UDP 报文分类（--burstProtocol=udp 的突发也要进入记录和拓扑推断），其他协议返回 false
+inline bool UavClassifyTransport(Ptr<const Packet> packet, UavPacketInfo& info) {
+    uint8_t buffer[60 + 14];
+    uint32_t size = packet->GetSize();
+    uint32_t copied = packet->CopyData(buffer, std::min<uint32_t>(size, 20));
+    if (copied < 20 || (buffer[9] != UAV_IPPROTO_TCP && buffer[9] != UAV_IPPROTO_UDP)) {
+        return false;
+    }
+    uint32_t ipHeaderSize = (buffer[0] & 0x0f) * 4;
+    uint32_t needed = ipHeaderSize + (buffer[9] == UAV_IPPROTO_TCP ? 14 : 0);
+    copied = packet->CopyData(buffer, std::min<uint32_t>(size, needed));
+    return UavParseIpv4Transport(buffer, copied, size, info);
+}
+
+} // namespace ns3
+
+#endif // UAV_PACKET_CLASSIFIER_H
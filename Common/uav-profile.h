@@ -0,0 +1,285 @@
+#ifndef UAV_PROFILE_H
+#define UAV_PROFILE_H
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 自身回调耗时统计
+// 每个被统计的回调在入口放一个 UAV_PROFILE_SCOPE，累计调用次数、时钟周期和按 2 的幂分桶的
+// 单次耗时直方图；回调写出的 trace 记录数和字节数由 UAV_TRACE_RECORD / UAV_TRACE_TEXT 计入同一项。
+// 运行结束后与仿真器事件数、峰值内存一起写成 key=value 文件，供 uav-tools scale 汇总。
+// 计时用 TSC（非 x86 平台为 steady_clock 纳秒），周期数按运行期间的墙钟时间换算为秒。
+// 编译时定义 UAV_INSTRUMENT=0 则所有宏展开为空，回调中不留任何统计代码。
+
+#ifndef UAV_INSTRUMENT
+#define UAV_INSTRUMENT 1
+#endif
+
+enum UavProfileSlot {
+    UAV_PROFILE_TX_TRACE = 0,
+    UAV_PROFILE_UPDATE_TOPOLOGY,
+    UAV_PROFILE_IPV4_TRACER,
+    UAV_PROFILE_TOPOLOGY_OUTPUT,
+    UAV_PROFILE_LOG_TRANSMISSION,
+    UAV_PROFILE_SERVER_RECEIVE,
+    UAV_PROFILE_CLIENT_RECEIVE_ACK,
+    UAV_PROFILE_PROBE_TRANSMISSIONS,
+    UAV_PROFILE_SLOT_COUNT
+};
+
+inline const char* UavProfileSlotName(int slot) {
+    static const char* const kNames[UAV_PROFILE_SLOT_COUNT] = {
+        "TxTrace", "UpdateTopology", "Ipv4Tracer", "TopologyOutput",
+        "LogTransmission", "ServerReceive", "ClientReceiveAck", "ProbeTransmissions"};
+    return kNames[slot];
+}
+
+// 当前时钟计数
+inline uint64_t UavReadTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+class UavProfiler {
+public:
+    static const int HISTOGRAM_BUCKETS = 64;   // 桶 b 为 [2^b, 2^(b+1)) 个时钟周期
+
+    struct SlotStats {
+        uint64_t calls = 0;
+        uint64_t ticks = 0;
+        uint64_t maxTicks = 0;
+        uint64_t records = 0;   // 写出的 trace 记录数
+        uint64_t bytes = 0;     // 写出的 trace 字节数
+        uint64_t histogram[HISTOGRAM_BUCKETS] = {};
+    };
+
+    static UavProfiler& Get() {
+        static UavProfiler instance;
+        return instance;
+    }
+
+    // outermost 为 false 表示嵌套在另一个被统计的回调内，不计入 GetTotalSeconds
+    void Add(int slot, uint64_t ticks, bool outermost = true) {
+        SlotStats& s = m_slots[slot];
+        s.calls++;
+        s.ticks += ticks;
+        s.maxTicks = ticks > s.maxTicks ? ticks : s.maxTicks;
+        s.histogram[63 - __builtin_clzll(ticks | 1)]++;
+        if (outermost) {
+            m_outermostTicks += ticks;
+        }
+    }
+
+    void AddRecord(int slot, uint64_t bytes) {
+        if (bytes > 0) {
+            m_slots[slot].records++;
+            m_slots[slot].bytes += bytes;
+        }
+    }
+
+    // 作用域嵌套深度，由 UavProfileScope 维护
+    bool Enter() { return m_depth++ == 0; }
+    void Leave() { --m_depth; }
+
+    const SlotStats& GetSlot(int slot) const { return m_slots[slot]; }
+    uint64_t GetCalls(int slot) const { return m_slots[slot].calls; }
+    uint64_t GetNanoseconds(int slot) const { return static_cast<uint64_t>(TicksToSeconds(m_slots[slot].ticks) * 1e9); }
+
+    // 每秒时钟周期数：按构造以来的 TSC 与墙钟增量估计
+    double GetTicksPerSecond() const {
+#if defined(__x86_64__) || defined(__i386__)
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_clockStart).count();
+        if (elapsed < 0.01) {
+            // 运行过短时等够 10 ms 再估计
+            auto until = m_clockStart + std::chrono::milliseconds(10);
+            while (std::chrono::steady_clock::now() < until) {
+            }
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_clockStart).count();
+        }
+        return (UavReadTicks() - m_ticksStart) / elapsed;
+#else
+        return 1e9;
+#endif
+    }
+
+    double TicksToSeconds(uint64_t ticks) const { return ticks / GetTicksPerSecond(); }
+
+    // 最外层回调的累计耗时（秒），嵌套的回调不重复计算
+    double GetTotalSeconds() const { return TicksToSeconds(m_outermostTicks); }
+
+    // 按直方图估计的分位耗时（秒），取所在桶的上界
+    double GetQuantileSeconds(int slot, double q) const {
+        const SlotStats& s = m_slots[slot];
+        uint64_t rank = static_cast<uint64_t>(q * s.calls), seen = 0;
+        for (int b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+            seen += s.histogram[b];
+            if (seen > rank) {
+                uint64_t upper = b < 63 ? (uint64_t(2) << b) : s.maxTicks;
+                return TicksToSeconds(upper < s.maxTicks ? upper : s.maxTicks);
+            }
+        }
+        return TicksToSeconds(s.maxTicks);
+    }
+
+    // 写出运行统计：wallSeconds 为 Simulator::Run 的墙钟耗时，events 为已执行事件数
+    bool WriteStats(const std::string& path, double simulatedSeconds, double wallSeconds,
+                    uint64_t events, uint32_t numNodes) const {
+        std::ofstream os(path);
+        if (!os) {
+            return false;
+        }
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        os << "nodes=" << numNodes << "\n"
+           << "simulated_seconds=" << simulatedSeconds << "\n"
+           << "wall_seconds=" << wallSeconds << "\n"
+           << "events=" << events << "\n"
+           << "events_per_second=" << (wallSeconds > 0 ? events / wallSeconds : 0.0) << "\n"
+           << "wall_per_simulated_second=" << (simulatedSeconds > 0 ? wallSeconds / simulatedSeconds : 0.0) << "\n"
+           << "peak_rss_kb=" << usage.ru_maxrss << "\n"
+           << "instrumented=" << UAV_INSTRUMENT << "\n"
+           << "callback_seconds=" << GetTotalSeconds() << "\n";
+        for (int i = 0; i < UAV_PROFILE_SLOT_COUNT; ++i) {
+            const SlotStats& s = m_slots[i];
+            os << "callback." << UavProfileSlotName(i) << ".calls=" << s.calls << "\n"
+               << "callback." << UavProfileSlotName(i) << ".seconds=" << TicksToSeconds(s.ticks) << "\n"
+               << "callback." << UavProfileSlotName(i) << ".records=" << s.records << "\n"
+               << "callback." << UavProfileSlotName(i) << ".bytes=" << s.bytes << "\n";
+        }
+        return true;
+    }
+
+    // 以回调名为键的 JSON 对象，indent 为所在行的缩进
+    void WriteJson(std::ostream& os, const std::string& indent) const {
+        os << "{";
+        bool first = true;
+        for (int i = 0; i < UAV_PROFILE_SLOT_COUNT; ++i) {
+            const SlotStats& s = m_slots[i];
+            if (s.calls == 0 && s.records == 0) {
+                continue;
+            }
+            os << (first ? "\n" : ",\n") << indent << "  \"" << UavProfileSlotName(i) << "\": {"
+               << "\"calls\": " << s.calls
+               << ", \"seconds\": " << TicksToSeconds(s.ticks)
+               << ", \"mean_ns\": " << (s.calls ? TicksToSeconds(s.ticks) * 1e9 / s.calls : 0.0)
+               << ", \"p50_ns\": " << GetQuantileSeconds(i, 0.5) * 1e9
+               << ", \"p99_ns\": " << GetQuantileSeconds(i, 0.99) * 1e9
+               << ", \"max_ns\": " << TicksToSeconds(s.maxTicks) * 1e9
+               << ", \"records\": " << s.records
+               << ", \"bytes\": " << s.bytes
+               << ", \"histogram_ticks_log2\": [";
+            int last = HISTOGRAM_BUCKETS - 1;
+            while (last > 0 && s.histogram[last] == 0) {
+                --last;
+            }
+            for (int b = 0; b <= last; ++b) {
+                os << (b ? ", " : "") << s.histogram[b];
+            }
+            os << "]}";
+            first = false;
+        }
+        os << (first ? "}" : "\n" + indent + "}");
+    }
+
+    // 各回调一行：调用次数、累计耗时、平均/分位/最大单次耗时、trace 记录与字节数
+    void PrintSummary(std::ostream& os) const {
+        os << std::left << std::setw(20) << "callback" << std::right << std::setw(12) << "calls"
+           << std::setw(12) << "total(ms)" << std::setw(11) << "mean(ns)" << std::setw(11) << "p50(ns)"
+           << std::setw(11) << "p99(ns)" << std::setw(12) << "max(ns)" << std::setw(12) << "records"
+           << std::setw(14) << "bytes" << "\n";
+        for (int i = 0; i < UAV_PROFILE_SLOT_COUNT; ++i) {
+            const SlotStats& s = m_slots[i];
+            if (s.calls == 0 && s.records == 0) {
+                continue;
+            }
+            double total = TicksToSeconds(s.ticks);
+            os << std::left << std::setw(20) << UavProfileSlotName(i) << std::right << std::setw(12) << s.calls
+               << std::fixed << std::setprecision(1) << std::setw(12) << total * 1e3
+               << std::setprecision(0) << std::setw(11) << (s.calls ? total * 1e9 / s.calls : 0.0)
+               << std::setw(11) << GetQuantileSeconds(i, 0.5) * 1e9
+               << std::setw(11) << GetQuantileSeconds(i, 0.99) * 1e9
+               << std::setw(12) << TicksToSeconds(s.maxTicks) * 1e9
+               << std::setw(12) << s.records << std::setw(14) << s.bytes << "\n";
+        }
+        os.unsetf(std::ios::floatfield);
+        os << std::setprecision(6);
+    }
+
+private:
+    UavProfiler() : m_clockStart(std::chrono::steady_clock::now()), m_ticksStart(UavReadTicks()) {}
+
+    SlotStats m_slots[UAV_PROFILE_SLOT_COUNT];
+    uint64_t m_outermostTicks = 0;
+    int m_depth = 0;
+    std::chrono::steady_clock::time_point m_clockStart;
+    uint64_t m_ticksStart;
+};
+
+// 作用域计时：构造时读时钟，析构时累计到对应统计项
+class UavProfileScope {
+public:
+    explicit UavProfileScope(int slot)
+        : m_slot(slot), m_outermost(UavProfiler::Get().Enter()), m_start(UavReadTicks()) {}
+
+    ~UavProfileScope() {
+        uint64_t ticks = UavReadTicks() - m_start;
+        UavProfiler::Get().Leave();
+        UavProfiler::Get().Add(m_slot, ticks, m_outermost);
+    }
+
+private:
+    int m_slot;
+    bool m_outermost;
+    uint64_t m_start;
+};
+
+// 统计作用域内写入文本流的字节数（流需提供 GetBytesProduced，见 uav-async-writer.h），
+// 写入了内容即计为一条记录
+template <typename Stream>
+class UavTraceTextScope {
+public:
+    UavTraceTextScope(int slot, const Stream& stream)
+        : m_slot(slot), m_stream(stream), m_start(stream.GetBytesProduced()) {}
+
+    ~UavTraceTextScope() { UavProfiler::Get().AddRecord(m_slot, m_stream.GetBytesProduced() - m_start); }
+
+private:
+    int m_slot;
+    const Stream& m_stream;
+    uint64_t m_start;
+};
+
+// 墙钟时间（秒），用于测量 Simulator::Run 的耗时
+inline double UavWallClock() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#define UAV_PROFILE_CONCAT2(a, b) a##b
+#define UAV_PROFILE_CONCAT(a, b) UAV_PROFILE_CONCAT2(a, b)
+#if UAV_INSTRUMENT
+#define UAV_PROFILE_SCOPE(slot) UavProfileScope UAV_PROFILE_CONCAT(uavProfileScope, __LINE__)(slot)
+#define UAV_TRACE_RECORD(slot, bytes) UavProfiler::Get().AddRecord(slot, bytes)
+#define UAV_TRACE_TEXT(slot, stream) \
+    UavTraceTextScope<std::decay<decltype(stream)>::type> UAV_PROFILE_CONCAT(uavTraceText, __LINE__)(slot, stream)
+#else
+#define UAV_PROFILE_SCOPE(slot)
+#define UAV_TRACE_RECORD(slot, bytes)
+#define UAV_TRACE_TEXT(slot, stream)
+#endif
+
+#endif // UAV_PROFILE_H
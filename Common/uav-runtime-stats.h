@@ -0,0 +1,168 @@
+#ifndef UAV_RUNTIME_STATS_H
+#define UAV_RUNTIME_STATS_H
+
+#include "ns3/event-id.h"
+#include "ns3/map-scheduler.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator.h"
+
+#include "uav-profile.h"
+
+#include <sys/resource.h>
+
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 运行时统计（--stats）
+// UavCountingScheduler 在默认的 MapScheduler 上记录事件队列的当前长度和峰值；
+// UavRuntimeStats 每 --statsInterval 秒（仿真时间）采样一次已执行事件数、墙钟时间和队列长度，
+// 运行结束后把整体吞吐、各回调统计（uav-profile.h）和采样序列写成 run-stats.json，并打印摘要。
+// UAV_INSTRUMENT=0 时不替换调度器、不采样，报告中只有整体结果。
+
+namespace ns3 {
+
+class UavCountingScheduler : public MapScheduler {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::UavCountingScheduler")
+            .SetParent<MapScheduler>()
+            .SetGroupName("Core")
+            .AddConstructor<UavCountingScheduler>();
+        return tid;
+    }
+
+    UavCountingScheduler() { Current() = this; }
+
+    ~UavCountingScheduler() override {
+        if (Current() == this) {
+            Current() = nullptr;
+        }
+    }
+
+    void Insert(const Event& ev) override {
+        MapScheduler::Insert(ev);
+        if (++m_size > m_maxSize) {
+            m_maxSize = m_size;
+        }
+    }
+
+    Event RemoveNext() override {
+        --m_size;
+        return MapScheduler::RemoveNext();
+    }
+
+    void Remove(const Event& ev) override {
+        --m_size;
+        MapScheduler::Remove(ev);
+    }
+
+    uint64_t GetSize() const { return m_size; }
+    uint64_t GetMaxSize() const { return m_maxSize; }
+
+    // 仿真器当前使用的计数调度器，未安装时为 nullptr
+    static UavCountingScheduler*& Current() {
+        static UavCountingScheduler* current = nullptr;
+        return current;
+    }
+
+private:
+    uint64_t m_size = 0;
+    uint64_t m_maxSize = 0;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(UavCountingScheduler);
+
+class UavRuntimeStats {
+public:
+    struct Sample {
+        double time;          // 仿真时间（秒）
+        double wallSeconds;   // 自 Start 起的墙钟时间
+        uint64_t events;      // 已执行事件数
+        uint64_t queueSize;   // 待执行事件数
+    };
+
+    // 在 Simulator::Run 之前调用，interval 为采样周期（仿真时间）
+    void Start(Time interval) {
+#if UAV_INSTRUMENT
+        // 替换调度器时已调度的事件会被搬到新调度器中
+        ObjectFactory factory;
+        factory.SetTypeId(UavCountingScheduler::GetTypeId());
+        Simulator::SetScheduler(factory);
+        m_interval = interval;
+        m_wallStart = UavWallClock();
+        m_samples.clear();
+        m_event = Simulator::Schedule(interval, &UavRuntimeStats::TakeSample, this);
+#endif
+    }
+
+    const std::vector<Sample>& GetSamples() const { return m_samples; }
+
+    // 写出 JSON 报告：wallSeconds 为 Simulator::Run 的墙钟耗时，events 为已执行事件数
+    bool WriteReport(const std::string& path, double simulatedSeconds, double wallSeconds,
+                     uint64_t events, uint32_t numNodes) const {
+        std::ofstream os(path);
+        if (!os) {
+            return false;
+        }
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        UavCountingScheduler* scheduler = UavCountingScheduler::Current();
+        os << std::setprecision(9)
+           << "{\n"
+           << "  \"nodes\": " << numNodes << ",\n"
+           << "  \"simulated_seconds\": " << simulatedSeconds << ",\n"
+           << "  \"wall_seconds\": " << wallSeconds << ",\n"
+           << "  \"events\": " << events << ",\n"
+           << "  \"events_per_second\": " << (wallSeconds > 0 ? events / wallSeconds : 0.0) << ",\n"
+           << "  \"peak_rss_kb\": " << usage.ru_maxrss << ",\n"
+           << "  \"instrumented\": " << (UAV_INSTRUMENT ? "true" : "false") << ",\n"
+           << "  \"max_queue_size\": " << (scheduler ? scheduler->GetMaxSize() : 0) << ",\n"
+           << "  \"callback_seconds\": " << UavProfiler::Get().GetTotalSeconds() << ",\n"
+           << "  \"callbacks\": ";
+        UavProfiler::Get().WriteJson(os, "  ");
+        os << ",\n  \"samples\": [";
+        for (size_t k = 0; k < m_samples.size(); ++k) {
+            const Sample& s = m_samples[k];
+            const Sample* prev = k ? &m_samples[k - 1] : nullptr;
+            double dt = s.wallSeconds - (prev ? prev->wallSeconds : 0.0);
+            uint64_t de = s.events - (prev ? prev->events : 0);
+            os << (k ? ",\n" : "\n") << "    {\"time\": " << s.time << ", \"wall_seconds\": " << s.wallSeconds
+               << ", \"events\": " << s.events << ", \"events_per_second\": " << (dt > 0 ? de / dt : 0.0)
+               << ", \"queue_size\": " << s.queueSize << "}";
+        }
+        os << (m_samples.empty() ? "]\n" : "\n  ]\n") << "}\n";
+        return static_cast<bool>(os);
+    }
+
+    void PrintSummary(std::ostream& os, double wallSeconds, uint64_t events) const {
+        UavCountingScheduler* scheduler = UavCountingScheduler::Current();
+        os << "Run: " << events << " events in " << wallSeconds << " s ("
+           << static_cast<uint64_t>(wallSeconds > 0 ? events / wallSeconds : 0.0) << " events/s)";
+        if (scheduler) {
+            os << ", peak event queue " << scheduler->GetMaxSize();
+        }
+        os << "\n";
+        UavProfiler::Get().PrintSummary(os);
+    }
+
+private:
+    void TakeSample() {
+        UavCountingScheduler* scheduler = UavCountingScheduler::Current();
+        m_samples.push_back(Sample{Simulator::Now().GetSeconds(), UavWallClock() - m_wallStart,
+                                   Simulator::GetEventCount(), scheduler ? scheduler->GetSize() : 0});
+        m_event = Simulator::Schedule(m_interval, &UavRuntimeStats::TakeSample, this);
+    }
+
+    Time m_interval;
+    double m_wallStart = 0.0;
+    std::vector<Sample> m_samples;
+    EventId m_event;
+};
+
+} // namespace ns3
+
+#endif // UAV_RUNTIME_STATS_H
@@ -0,0 +1,189 @@
+#ifndef UAV_SPATIAL_GRID_H
+#define UAV_SPATIAL_GRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// 均匀网格（cell list）空间索引
+// 格子边长不小于通信半径，因此任意一对有效链路节点必然落在同一格或相邻格中，
+// 只需检查 27 个格子即可，邻居检测复杂度约 O(N·k)。
+// 每次拓扑更新时用最新位置重建（计数排序，O(N + 格子数)）。
+class UavSpatialGrid {
+public:
+    // 用节点位置重建索引，positions 元素需有 x/y/z 成员（如 ns3::Vector）
+    template <typename Vec>
+    void Build(const std::vector<Vec>& positions, double cellSize) {
+        uint32_t n = positions.size();
+        m_cellOf.resize(n);
+        m_order.resize(n);
+        if (n == 0) {
+            m_cellStart.assign(1, 0);
+            m_nx = m_ny = m_nz = 0;
+            return;
+        }
+
+        // 包围盒取实际位置范围（节点初始位置可能在移动边界之外）
+        double minX = positions[0].x, maxX = positions[0].x;
+        double minY = positions[0].y, maxY = positions[0].y;
+        double minZ = positions[0].z, maxZ = positions[0].z;
+        for (const Vec& p : positions) {
+            minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+            minZ = std::min(minZ, p.z); maxZ = std::max(maxZ, p.z);
+        }
+
+        // 格子数上限为 4N，节点稀疏时放大格子（只会增加候选，不影响正确性）
+        m_cellSize = cellSize;
+        uint64_t maxCells = 4 * static_cast<uint64_t>(n) + 27;
+        while (true) {
+            m_nx = static_cast<uint32_t>((maxX - minX) / m_cellSize) + 1;
+            m_ny = static_cast<uint32_t>((maxY - minY) / m_cellSize) + 1;
+            m_nz = static_cast<uint32_t>((maxZ - minZ) / m_cellSize) + 1;
+            if (static_cast<uint64_t>(m_nx) * m_ny * m_nz <= maxCells) {
+                break;
+            }
+            m_cellSize *= 2.0;
+        }
+        m_minX = minX;
+        m_minY = minY;
+        m_minZ = minZ;
+
+        // 计数排序：m_order 按格子编号存放节点，m_cellStart 为各格子起始下标
+        uint32_t numCells = m_nx * m_ny * m_nz;
+        m_cellStart.assign(numCells + 1, 0);
+        for (uint32_t i = 0; i < n; ++i) {
+            m_cellOf[i] = CellIndex(CellCoord(positions[i].x, m_minX, m_nx),
+                                    CellCoord(positions[i].y, m_minY, m_ny),
+                                    CellCoord(positions[i].z, m_minZ, m_nz));
+            m_cellStart[m_cellOf[i] + 1]++;
+        }
+        for (uint32_t c = 0; c < numCells; ++c) {
+            m_cellStart[c + 1] += m_cellStart[c];
+        }
+        m_fill.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+        for (uint32_t i = 0; i < n; ++i) {
+            m_order[m_fill[m_cellOf[i]]++] = i;
+        }
+    }
+
+    // 枚举所有可能在通信半径内的无序节点对，保证 i < j 且每对只出现一次。
+    // 精确的距离判断交给调用方，以保证与逐对扫描的判定完全一致。
+    template <typename Fn>
+    void ForEachCandidatePair(Fn fn) const {
+        // 只看“前向”的 13 个相邻格子加本格，避免重复枚举
+        static const int kHalf[13][3] = {
+            {1, 0, 0}, {-1, 1, 0}, {0, 1, 0}, {1, 1, 0},
+            {-1, -1, 1}, {0, -1, 1}, {1, -1, 1},
+            {-1, 0, 1}, {0, 0, 1}, {1, 0, 1},
+            {-1, 1, 1}, {0, 1, 1}, {1, 1, 1}};
+
+        for (uint32_t cz = 0; cz < m_nz; ++cz) {
+            for (uint32_t cy = 0; cy < m_ny; ++cy) {
+                for (uint32_t cx = 0; cx < m_nx; ++cx) {
+                    uint32_t c = CellIndex(cx, cy, cz);
+                    uint32_t begin = m_cellStart[c];
+                    uint32_t end = m_cellStart[c + 1];
+                    if (begin == end) {
+                        continue;
+                    }
+                    // 本格内部
+                    for (uint32_t a = begin; a < end; ++a) {
+                        for (uint32_t b = a + 1; b < end; ++b) {
+                            Emit(fn, m_order[a], m_order[b]);
+                        }
+                    }
+                    // 相邻格子
+                    for (const auto& d : kHalf) {
+                        int64_t nx = static_cast<int64_t>(cx) + d[0];
+                        int64_t ny = static_cast<int64_t>(cy) + d[1];
+                        int64_t nz = static_cast<int64_t>(cz) + d[2];
+                        if (nx < 0 || ny < 0 || nz < 0 ||
+                            nx >= m_nx || ny >= m_ny || nz >= m_nz) {
+                            continue;
+                        }
+                        uint32_t o = CellIndex(nx, ny, nz);
+                        for (uint32_t a = begin; a < end; ++a) {
+                            for (uint32_t b = m_cellStart[o]; b < m_cellStart[o + 1]; ++b) {
+                                Emit(fn, m_order[a], m_order[b]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // 便捷接口：枚举欧氏距离 <= range 的节点对
+    template <typename Vec, typename Fn>
+    void ForEachPairWithin(const std::vector<Vec>& positions, double range, Fn fn) const {
+        ForEachCandidatePair([&](uint32_t i, uint32_t j) {
+            double dx = positions[i].x - positions[j].x;
+            double dy = positions[i].y - positions[j].y;
+            double dz = positions[i].z - positions[j].z;
+            if (std::sqrt(dx * dx + dy * dy + dz * dz) <= range) {
+                fn(i, j);
+            }
+        });
+    }
+
+    // 枚举点 (x, y, z) 所在格及相邻共 27 格内的节点，即距离不超过格子边长的节点的超集
+    template <typename Fn>
+    void ForEachNear(double x, double y, double z, Fn fn) const {
+        if (m_nx == 0) {
+            return;
+        }
+        int64_t cx = CellCoordClamped(x, m_minX, m_nx);
+        int64_t cy = CellCoordClamped(y, m_minY, m_ny);
+        int64_t cz = CellCoordClamped(z, m_minZ, m_nz);
+        for (int64_t nz = std::max<int64_t>(cz - 1, 0); nz <= std::min<int64_t>(cz + 1, m_nz - 1); ++nz) {
+            for (int64_t ny = std::max<int64_t>(cy - 1, 0); ny <= std::min<int64_t>(cy + 1, m_ny - 1); ++ny) {
+                for (int64_t nx = std::max<int64_t>(cx - 1, 0); nx <= std::min<int64_t>(cx + 1, m_nx - 1); ++nx) {
+                    uint32_t o = CellIndex(nx, ny, nz);
+                    for (uint32_t b = m_cellStart[o]; b < m_cellStart[o + 1]; ++b) {
+                        fn(m_order[b]);
+                    }
+                }
+            }
+        }
+    }
+
+    double GetCellSize() const { return m_cellSize; }
+    uint32_t GetNumCells() const { return m_nx * m_ny * m_nz; }
+
+private:
+    uint32_t CellCoord(double v, double min, uint32_t count) const {
+        uint32_t c = static_cast<uint32_t>((v - min) / m_cellSize);
+        return std::min(c, count - 1);
+    }
+
+    // 点可能落在建格时的包围盒之外：格坐标允许取 -1 或 count，邻域与网格求交后再枚举
+    int64_t CellCoordClamped(double v, double min, uint32_t count) const {
+        double c = std::floor((v - min) / m_cellSize);
+        return static_cast<int64_t>(std::max(-1.0, std::min(c, static_cast<double>(count))));
+    }
+
+    uint32_t CellIndex(uint32_t cx, uint32_t cy, uint32_t cz) const {
+        return (cz * m_ny + cy) * m_nx + cx;
+    }
+
+    template <typename Fn>
+    static void Emit(Fn& fn, uint32_t a, uint32_t b) {
+        if (a < b) {
+            fn(a, b);
+        } else {
+            fn(b, a);
+        }
+    }
+
+    double m_cellSize = 1.0;
+    double m_minX = 0.0, m_minY = 0.0, m_minZ = 0.0;
+    uint32_t m_nx = 0, m_ny = 0, m_nz = 0;
+    std::vector<uint32_t> m_cellStart;  // 每个格子在 m_order 中的起始下标（长度 格子数+1）
+    std::vector<uint32_t> m_order;      // 按格子排序后的节点编号
+    std::vector<uint32_t> m_cellOf;     // 节点所在格子
+    std::vector<uint32_t> m_fill;       // 计数排序临时游标
+};
+
+#endif // UAV_SPATIAL_GRID_H
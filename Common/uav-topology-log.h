@@ -0,0 +1,383 @@
+#ifndef UAV_TOPOLOGY_LOG_H
+#define UAV_TOPOLOGY_LOG_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "uav-async-writer.h"
+
+// 增量拓扑日志
+// 文件 = 32 字节文件头 + 若干数据块 + 关键帧索引 + 16 字节文件尾，小端序。
+// 数据块 = {double 时间, uint32 类型, uint32 边数} + 边数 × {uint32 i, uint32 j}（i < j）：
+//   KEYFRAME  当前完整链路集合（第一块总是关键帧，之后每隔 keyframeInterval 秒一块）
+//   ADD       自上一块以来新增的链路
+//   REMOVE    自上一块以来断开的链路
+// 链路不变时不写任何数据，输出量与变化次数成正比而不是与 时长 × 链路数 成正比。
+// 读取端按索引二分找到 t 之前最近的关键帧，只回放其后的增量即可得到 t 时刻的邻接关系；
+// 没有正常关闭（缺少索引）的文件退化为顺序扫描块头建立索引。
+
+enum UavTopologyBlockType : uint32_t {
+    UAV_TOPOLOGY_KEYFRAME = 0,
+    UAV_TOPOLOGY_ADD = 1,
+    UAV_TOPOLOGY_REMOVE = 2
+};
+
+const char UAV_TOPOLOGY_MAGIC[8] = {'U', 'A', 'V', 'T', 'O', 'P', 'O', 'L'};
+const char UAV_TOPOLOGY_INDEX_MAGIC[8] = {'U', 'A', 'V', 'T', 'I', 'D', 'X', '1'};
+const uint32_t UAV_TOPOLOGY_VERSION = 1;
+
+struct UavTopologyFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numNodes;
+    double keyframeInterval;
+    uint32_t scenario;   // 与 UavTraceScenario 相同的场景编号，决定转换回文本时的格式
+    uint32_t reserved;
+};
+
+struct UavTopologyBlockHeader {
+    double time;
+    uint32_t type;     // UavTopologyBlockType
+    uint32_t count;    // 边数
+};
+
+struct UavTopologyIndexEntry {
+    double time;
+    uint64_t offset;   // 关键帧块在文件中的偏移
+};
+
+struct UavTopologyFileTrailer {
+    uint64_t indexOffset;
+    char magic[8];
+};
+
+static_assert(sizeof(UavTopologyFileHeader) == 32, "topology header must be 32 bytes");
+static_assert(sizeof(UavTopologyBlockHeader) == 16, "topology block header must be 16 bytes");
+static_assert(sizeof(UavTopologyIndexEntry) == 16, "topology index entry must be 16 bytes");
+static_assert(sizeof(UavTopologyFileTrailer) == 16, "topology trailer must be 16 bytes");
+static_assert(sizeof(std::pair<uint32_t, uint32_t>) == 8, "edges are stored as two uint32");
+
+class UavTopologyLogWriter {
+public:
+    typedef std::pair<uint32_t, uint32_t> Edge;
+
+    ~UavTopologyLogWriter() { Close(); }
+
+    bool Open(const std::string& path, uint32_t numNodes, uint32_t scenario, double keyframeInterval = 30.0,
+              const UavAsyncOptions& options = UavAsyncOptions()) {
+        Close();
+        // 丢掉任何一块都会让之后的重建出错，缓冲满时总是等待写盘
+        UavAsyncOptions writerOptions = options;
+        writerOptions.policy = UAV_BACKPRESSURE_BLOCK;
+        if (!m_writer.Open(path, writerOptions)) {
+            return false;
+        }
+        UavTopologyFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, UAV_TOPOLOGY_MAGIC, sizeof(header.magic));
+        header.version = UAV_TOPOLOGY_VERSION;
+        header.numNodes = numNodes;
+        header.keyframeInterval = keyframeInterval;
+        header.scenario = scenario;
+        m_offset = 0;
+        Append(&header, sizeof(header));
+        m_keyframeInterval = keyframeInterval;
+        m_current.clear();
+        m_index.clear();
+        m_lastKeyframe = 0.0;
+        return true;
+    }
+
+    bool IsOpen() const { return m_writer.IsOpen(); }
+
+    // 传入 time 时刻完整的链路集合（任意顺序、i/j 任意先后），写出与上一次的差异
+    void Update(double time, const std::vector<Edge>& links) {
+        m_next.clear();
+        for (const Edge& e : links) {
+            m_next.push_back(Key(e.first, e.second));
+        }
+        std::sort(m_next.begin(), m_next.end());
+        m_next.erase(std::unique(m_next.begin(), m_next.end()), m_next.end());
+
+        if (!m_index.empty() && time - m_lastKeyframe < m_keyframeInterval) {
+            m_added.clear();
+            m_removed.clear();
+            std::set_difference(m_next.begin(), m_next.end(), m_current.begin(), m_current.end(),
+                                std::back_inserter(m_added));
+            std::set_difference(m_current.begin(), m_current.end(), m_next.begin(), m_next.end(),
+                                std::back_inserter(m_removed));
+            WriteBlock(time, UAV_TOPOLOGY_ADD, m_added);
+            WriteBlock(time, UAV_TOPOLOGY_REMOVE, m_removed);
+            m_current.swap(m_next);
+        } else {
+            m_current.swap(m_next);
+            WriteKeyframe(time);
+        }
+    }
+
+    // 单条链路变化（事件驱动的拓扑源）
+    void AddLink(double time, uint32_t i, uint32_t j) { Change(time, i, j, true); }
+    void RemoveLink(double time, uint32_t i, uint32_t j) { Change(time, i, j, false); }
+
+    void Close() {
+        if (!m_writer.IsOpen()) {
+            return;
+        }
+        UavTopologyFileTrailer trailer;
+        trailer.indexOffset = m_offset;
+        std::memcpy(trailer.magic, UAV_TOPOLOGY_INDEX_MAGIC, sizeof(trailer.magic));
+        if (!m_index.empty()) {
+            Append(m_index.data(), m_index.size() * sizeof(UavTopologyIndexEntry));
+        }
+        Append(&trailer, sizeof(trailer));
+        m_writer.Close();
+    }
+
+    uint64_t GetBytesWritten() const { return m_offset; }
+    const UavAsyncFileWriter& GetWriter() const { return m_writer; }
+
+private:
+    static uint64_t Key(uint32_t i, uint32_t j) {
+        return i < j ? (uint64_t(i) << 32 | j) : (uint64_t(j) << 32 | i);
+    }
+
+    void Change(double time, uint32_t i, uint32_t j, bool up) {
+        uint64_t key = Key(i, j);
+        auto it = std::lower_bound(m_current.begin(), m_current.end(), key);
+        bool present = it != m_current.end() && *it == key;
+        if (present == up) {
+            return;
+        }
+        if (up) {
+            m_current.insert(it, key);
+        } else {
+            m_current.erase(it);
+        }
+        if (m_index.empty() || time - m_lastKeyframe >= m_keyframeInterval) {
+            WriteKeyframe(time);
+        } else {
+            m_added.assign(1, key);
+            WriteBlock(time, up ? UAV_TOPOLOGY_ADD : UAV_TOPOLOGY_REMOVE, m_added);
+        }
+    }
+
+    void WriteKeyframe(double time) {
+        m_index.push_back(UavTopologyIndexEntry{time, m_offset});
+        m_lastKeyframe = time;
+        WriteBlock(time, UAV_TOPOLOGY_KEYFRAME, m_current, true);
+    }
+
+    void WriteBlock(double time, uint32_t type, const std::vector<uint64_t>& keys, bool always = false) {
+        if (keys.empty() && !always) {
+            return;
+        }
+        UavTopologyBlockHeader block{time, type, static_cast<uint32_t>(keys.size())};
+        m_block.resize(2 * keys.size());
+        for (size_t k = 0; k < keys.size(); ++k) {
+            m_block[2 * k] = static_cast<uint32_t>(keys[k] >> 32);
+            m_block[2 * k + 1] = static_cast<uint32_t>(keys[k]);
+        }
+        Append(&block, sizeof(block));
+        if (!m_block.empty()) {
+            Append(m_block.data(), m_block.size() * sizeof(uint32_t));
+        }
+    }
+
+    void Append(const void* data, size_t n) {
+        m_writer.Write(data, n);
+        m_offset += n;
+    }
+
+    UavAsyncFileWriter m_writer;
+    uint64_t m_offset = 0;
+    double m_keyframeInterval = 30.0;
+    double m_lastKeyframe = 0.0;
+    std::vector<uint64_t> m_current;   // 当前链路，按 (i << 32 | j) 升序
+    std::vector<uint64_t> m_next, m_added, m_removed;
+    std::vector<uint32_t> m_block;     // 待写出的边数据
+    std::vector<UavTopologyIndexEntry> m_index;
+};
+
+class UavTopologyLogReader {
+public:
+    typedef std::pair<uint32_t, uint32_t> Edge;
+
+    ~UavTopologyLogReader() { Close(); }
+
+    bool Open(const std::string& path, std::string* error = nullptr) {
+        Close();
+        m_file = std::fopen(path.c_str(), "rb");
+        if (!m_file) {
+            return Fail(error, "cannot open " + path);
+        }
+        if (std::fread(&m_header, sizeof(m_header), 1, m_file) != 1 ||
+            std::memcmp(m_header.magic, UAV_TOPOLOGY_MAGIC, sizeof(m_header.magic)) != 0) {
+            return Fail(error, path + " is not a topology log");
+        }
+        if (m_header.version != UAV_TOPOLOGY_VERSION) {
+            return Fail(error, "unsupported topology log version " + std::to_string(m_header.version));
+        }
+        if (!ReadIndex()) {
+            ScanIndex();
+        }
+        return true;
+    }
+
+    void Close() {
+        if (m_file) {
+            std::fclose(m_file);
+            m_file = nullptr;
+        }
+        m_index.clear();
+    }
+
+    const UavTopologyFileHeader& GetHeader() const { return m_header; }
+    uint32_t GetNumNodes() const { return m_header.numNodes; }
+    size_t GetNumKeyframes() const { return m_index.size(); }
+    double GetStartTime() const { return m_index.empty() ? 0.0 : m_index.front().time; }
+
+    // t 时刻的链路集合（i < j，升序）；t 早于第一块时返回空集合
+    bool GetLinksAt(double t, std::vector<Edge>& links) {
+        links.clear();
+        m_keys.clear();
+        if (m_index.empty() || t < m_index.front().time) {
+            return true;
+        }
+        // 最后一个时间 <= t 的关键帧
+        auto it = std::upper_bound(m_index.begin(), m_index.end(), t,
+            [](double value, const UavTopologyIndexEntry& e) { return value < e.time; });
+        --it;
+        if (fseeko(m_file, static_cast<off_t>(it->offset), SEEK_SET) != 0) {
+            return false;
+        }
+        UavTopologyBlockHeader block;
+        while (ReadBlock(block)) {
+            if (block.time > t) {
+                break;
+            }
+            ApplyBlock(block);
+        }
+        for (uint64_t key : m_keys) {
+            links.emplace_back(static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key));
+        }
+        return true;
+    }
+
+    // 顺序回放：每读到一块调用 fn(block, edges)
+    template <typename Fn>
+    bool ForEachBlock(Fn fn) {
+        if (fseeko(m_file, sizeof(UavTopologyFileHeader), SEEK_SET) != 0) {
+            return false;
+        }
+        UavTopologyBlockHeader block;
+        while (ReadBlock(block)) {
+            fn(block, m_edges);
+        }
+        return true;
+    }
+
+private:
+    static bool Fail(std::string* error, const std::string& message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    }
+
+    // 数据区结束位置：有索引时为索引起点，否则为文件末尾
+    bool ReadBlock(UavTopologyBlockHeader& block) {
+        off_t pos = ftello(m_file);
+        if (pos < 0 || static_cast<uint64_t>(pos) + sizeof(block) > m_dataEnd ||
+            std::fread(&block, sizeof(block), 1, m_file) != 1) {
+            return false;
+        }
+        m_edges.resize(block.count);
+        if (block.count > 0 &&
+            std::fread(m_edges.data(), sizeof(Edge), block.count, m_file) != block.count) {
+            return false;
+        }
+        return true;
+    }
+
+    void ApplyBlock(const UavTopologyBlockHeader& block) {
+        m_delta.clear();
+        for (const Edge& e : m_edges) {
+            m_delta.push_back(uint64_t(e.first) << 32 | e.second);
+        }
+        m_merged.clear();
+        if (block.type == UAV_TOPOLOGY_KEYFRAME) {
+            m_keys.swap(m_delta);
+            return;
+        }
+        if (block.type == UAV_TOPOLOGY_ADD) {
+            std::set_union(m_keys.begin(), m_keys.end(), m_delta.begin(), m_delta.end(),
+                           std::back_inserter(m_merged));
+        } else {
+            std::set_difference(m_keys.begin(), m_keys.end(), m_delta.begin(), m_delta.end(),
+                                std::back_inserter(m_merged));
+        }
+        m_keys.swap(m_merged);
+    }
+
+    bool ReadIndex() {
+        UavTopologyFileTrailer trailer;
+        if (fseeko(m_file, -static_cast<off_t>(sizeof(trailer)), SEEK_END) != 0 ||
+            std::fread(&trailer, sizeof(trailer), 1, m_file) != 1 ||
+            std::memcmp(trailer.magic, UAV_TOPOLOGY_INDEX_MAGIC, sizeof(trailer.magic)) != 0) {
+            return false;
+        }
+        off_t end = ftello(m_file) - static_cast<off_t>(sizeof(trailer));
+        if (trailer.indexOffset > static_cast<uint64_t>(end) ||
+            (end - trailer.indexOffset) % sizeof(UavTopologyIndexEntry) != 0) {
+            return false;
+        }
+        m_index.resize((end - trailer.indexOffset) / sizeof(UavTopologyIndexEntry));
+        if (fseeko(m_file, static_cast<off_t>(trailer.indexOffset), SEEK_SET) != 0 ||
+            (!m_index.empty() &&
+             std::fread(m_index.data(), sizeof(UavTopologyIndexEntry), m_index.size(), m_file) != m_index.size())) {
+            m_index.clear();
+            return false;
+        }
+        m_dataEnd = trailer.indexOffset;
+        return true;
+    }
+
+    // 没有索引（仿真异常退出）：顺序扫描块头，跳过边数据
+    void ScanIndex() {
+        m_index.clear();
+        fseeko(m_file, 0, SEEK_END);
+        m_dataEnd = static_cast<uint64_t>(ftello(m_file));
+        uint64_t offset = sizeof(UavTopologyFileHeader);
+        UavTopologyBlockHeader block;
+        while (offset + sizeof(block) <= m_dataEnd &&
+               fseeko(m_file, static_cast<off_t>(offset), SEEK_SET) == 0 &&
+               std::fread(&block, sizeof(block), 1, m_file) == 1) {
+            uint64_t next = offset + sizeof(block) + uint64_t(block.count) * sizeof(Edge);
+            if (next > m_dataEnd) {
+                break;  // 最后一块不完整
+            }
+            if (block.type == UAV_TOPOLOGY_KEYFRAME) {
+                m_index.push_back(UavTopologyIndexEntry{block.time, offset});
+            }
+            offset = next;
+        }
+        m_dataEnd = offset;
+    }
+
+    std::FILE* m_file = nullptr;
+    UavTopologyFileHeader m_header;
+    uint64_t m_dataEnd = 0;
+    std::vector<UavTopologyIndexEntry> m_index;
+    std::vector<Edge> m_edges;               // 当前块的边
+    std::vector<uint64_t> m_keys, m_delta, m_merged;
+};
+
+#endif // UAV_TOPOLOGY_LOG_H
@@ -0,0 +1,220 @@
+#ifndef UAV_TRACE_FILTER_H
+#define UAV_TRACE_FILTER_H
+
+#include "uav-binary-trace.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+// 传输记录过滤（--traceFilter）
+// 过滤条件在启动时解析成一个紧凑的判定：节点位图、事件类型掩码、时间区间和确定性哈希抽样，
+// 回调在查位置、解析包头和格式化之前先判定，被滤掉的事件只花几条指令。
+// 条件写成以 ';' 分隔的 key=value，全部满足才记录：
+//   nodes=0-4,7        节点编号或闭区间
+//   events=tx-data,rx-data
+//                      事件名取 UavTraceEventName 的小写，空格和下划线换成 '-'：
+//                      tx, data, ack, ack-received, tx-data, tx-ack, rx-data, rx-ack
+//   time=10-50         记录 [10, 50) 秒内的事件，任一端可省略（"10-"、"-50"）
+//   sample=N           每 N 条约保留 1 条；按 (时间, 节点) 哈希，同一仿真重跑时选中的记录相同
+// 只影响传输记录，拓扑推断等其他统计照常使用全部事件。
+
+class UavTraceFilter {
+public:
+    // 解析过滤条件；空串表示不过滤
+    bool Parse(const std::string& spec, std::string* error = nullptr) {
+        *this = UavTraceFilter();
+        size_t pos = 0;
+        while (pos < spec.size()) {
+            size_t end = spec.find(';', pos);
+            if (end == std::string::npos) {
+                end = spec.size();
+            }
+            std::string item = spec.substr(pos, end - pos);
+            pos = end + 1;
+            if (item.empty()) {
+                continue;
+            }
+            size_t eq = item.find('=');
+            std::string key = item.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : item.substr(eq + 1);
+            bool ok;
+            if (key == "nodes") {
+                ok = ParseNodes(value);
+            } else if (key == "events") {
+                ok = ParseEvents(value);
+            } else if (key == "time") {
+                ok = ParseTime(value);
+            } else if (key == "sample") {
+                ok = ParseSample(value);
+            } else {
+                return Fail(error, "unknown trace filter key: " + key);
+            }
+            if (!ok) {
+                return Fail(error, "invalid trace filter: " + item);
+            }
+            m_active = true;
+        }
+        return true;
+    }
+
+    bool IsActive() const { return m_active; }
+
+    // 节点、时间和抽样，不需要事件类型，可在解析包头之前判定
+    bool AcceptNode(double time, uint32_t node) const {
+        if (!m_active) {
+            return true;
+        }
+        if (time < m_start || time >= m_stop) {
+            return false;
+        }
+        if (m_nodeFilter && (node >= m_nodes.size() * 64 || !((m_nodes[node >> 6] >> (node & 63)) & 1))) {
+            return false;
+        }
+        return m_sampleThreshold == KEEP_ALL || Hash(time, node) < m_sampleThreshold;
+    }
+
+    bool AcceptEvent(UavTraceEvent event) const { return (m_eventMask >> event) & 1; }
+
+    bool Accept(double time, uint32_t node, UavTraceEvent event) const {
+        return AcceptEvent(event) && AcceptNode(time, node);
+    }
+
+    // 事件名（见文件头）对应的类型，未知时返回 UAV_EVENT_COUNT
+    static UavTraceEvent ParseEventName(const std::string& name) {
+        for (uint16_t e = 0; e < UAV_EVENT_COUNT; ++e) {
+            std::string canonical = UavTraceEventName(e);
+            for (char& c : canonical) {
+                c = (c == ' ' || c == '_') ? '-' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            if (canonical == name) {
+                return static_cast<UavTraceEvent>(e);
+            }
+        }
+        return UAV_EVENT_COUNT;
+    }
+
+private:
+    static const uint64_t KEEP_ALL = std::numeric_limits<uint64_t>::max();
+    static const uint64_t MAX_NODES = uint64_t(1) << 24;   // 位图上限 2 MiB
+
+    // splitmix64 混合时间的位模式和节点编号
+    static uint64_t Hash(double time, uint32_t node) {
+        uint64_t x;
+        std::memcpy(&x, &time, sizeof(x));
+        x ^= (static_cast<uint64_t>(node) + 1) * 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    static bool ParseUint(const std::string& text, uint64_t& value) {
+        if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+        value = std::strtoull(text.c_str(), nullptr, 10);
+        return true;
+    }
+
+    static bool ParseDouble(const std::string& text, double& value) {
+        char* end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        return !text.empty() && end == text.c_str() + text.size();
+    }
+
+    // 逗号分隔的列表，逐项交给 fn
+    template <typename Fn>
+    static bool ForEachItem(const std::string& list, Fn fn) {
+        size_t pos = 0;
+        do {
+            size_t end = list.find(',', pos);
+            if (end == std::string::npos) {
+                end = list.size();
+            }
+            if (!fn(list.substr(pos, end - pos))) {
+                return false;
+            }
+            pos = end + 1;
+        } while (pos <= list.size());
+        return true;
+    }
+
+    bool ParseNodes(const std::string& value) {
+        m_nodeFilter = true;
+        return ForEachItem(value, [this](const std::string& item) {
+            size_t dash = item.find('-');
+            uint64_t first, last;
+            if (!ParseUint(item.substr(0, dash), first)) {
+                return false;
+            }
+            last = first;
+            if (dash != std::string::npos && !ParseUint(item.substr(dash + 1), last)) {
+                return false;
+            }
+            if (last < first || last >= MAX_NODES) {
+                return false;
+            }
+            if (m_nodes.size() * 64 <= last) {
+                m_nodes.resize(last / 64 + 1, 0);
+            }
+            for (uint64_t n = first; n <= last; ++n) {
+                m_nodes[n >> 6] |= uint64_t(1) << (n & 63);
+            }
+            return true;
+        });
+    }
+
+    bool ParseEvents(const std::string& value) {
+        m_eventMask = 0;
+        return ForEachItem(value, [this](const std::string& item) {
+            UavTraceEvent event = ParseEventName(item);
+            if (event == UAV_EVENT_COUNT) {
+                return false;
+            }
+            m_eventMask |= uint32_t(1) << event;
+            return true;
+        });
+    }
+
+    bool ParseTime(const std::string& value) {
+        size_t dash = value.find('-');
+        if (dash == std::string::npos) {
+            return false;
+        }
+        std::string start = value.substr(0, dash), stop = value.substr(dash + 1);
+        if ((!start.empty() && !ParseDouble(start, m_start)) || (!stop.empty() && !ParseDouble(stop, m_stop))) {
+            return false;
+        }
+        return m_start < m_stop;
+    }
+
+    bool ParseSample(const std::string& value) {
+        uint64_t n;
+        if (!ParseUint(value, n) || n == 0) {
+            return false;
+        }
+        m_sampleThreshold = n == 1 ? KEEP_ALL : KEEP_ALL / n;
+        return true;
+    }
+
+    static bool Fail(std::string* error, const std::string& message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    }
+
+    bool m_active = false;
+    bool m_nodeFilter = false;
+    uint32_t m_eventMask = ~0u;
+    double m_start = -std::numeric_limits<double>::infinity();
+    double m_stop = std::numeric_limits<double>::infinity();
+    uint64_t m_sampleThreshold = KEEP_ALL;
+    std::vector<uint64_t> m_nodes;     // 节点位图，m_nodeFilter 为 true 时有效
+};
+
+#endif // UAV_TRACE_FILTER_H
@@ -0,0 +1,63 @@
+#ifndef UAV_TRACE_HOOKUP_H
+#define UAV_TRACE_HOOKUP_H
+
+#include "ns3/callback.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/wifi-mac.h"
+#include "ns3/wifi-net-device.h"
+
+// 逐节点挂接 trace 回调
+// 用 TraceConnectWithoutContext + MakeBoundCallback 把节点号直接绑定进回调，
+// 替代通配路径的 Config::Connect，回调里无需再从 "/NodeList/N/..." 字符串解析节点号。
+
+namespace ns3 {
+
+// MAC 层发送回调：nodeId 已绑定
+typedef void (*UavMacTxTrace)(uint32_t nodeId, Ptr<const Packet> packet);
+
+// IPv4 层收发回调：nodeId 与方向（true 为 Tx）已绑定
+typedef void (*UavIpv4Trace)(uint32_t nodeId, bool isTx, Ptr<const Packet> packet,
+                             Ptr<Ipv4> ipv4, uint32_t interface);
+
+// 为 nodes 中每个设备挂接 MacTx，返回成功挂接的设备数
+// Wi-Fi 设备挂在 WifiMac 上；其他设备（UavLinkNetDevice、CSMA、点对点等）挂在设备自身的 MacTx 上，
+// 没有 MacTx 的设备（如回环）跳过。
+inline uint32_t UavConnectMacTx(const NodeContainer& nodes, UavMacTxTrace trace) {
+    uint32_t connected = 0;
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+        Ptr<Node> node = *it;
+        for (uint32_t d = 0; d < node->GetNDevices(); ++d) {
+            Ptr<NetDevice> device = node->GetDevice(d);
+            Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice>(device);
+            Ptr<Object> source = wifi ? Ptr<Object>(wifi->GetMac()) : Ptr<Object>(device);
+            if (source->TraceConnectWithoutContext("MacTx", MakeBoundCallback(trace, node->GetId()))) {
+                ++connected;
+            }
+        }
+    }
+    return connected;
+}
+
+// 为 nodes 中每个节点的 Ipv4L3Protocol 挂接 Tx/Rx，返回成功挂接的节点数
+inline uint32_t UavConnectIpv4TxRx(const NodeContainer& nodes, UavIpv4Trace trace) {
+    uint32_t connected = 0;
+    for (auto it = nodes.Begin(); it != nodes.End(); ++it) {
+        Ptr<Node> node = *it;
+        Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
+        if (!ipv4) {
+            continue;
+        }
+        bool tx = ipv4->TraceConnectWithoutContext("Tx", MakeBoundCallback(trace, node->GetId(), true));
+        bool rx = ipv4->TraceConnectWithoutContext("Rx", MakeBoundCallback(trace, node->GetId(), false));
+        if (tx && rx) {
+            ++connected;
+        }
+    }
+    return connected;
+}
+
+} // namespace ns3
+
+#endif // UAV_TRACE_HOOKUP_H
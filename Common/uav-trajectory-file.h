@@ -0,0 +1,204 @@
+#ifndef UAV_TRAJECTORY_FILE_H
+#define UAV_TRAJECTORY_FILE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 预生成的轨迹文件
+// 文件 = 48 字节文件头 + numSamples × numNodes 个采样，小端序，按 [采样][节点] 排列。
+// 每个采样为 t_k = startTime + k * step 时刻的位置和速度。
+// GaussMarkov 只在 TimeStep 的整数倍更新速度，其间匀速直线运动，
+// 因此 step 取 TimeStep（或其约数）时按 p_k + v_k (t - t_k) 回放即可精确还原轨迹。
+// 读取端 mmap 整个文件，按 t 直接算出采样下标，每次查询 O(1)；
+// 多个进程回放同一文件时共享页缓存。
+
+const char UAV_TRAJECTORY_MAGIC[8] = {'U', 'A', 'V', 'T', 'R', 'A', 'J', '1'};
+const uint32_t UAV_TRAJECTORY_VERSION = 1;
+
+struct UavTrajectoryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numNodes;
+    uint32_t numSamples;
+    uint32_t scenario;     // 与 UavTraceScenario 相同的场景编号
+    double startTime;
+    double step;
+    uint64_t reserved;
+};
+
+struct UavTrajectorySample {
+    double x, y, z;
+    double vx, vy, vz;
+};
+
+static_assert(sizeof(UavTrajectoryHeader) == 48, "trajectory header must be 48 bytes");
+static_assert(sizeof(UavTrajectorySample) == 48, "trajectory sample must be 48 bytes");
+
+// 逐行（一个采样时刻的所有节点）追加写入，关闭时回填采样数
+class UavTrajectoryWriter {
+public:
+    ~UavTrajectoryWriter() { Close(); }
+
+    bool Open(const std::string& path, uint32_t numNodes, double startTime, double step, uint32_t scenario) {
+        Close();
+        m_file = std::fopen(path.c_str(), "wb");
+        if (!m_file) {
+            return false;
+        }
+        std::memset(&m_header, 0, sizeof(m_header));
+        std::memcpy(m_header.magic, UAV_TRAJECTORY_MAGIC, sizeof(m_header.magic));
+        m_header.version = UAV_TRAJECTORY_VERSION;
+        m_header.numNodes = numNodes;
+        m_header.scenario = scenario;
+        m_header.startTime = startTime;
+        m_header.step = step;
+        return std::fwrite(&m_header, sizeof(m_header), 1, m_file) == 1;
+    }
+
+    bool IsOpen() const { return m_file != nullptr; }
+
+    // row 为 numNodes 个节点在下一个采样时刻的状态
+    bool Append(const std::vector<UavTrajectorySample>& row) {
+        if (!m_file || row.size() != m_header.numNodes) {
+            return false;
+        }
+        if (std::fwrite(row.data(), sizeof(UavTrajectorySample), row.size(), m_file) != row.size()) {
+            return false;
+        }
+        ++m_header.numSamples;
+        return true;
+    }
+
+    void Close() {
+        if (!m_file) {
+            return;
+        }
+        std::fseek(m_file, 0, SEEK_SET);
+        std::fwrite(&m_header, sizeof(m_header), 1, m_file);
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+
+    uint32_t GetNumSamples() const { return m_header.numSamples; }
+
+private:
+    std::FILE* m_file = nullptr;
+    UavTrajectoryHeader m_header;
+};
+
+class UavTrajectoryFile {
+public:
+    ~UavTrajectoryFile() { Close(); }
+
+    bool Open(const std::string& path, std::string* error = nullptr) {
+        Close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return Fail(error, "cannot open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(UavTrajectoryHeader)) {
+            ::close(fd);
+            return Fail(error, path + " is not a trajectory file");
+        }
+        void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            return Fail(error, "cannot map " + path);
+        }
+        m_data = data;
+        m_size = st.st_size;
+        m_header = static_cast<const UavTrajectoryHeader*>(m_data);
+        if (std::memcmp(m_header->magic, UAV_TRAJECTORY_MAGIC, sizeof(m_header->magic)) != 0) {
+            return Fail(error, path + " is not a trajectory file");
+        }
+        if (m_header->version != UAV_TRAJECTORY_VERSION) {
+            return Fail(error, "unsupported trajectory version " + std::to_string(m_header->version));
+        }
+        if (m_header->numNodes == 0 || !(m_header->step > 0.0)) {
+            return Fail(error, path + " has no nodes or no time step");
+        }
+        // 未正常关闭的文件：采样数按实际完整的行数计算
+        uint64_t rowBytes = static_cast<uint64_t>(m_header->numNodes) * sizeof(UavTrajectorySample);
+        uint64_t rows = (m_size - sizeof(UavTrajectoryHeader)) / rowBytes;
+        m_numSamples = static_cast<uint32_t>(m_header->numSamples ? std::min<uint64_t>(rows, m_header->numSamples) : rows);
+        if (m_numSamples == 0) {
+            return Fail(error, path + " has no samples");
+        }
+        m_samples = reinterpret_cast<const UavTrajectorySample*>(static_cast<const char*>(m_data) + sizeof(UavTrajectoryHeader));
+        ::madvise(m_data, m_size, MADV_WILLNEED);
+        return true;
+    }
+
+    void Close() {
+        if (m_data) {
+            ::munmap(m_data, m_size);
+            m_data = nullptr;
+        }
+        m_header = nullptr;
+        m_samples = nullptr;
+        m_numSamples = 0;
+    }
+
+    bool IsOpen() const { return m_samples != nullptr; }
+    const UavTrajectoryHeader& GetHeader() const { return *m_header; }
+    uint32_t GetNumNodes() const { return m_header->numNodes; }
+    uint32_t GetNumSamples() const { return m_numSamples; }
+    double GetStartTime() const { return m_header->startTime; }
+    double GetStep() const { return m_header->step; }
+    // 最后一个采样的时刻，之后按最后的速度外推
+    double GetEndTime() const { return m_header->startTime + (m_numSamples - 1) * m_header->step; }
+
+    // t 所在采样区间的下标，超出范围时取首/尾采样
+    uint32_t SampleIndex(double t) const {
+        double k = std::floor((t - m_header->startTime) / m_header->step);
+        if (!(k > 0.0)) {
+            return 0;
+        }
+        return k >= m_numSamples - 1 ? m_numSamples - 1 : static_cast<uint32_t>(k);
+    }
+
+    const UavTrajectorySample& GetSample(uint32_t k, uint32_t node) const {
+        return m_samples[static_cast<size_t>(k) * m_header->numNodes + node];
+    }
+
+    // node 在 t 时刻的位置与速度
+    void GetState(uint32_t node, double t, double position[3], double velocity[3]) const {
+        uint32_t k = SampleIndex(t);
+        const UavTrajectorySample& s = GetSample(k, node);
+        double dt = t - (m_header->startTime + k * m_header->step);
+        position[0] = s.x + s.vx * dt;
+        position[1] = s.y + s.vy * dt;
+        position[2] = s.z + s.vz * dt;
+        velocity[0] = s.vx;
+        velocity[1] = s.vy;
+        velocity[2] = s.vz;
+    }
+
+private:
+    bool Fail(std::string* error, const std::string& message) {
+        Close();
+        if (error) {
+            *error = message;
+        }
+        return false;
+    }
+
+    void* m_data = nullptr;
+    size_t m_size = 0;
+    const UavTrajectoryHeader* m_header = nullptr;
+    const UavTrajectorySample* m_samples = nullptr;
+    uint32_t m_numSamples = 0;
+};
+
+#endif // UAV_TRAJECTORY_FILE_H
@@ -0,0 +1,166 @@
+#ifndef UAV_TRAJECTORY_MOBILITY_H
+#define UAV_TRAJECTORY_MOBILITY_H
+
+#include "ns3/abort.h"
+#include "ns3/event-id.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/vector.h"
+
+#include "uav-trajectory-file.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// 轨迹录制与回放（--recordTrajectory / --replayTrajectory）
+// 录制：从 0 时刻起每 step 秒采样一次所有节点的位置和速度写入轨迹文件。
+//   采样事件在节点初始化之后调度，同一时刻总是排在 GaussMarkov 的速度更新之后，
+//   记录的是更新后的速度。
+// 回放：UavTrajectoryMobilityModel 替代 GaussMarkovMobilityModel，位置由共享的
+//   mmap 文件按时间直接查出；在每个采样时刻触发 CourseChange，依赖速度变化通知的
+//   组件（如 kinetic 拓扑）照常工作。回放不消耗随机数，其余组件的随机流编号会与录制时不同。
+
+namespace ns3 {
+
+class UavTrajectoryMobilityModel : public MobilityModel {
+public:
+    static TypeId GetTypeId() {
+        static TypeId tid = TypeId("ns3::UavTrajectoryMobilityModel")
+            .SetParent<MobilityModel>()
+            .SetGroupName("Mobility")
+            .AddConstructor<UavTrajectoryMobilityModel>();
+        return tid;
+    }
+
+    void SetTrajectory(std::shared_ptr<const UavTrajectoryFile> file, uint32_t index) {
+        m_file = file;
+        m_index = index;
+    }
+
+private:
+    void DoInitialize() override {
+        ScheduleCourseChange();
+        MobilityModel::DoInitialize();
+    }
+
+    void DoDispose() override {
+        Simulator::Cancel(m_event);
+        m_file.reset();
+        MobilityModel::DoDispose();
+    }
+
+    // 在下一个采样时刻通知速度变化（最后一个采样之后匀速外推，不再通知）
+    void ScheduleCourseChange() {
+        double now = Simulator::Now().GetSeconds();
+        uint32_t k = m_file->SampleIndex(now);
+        double next = m_file->GetStartTime() + (k + 1) * m_file->GetStep();
+        if (now < m_file->GetStartTime()) {
+            next = m_file->GetStartTime();
+        } else if (k + 1 >= m_file->GetNumSamples()) {
+            return;
+        }
+        m_event = Simulator::Schedule(Seconds(next) - Simulator::Now(),
+                                      &UavTrajectoryMobilityModel::CourseChanged, this);
+    }
+
+    void CourseChanged() {
+        NotifyCourseChange();
+        ScheduleCourseChange();
+    }
+
+    Vector DoGetPosition() const override {
+        double p[3], v[3];
+        m_file->GetState(m_index, Simulator::Now().GetSeconds(), p, v);
+        return Vector(p[0], p[1], p[2]);
+    }
+
+    Vector DoGetVelocity() const override {
+        double p[3], v[3];
+        m_file->GetState(m_index, Simulator::Now().GetSeconds(), p, v);
+        return Vector(v[0], v[1], v[2]);
+    }
+
+    void DoSetPosition(const Vector&) override {
+        NS_ABORT_MSG("UavTrajectoryMobilityModel replays a recorded trajectory and cannot be moved");
+    }
+
+    std::shared_ptr<const UavTrajectoryFile> m_file;
+    uint32_t m_index = 0;
+    EventId m_event;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(UavTrajectoryMobilityModel);
+
+// 为 nodes 安装回放模型，第 k 个节点对应文件中的第 k 条轨迹；节点数不符时返回 false
+inline bool UavInstallTrajectory(const NodeContainer& nodes, const std::string& path, std::string* error = nullptr) {
+    auto file = std::make_shared<UavTrajectoryFile>();
+    if (!file->Open(path, error)) {
+        return false;
+    }
+    if (file->GetNumNodes() != nodes.GetN()) {
+        if (error) {
+            *error = path + " holds " + std::to_string(file->GetNumNodes()) + " trajectories, scenario has " +
+                     std::to_string(nodes.GetN()) + " nodes";
+        }
+        return false;
+    }
+    for (uint32_t k = 0; k < nodes.GetN(); ++k) {
+        Ptr<UavTrajectoryMobilityModel> model = CreateObject<UavTrajectoryMobilityModel>();
+        model->SetTrajectory(file, k);
+        nodes.Get(k)->AggregateObject(model);
+    }
+    return true;
+}
+
+// 周期采样所有节点的位置与速度
+class UavTrajectoryRecorder {
+public:
+    // 在 MobilityHelper::Install 之后调用；文件在 Simulator::Destroy 时关闭
+    bool Start(const NodeContainer& nodes, const std::string& path, Time step, uint32_t scenario) {
+        if (!m_writer.Open(path, nodes.GetN(), 0.0, step.GetSeconds(), scenario)) {
+            return false;
+        }
+        m_step = step;
+        m_models.clear();
+        for (uint32_t k = 0; k < nodes.GetN(); ++k) {
+            m_models.push_back(nodes.Get(k)->GetObject<MobilityModel>());
+        }
+        m_row.resize(m_models.size());
+        Simulator::Schedule(Seconds(0.0), &UavTrajectoryRecorder::Sample, this);
+        Simulator::ScheduleDestroy(&UavTrajectoryRecorder::Stop, this);
+        return true;
+    }
+
+    void Stop() {
+        Simulator::Cancel(m_event);
+        m_writer.Close();
+        m_models.clear();
+    }
+
+    uint32_t GetNumSamples() const { return m_writer.GetNumSamples(); }
+
+private:
+    void Sample() {
+        for (uint32_t k = 0; k < m_models.size(); ++k) {
+            Vector p = m_models[k]->GetPosition();
+            Vector v = m_models[k]->GetVelocity();
+            m_row[k] = UavTrajectorySample{p.x, p.y, p.z, v.x, v.y, v.z};
+        }
+        m_writer.Append(m_row);
+        m_event = Simulator::Schedule(m_step, &UavTrajectoryRecorder::Sample, this);
+    }
+
+    UavTrajectoryWriter m_writer;
+    Time m_step;
+    std::vector<Ptr<MobilityModel>> m_models;
+    std::vector<UavTrajectorySample> m_row;
+    EventId m_event;
+};
+
+} // namespace ns3
+
+#endif // UAV_TRAJECTORY_MOBILITY_H
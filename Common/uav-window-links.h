@@ -0,0 +1,222 @@
+#ifndef UAV_WINDOW_LINKS_H
+#define UAV_WINDOW_LINKS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// 滑动窗口链路推断
+// 由观测到的通信（时间、两端节点、字节数）流式地推断每个时间窗口内的活动链路。
+// 窗口 k 覆盖 [k * stride, k * stride + window)：stride == window 为不重叠的滚动窗口，
+// stride < window 为滑动窗口（window 需为 stride 的整数倍）。
+// 实现上按 stride 切成 window / stride 个子区间（pane），放在环形缓冲里，
+// 每次观测只更新一个 pane；窗口关闭时合并它覆盖的 pane 输出，随后 pane 被复用。
+// 内存只与 window / stride 和每个 pane 内的边数有关，与仿真时长无关。
+// 观测时间需单调不减（仿真时间满足）。
+
+// 一条边在窗口内的统计
+struct UavWindowEdge {
+    uint32_t i, j;        // i < j
+    uint32_t packets;
+    uint64_t bytes;
+    double lastSeen;
+};
+
+// 关闭的窗口
+struct UavLinkWindow {
+    uint64_t index;
+    double start, end;    // 最后一个窗口的 end 截断到结束时刻
+    std::vector<UavWindowEdge> edges;   // 按 (i, j) 升序
+};
+
+// 边 → 统计的开放寻址哈希表，Clear 只清理用过的槽
+class UavEdgeCounter {
+public:
+    void Add(uint32_t i, uint32_t j, uint32_t packets, uint64_t bytes, double time) {
+        if ((m_used.size() + 1) * 2 > m_slots.size()) {
+            Grow();
+        }
+        uint64_t key = Key(i, j);
+        size_t mask = m_slots.size() - 1;
+        for (size_t s = Hash(key) & mask;; s = (s + 1) & mask) {
+            Slot& slot = m_slots[s];
+            if (slot.key == key) {
+                slot.packets += packets;
+                slot.bytes += bytes;
+                slot.lastSeen = std::max(slot.lastSeen, time);
+                return;
+            }
+            if (slot.key == EMPTY) {
+                slot = Slot{key, packets, bytes, time};
+                m_used.push_back(s);
+                return;
+            }
+        }
+    }
+
+    // fn(i, j, packets, bytes, lastSeen)，顺序不定
+    template <typename Fn>
+    void ForEach(Fn fn) const {
+        for (size_t s : m_used) {
+            const Slot& slot = m_slots[s];
+            fn(static_cast<uint32_t>(slot.key >> 32), static_cast<uint32_t>(slot.key),
+               slot.packets, slot.bytes, slot.lastSeen);
+        }
+    }
+
+    void Clear() {
+        for (size_t s : m_used) {
+            m_slots[s].key = EMPTY;
+        }
+        m_used.clear();
+    }
+
+    size_t GetSize() const { return m_used.size(); }
+
+private:
+    static constexpr uint64_t EMPTY = UINT64_MAX;
+
+    struct Slot {
+        uint64_t key = EMPTY;
+        uint32_t packets = 0;
+        uint64_t bytes = 0;
+        double lastSeen = 0.0;
+    };
+
+    static uint64_t Key(uint32_t i, uint32_t j) {
+        return i < j ? (uint64_t(i) << 32 | j) : (uint64_t(j) << 32 | i);
+    }
+
+    static size_t Hash(uint64_t key) {
+        key *= 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(key ^ (key >> 29));
+    }
+
+    void Grow() {
+        std::vector<Slot> old;
+        old.swap(m_slots);
+        std::vector<size_t> used;
+        used.swap(m_used);
+        m_slots.assign(std::max<size_t>(16, old.size() * 2), Slot());
+        size_t mask = m_slots.size() - 1;
+        for (size_t s : used) {
+            size_t t = Hash(old[s].key) & mask;
+            while (m_slots[t].key != EMPTY) {
+                t = (t + 1) & mask;
+            }
+            m_slots[t] = old[s];
+            m_used.push_back(t);
+        }
+    }
+
+    std::vector<Slot> m_slots;
+    std::vector<size_t> m_used;    // 已占用的槽，用于遍历和清理
+};
+
+class UavWindowLinkInference {
+public:
+    typedef std::function<void(const UavLinkWindow&)> WindowCallback;
+
+    // window 为窗口长度，stride 为相邻窗口起点间隔；参数不合法时返回 false
+    bool Configure(double window, double stride) {
+        if (!(stride > 0.0) || window < stride) {
+            return false;
+        }
+        double panes = window / stride;
+        if (std::fabs(panes - std::round(panes)) > 1e-9 * panes) {
+            return false;
+        }
+        m_window = window;
+        m_stride = stride;
+        m_panes.assign(static_cast<size_t>(std::round(panes)), UavEdgeCounter());
+        m_currentPane = -1;
+        m_nextClose = 0;
+        m_emitted = 0;
+        return true;
+    }
+
+    void SetCallback(WindowCallback callback) { m_callback = callback; }
+
+    // 记录一次 a、b 之间的通信（a != b）
+    void Observe(double time, uint32_t a, uint32_t b, uint64_t bytes) {
+        AdvanceTo(time);
+        int64_t pane = static_cast<int64_t>(std::floor(time / m_stride));
+        OpenPanes(pane);
+        m_panes[pane % m_panes.size()].Add(a, b, 1, bytes, time);
+    }
+
+    // 关闭并输出所有在 time 或之前结束的窗口
+    void AdvanceTo(double time) {
+        while (WindowStart(m_nextClose) + m_window <= time) {
+            Emit(m_nextClose, WindowStart(m_nextClose) + m_window);
+            ++m_nextClose;
+        }
+    }
+
+    // 仿真结束：输出所有在 endTime 之前开始的窗口，最后一个窗口截断到 endTime
+    void Finish(double endTime) {
+        AdvanceTo(endTime);
+        while (WindowStart(m_nextClose) < endTime) {
+            Emit(m_nextClose, std::min(WindowStart(m_nextClose) + m_window, endTime));
+            ++m_nextClose;
+        }
+    }
+
+    // 下一个待关闭窗口的结束时刻
+    double GetNextWindowEnd() const { return WindowStart(m_nextClose) + m_window; }
+    double GetWindow() const { return m_window; }
+    double GetStride() const { return m_stride; }
+    uint64_t GetWindowsEmitted() const { return m_emitted; }
+
+private:
+    double WindowStart(uint64_t k) const { return k * m_stride; }
+
+    // 打开到 pane 为止的所有 pane；被复用的槽对应的旧窗口此前已经关闭
+    void OpenPanes(int64_t pane) {
+        while (m_currentPane < pane) {
+            ++m_currentPane;
+            m_panes[m_currentPane % m_panes.size()].Clear();
+        }
+    }
+
+    // 窗口 k 由 pane k .. k + P - 1 组成，只合并已经打开过的 pane
+    void Emit(uint64_t k, double end) {
+        m_merged.Clear();
+        int64_t last = std::min<int64_t>(k + m_panes.size() - 1, m_currentPane);
+        for (int64_t p = k; p <= last; ++p) {
+            m_panes[p % m_panes.size()].ForEach(
+                [this](uint32_t i, uint32_t j, uint32_t packets, uint64_t bytes, double seen) {
+                    m_merged.Add(i, j, packets, bytes, seen);
+                });
+        }
+        m_out.index = k;
+        m_out.start = WindowStart(k);
+        m_out.end = end;
+        m_out.edges.clear();
+        m_merged.ForEach([this](uint32_t i, uint32_t j, uint32_t packets, uint64_t bytes, double seen) {
+            m_out.edges.push_back(UavWindowEdge{i, j, packets, bytes, seen});
+        });
+        std::sort(m_out.edges.begin(), m_out.edges.end(),
+                  [](const UavWindowEdge& x, const UavWindowEdge& y) {
+                      return x.i != y.i ? x.i < y.i : x.j < y.j;
+                  });
+        ++m_emitted;
+        if (m_callback) {
+            m_callback(m_out);
+        }
+    }
+
+    double m_window = 10.0;
+    double m_stride = 10.0;
+    std::vector<UavEdgeCounter> m_panes;    // 环形缓冲，下标 pane % P
+    int64_t m_currentPane = -1;             // 已打开的最大 pane 编号
+    uint64_t m_nextClose = 0;               // 下一个待关闭的窗口编号
+    uint64_t m_emitted = 0;
+    UavEdgeCounter m_merged;
+    UavLinkWindow m_out;
+    WindowCallback m_callback;
+};
+
+#endif // UAV_WINDOW_LINKS_H
@@ -8,22 +8,31 @@
 #include "ns3/aodv-helper.h"
 #include "ns3/flow-monitor-module.h"
 
+#include "../Common/uav-async-writer.h"
+#include "../Common/uav-binary-trace.h"
+#include "../Common/uav-trace-filter.h"
+#include "../Common/uav-trace-hookup.h"
+#include "../Common/uav-profile.h"
+#include "../Common/uav-runtime-stats.h"
+#include "../Common/uav-mobility-snapshot.h"
+#include "../Common/uav-abstract-phy.h"
+#include "../Common/uav-trajectory-mobility.h"
+#include "../Common/uav-flow-stats.h"
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("UavAdhocNetwork");
 
-const double SIM_AREA_SIZE = 500.0;
-const double UAV_SPEED = 15.0;
+double SIM_AREA_SIZE = 500.0;   // 可由 --area 覆盖
+double UAV_SPEED = 15.0;        // 可由 --speed 覆盖
 const double TIME_SLOT = 0.1;
 
 NodeContainer nodes; // 全局定义nodes
-std::ofstream outFile("uav-packet-sent.txt", std::ios::out); 
-
-uint32_t GetNodeIdFromContext(std::string context) {
-    std::size_t n1 = context.find("/NodeList/") + 10;
-    std::size_t n2 = context.find("/", n1);
-    return std::stoi(context.substr(n1, n2 - n1));
-}
+UavAsyncOfstream outFile;         // 文本格式输出
+UavBinaryTraceWriter binaryTrace; // 二进制格式输出（--traceFormat=binary）
+UavMobilitySnapshot mobilitySnapshot; // 节点位置（--positionMode）
+UavTrajectoryRecorder trajectoryRecorder; // 轨迹录制（--recordTrajectory）
+UavTraceFilter traceFilter; // 记录过滤（--traceFilter），在查位置之前判定
 
 void ScheduleTxSlots(NodeContainer& nodes) {
     for (uint32_t i = 0; i < nodes.GetN(); ++i) {
@@ -41,51 +50,160 @@ void ScheduleTxSlots(NodeContainer& nodes) {
     }
 }
 
-void TxTrace(std::string context, Ptr<const Packet> packet) {
+// nodeId 在挂接时已绑定（见 UavConnectMacTx）
+void TxTrace(uint32_t nodeId, Ptr<const Packet> packet) {
+    UAV_PROFILE_SCOPE(UAV_PROFILE_TX_TRACE);
     double timeNow = Simulator::Now().GetSeconds();
-    uint32_t nodeId = GetNodeIdFromContext(context);
-    Vector pos = nodes.Get(nodeId)->GetObject<MobilityModel>()->GetPosition();
+    if (!traceFilter.Accept(timeNow, nodeId, UAV_EVENT_MAC_TX)) {
+        return;
+    }
+    Vector pos = mobilitySnapshot.GetPosition(nodeId);
+    if (binaryTrace.IsOpen()) {
+        binaryTrace.Write(timeNow, nodeId, UAV_EVENT_MAC_TX, UAV_TRACE_NO_PEER,
+                          pos.x, pos.y, pos.z, packet->GetSize());
+        UAV_TRACE_RECORD(UAV_PROFILE_TX_TRACE, sizeof(UavTraceRecord));
+        return;
+    }
+    UAV_TRACE_TEXT(UAV_PROFILE_TX_TRACE, outFile);
     outFile << "Time: " << timeNow << "s, Node ID: " << nodeId
             << ", Position: (" << pos.x << ", " << pos.y << ", " << pos.z << ")\n";
 }
 
+// 由 Simulator::Destroy 调用，等待后台线程把剩余 trace 写完
+void CloseTraceFiles() {
+    outFile.close();
+    binaryTrace.Close();
+    uint64_t dropped = outFile.GetWriter().GetBytesDropped() + binaryTrace.GetWriter().GetBytesDropped();
+    if (dropped > 0) {
+        std::cerr << "Trace buffers full: " << dropped << " bytes dropped" << std::endl;
+    }
+}
+
 int main(int argc, char *argv[]) {
     uint32_t numNodes = 20;
     double simulationTime = 60.0;
+    uint32_t seed = 1;
+    uint32_t run = 1;
+    std::string outputDir = ".";
+    std::string traceFormat = "text";
+    bool writeStats = false;
+    double statsInterval = 1.0;        // --stats 的采样周期（仿真秒），见 uav-runtime-stats.h
+    UavAsyncOptions traceOptions;   // 异步 trace 写盘（见 uav-async-writer.h）
+    std::string tracePolicy = "block";
+    std::string positionMode = "exact";  // 位置快照精度档（见 uav-mobility-snapshot.h）
+    double positionStep = 0.1;
+    std::string recordTrajectory;       // 录制 / 回放轨迹文件（见 uav-trajectory-mobility.h）
+    std::string replayTrajectory;
+    double trajectoryStep = 1.0;        // 取 GaussMarkov 的 TimeStep，回放与原轨迹一致
+    std::string flowStats = "xml";       // xml 为结束时的 FlowMonitor XML，stream 见 uav-flow-stats.h
+    double flowInterval = 1.0;
+    std::string phyMode = "wifi";       // wifi 为完整 802.11ac 协议栈，abstract 见 uav-abstract-phy.h
+    std::string traceFilterSpec;        // 见 uav-trace-filter.h
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numNodes", "Number of UAVs", numNodes);
+    cmd.AddValue("area", "Side of the square flight area in meters", SIM_AREA_SIZE);
+    cmd.AddValue("speed", "Mean UAV speed in m/s (drawn from speed +/- 5)", UAV_SPEED);
+    cmd.AddValue("duration", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("seed", "RNG seed", seed);
+    cmd.AddValue("run", "RNG run number (independent replication)", run);
+    cmd.AddValue("outputDir", "Directory for all output files", outputDir);
+    cmd.AddValue("traceFormat", "Trace output format (text|binary)", traceFormat);
+    cmd.AddValue("stats", "Write run-stats.txt/run-stats.json and print a runtime summary", writeStats);
+    cmd.AddValue("statsInterval", "Sampling period of event rate and queue depth with --stats, in seconds", statsInterval);
+    cmd.AddValue("asyncTrace", "Write trace files from a background thread", traceOptions.async);
+    cmd.AddValue("traceBufferKb", "Size of each trace buffer in KiB", traceOptions.bufferKb);
+    cmd.AddValue("traceBuffers", "Trace buffers per file (bounds trace memory)", traceOptions.numBuffers);
+    cmd.AddValue("tracePolicy", "When all trace buffers are full: block|drop", tracePolicy);
+    cmd.AddValue("positionMode", "Node positions in traces: exact|snapshot|interpolate", positionMode);
+    cmd.AddValue("positionStep", "Refresh period of the position snapshot in seconds", positionStep);
+    cmd.AddValue("recordTrajectory", "Write the flight paths to this trajectory file", recordTrajectory);
+    cmd.AddValue("replayTrajectory", "Replay flight paths from this trajectory file instead of Gauss-Markov", replayTrajectory);
+    cmd.AddValue("trajectoryStep", "Sampling period of --recordTrajectory in seconds", trajectoryStep);
+    cmd.AddValue("phyMode", "Radio model: wifi (802.11ac) or abstract (range + collision)", phyMode);
+    cmd.AddValue("flowStats", "Flow statistics: xml (end of run) or stream (per-interval CSV)", flowStats);
+    cmd.AddValue("flowInterval", "Interval of --flowStats=stream in seconds", flowInterval);
+    cmd.AddValue("traceFilter", "Record only matching transmissions, e.g. 'nodes=0-4;events=tx-data;time=10-50;sample=10'", traceFilterSpec);
+    cmd.Parse(argc, argv);
+
+    SeedManager::SetSeed(seed);
+    SeedManager::SetRun(run);
+    SystemPath::MakeDirectories(outputDir);
+
+    NS_ABORT_MSG_UNLESS(traceFormat == "text" || traceFormat == "binary",
+                        "Unknown trace format: " << traceFormat);
+    NS_ABORT_MSG_UNLESS(UavParseBackPressure(tracePolicy, traceOptions.policy),
+                        "Unknown trace policy: " << tracePolicy);
+    UavMobilitySnapshot::Mode snapshotMode;
+    NS_ABORT_MSG_UNLESS(UavMobilitySnapshot::ParseMode(positionMode, snapshotMode),
+                        "Unknown position mode: " << positionMode);
+    NS_ABORT_MSG_UNLESS(phyMode == "wifi" || phyMode == "abstract",
+                        "Unknown PHY mode: " << phyMode);
+    NS_ABORT_MSG_UNLESS(flowStats == "xml" || flowStats == "stream",
+                        "Unknown flow statistics mode: " << flowStats);
+    NS_ABORT_MSG_UNLESS(flowInterval > 0.0, "--flowInterval must be positive");
+    std::string filterError;
+    NS_ABORT_MSG_UNLESS(traceFilter.Parse(traceFilterSpec, &filterError), filterError);
+    if (traceFormat == "binary") {
+        binaryTrace.Open(outputDir + "/uav-packet-sent.bin", UAV_SCENARIO_FIRST, traceOptions);
+    } else {
+        outFile.open(outputDir + "/uav-packet-sent.txt", traceOptions);
+    }
+    Simulator::ScheduleDestroy(&CloseTraceFiles);
 
     nodes.Create(numNodes);
 
-    MobilityHelper mobility;
-    mobility.SetPositionAllocator("ns3::RandomBoxPositionAllocator",
-        "X", StringValue("ns3::UniformRandomVariable[Min=0|Max=" + std::to_string(SIM_AREA_SIZE) + "]"),
-        "Y", StringValue("ns3::UniformRandomVariable[Min=0|Max=" + std::to_string(SIM_AREA_SIZE) + "]"),
-        "Z", StringValue("ns3::UniformRandomVariable[Min=50|Max=150]"));
+    if (!replayTrajectory.empty()) {
+        // 回放预生成的轨迹，不再计算 GaussMarkov 移动
+        std::string error;
+        NS_ABORT_MSG_UNLESS(UavInstallTrajectory(nodes, replayTrajectory, &error), error);
+    } else {
+        MobilityHelper mobility;
+        mobility.SetPositionAllocator("ns3::RandomBoxPositionAllocator",
+            "X", StringValue("ns3::UniformRandomVariable[Min=0|Max=" + std::to_string(SIM_AREA_SIZE) + "]"),
+            "Y", StringValue("ns3::UniformRandomVariable[Min=0|Max=" + std::to_string(SIM_AREA_SIZE) + "]"),
+            "Z", StringValue("ns3::UniformRandomVariable[Min=50|Max=150]"));
 
-    mobility.SetMobilityModel("ns3::GaussMarkovMobilityModel",
-        "MeanVelocity", StringValue("ns3::UniformRandomVariable[Min="+std::to_string(UAV_SPEED-5)+"|Max="+std::to_string(UAV_SPEED+5)+"]"),
-        "Bounds", BoxValue(Box(0, SIM_AREA_SIZE, 0, SIM_AREA_SIZE, 50, 150)));
-    mobility.Install(nodes);
+        mobility.SetMobilityModel("ns3::GaussMarkovMobilityModel",
+            "MeanVelocity", StringValue("ns3::UniformRandomVariable[Min="+std::to_string(UAV_SPEED-5)+"|Max="+std::to_string(UAV_SPEED+5)+"]"),
+            "Bounds", BoxValue(Box(0, SIM_AREA_SIZE, 0, SIM_AREA_SIZE, 50, 150)));
+        mobility.Install(nodes);
+    }
+    if (!recordTrajectory.empty()) {
+        NS_ABORT_MSG_UNLESS(trajectoryRecorder.Start(nodes, recordTrajectory, Seconds(trajectoryStep), UAV_SCENARIO_FIRST),
+                            "Cannot write trajectory file: " << recordTrajectory);
+    }
+    mobilitySnapshot.Install(nodes, snapshotMode, Seconds(positionStep));
 
-    YansWifiChannelHelper channel;
-    channel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
-    channel.AddPropagationLoss("ns3::FriisPropagationLossModel", "Frequency", DoubleValue(5.0e9));
+    NetDeviceContainer devices;
+    UavAbstractPhyHelper abstractPhy;
+    if (phyMode == "abstract") {
+        // 与下面 Wi-Fi 信道相同的 Friis 损耗和发射功率
+        abstractPhy.SetPropagationLoss("ns3::FriisPropagationLossModel", "Frequency", DoubleValue(5.0e9));
+        abstractPhy.SetChannelAttribute("TxPower", DoubleValue(23.0));
+        devices = abstractPhy.Install(nodes);
+    } else {
+        YansWifiChannelHelper channel;
+        channel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+        channel.AddPropagationLoss("ns3::FriisPropagationLossModel", "Frequency", DoubleValue(5.0e9));
 
-    YansWifiPhyHelper phy;
-    phy.SetChannel(channel.Create());
-    phy.Set("TxPowerStart", DoubleValue(23.0));
-    phy.Set("TxPowerEnd", DoubleValue(23.0));
+        YansWifiPhyHelper phy;
+        phy.SetChannel(channel.Create());
+        phy.Set("TxPowerStart", DoubleValue(23.0));
+        phy.Set("TxPowerEnd", DoubleValue(23.0));
 
-    WifiMacHelper mac;
-    mac.SetType("ns3::AdhocWifiMac",
-        "QosSupported", BooleanValue(true),
-        "BE_MaxAmpduSize", UintegerValue(65535),
-        "BE_MaxAmsduSize", UintegerValue(3839));
+        WifiMacHelper mac;
+        mac.SetType("ns3::AdhocWifiMac",
+            "QosSupported", BooleanValue(true),
+            "BE_MaxAmpduSize", UintegerValue(65535),
+            "BE_MaxAmsduSize", UintegerValue(3839));
 
-    WifiHelper wifi;
-    wifi.SetStandard(WIFI_STANDARD_80211ac);
-    wifi.SetRemoteStationManager("ns3::MinstrelHtWifiManager");
+        WifiHelper wifi;
+        wifi.SetStandard(WIFI_STANDARD_80211ac);
+        wifi.SetRemoteStationManager("ns3::MinstrelHtWifiManager");
 
-    NetDeviceContainer devices = wifi.Install(phy, mac, nodes);
+        devices = wifi.Install(phy, mac, nodes);
+    }
 
     InternetStackHelper stack;
     AodvHelper aodv;
@@ -93,7 +211,12 @@ int main(int argc, char *argv[]) {
     stack.Install(nodes);
 
     Ipv4AddressHelper address;
-    address.SetBase("10.1.1.0", "255.255.255.0");
+    // 超过 254 个节点时 /24 不够用，改用 /16
+    if (numNodes <= 254) {
+        address.SetBase("10.1.1.0", "255.255.255.0");
+    } else {
+        address.SetBase("10.1.0.0", "255.255.0.0");
+    }
     Ipv4InterfaceContainer interfaces = address.Assign(devices);
 
     for (uint32_t i = 0; i < numNodes; ++i) {
@@ -110,14 +233,41 @@ int main(int argc, char *argv[]) {
 
     FlowMonitorHelper flowmon;
     Ptr<FlowMonitor> monitor = flowmon.InstallAll();
+    UavFlowStatsExporter flowExporter;
+    if (flowStats == "stream") {
+        NS_ABORT_MSG_UNLESS(flowExporter.Start(monitor, DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier()),
+                                               outputDir, Seconds(flowInterval), traceOptions),
+                            "Cannot open flow statistics files in " << outputDir);
+    }
 
-    Config::Connect("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/MacTx", MakeCallback(&TxTrace));
+    UavConnectMacTx(nodes, &TxTrace);
 
+    UavRuntimeStats runtimeStats;
+    if (writeStats) {
+        runtimeStats.Start(Seconds(statsInterval));
+    }
     Simulator::Stop(Seconds(simulationTime));
+    double wallStart = UavWallClock();
     Simulator::Run();
+    double wallSeconds = UavWallClock() - wallStart;
+    if (writeStats) {
+        UavProfiler::Get().WriteStats(outputDir + "/run-stats.txt", simulationTime, wallSeconds,
+                                      Simulator::GetEventCount(), numNodes);
+        runtimeStats.WriteReport(outputDir + "/run-stats.json", simulationTime, wallSeconds,
+                                 Simulator::GetEventCount(), numNodes);
+        runtimeStats.PrintSummary(std::cout, wallSeconds, Simulator::GetEventCount());
+    }
+    if (abstractPhy.GetChannel()) {
+        Ptr<UavRangeChannel> radio = abstractPhy.GetChannel();
+        std::cout << "Abstract PHY: " << radio->GetDelivered() << " frames delivered, "
+                  << radio->GetCollisions() << " collisions, " << radio->GetLost() << " lost" << std::endl;
+    }
 
-    monitor->SerializeToXmlFile("uav-flowmon.xml", true, true);
-    outFile.close(); // 关闭文件
-    Simulator::Destroy();
+    if (flowStats == "stream") {
+        flowExporter.Finish();
+    } else {
+        monitor->SerializeToXmlFile(outputDir + "/uav-flowmon.xml", true, true);
+    }
+    Simulator::Destroy(); // 关闭文件（CloseTraceFiles）
     return 0;
 }
@@ -0,0 +1,11 @@
+#include "ns3/core-module.h"
+
+#include "uav-scenario-main.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("UavScenario");
+
+int main(int argc, char *argv[]) {
+    return UavScenarioMain(argc, argv, __FILE__);
+}
@@ -0,0 +1,955 @@
+#ifndef UAV_PRESETS_H
+#define UAV_PRESETS_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/aodv-helper.h"
+
+#include "../Common/uav-async-writer.h"
+#include "../Common/uav-binary-trace.h"
+#include "../Common/uav-trace-hookup.h"
+#include "../Common/uav-address-index.h"
+#include "../Common/uav-packet-classifier.h"
+#include "../Common/uav-profile.h"
+#include "../Common/uav-mobility-snapshot.h"
+#include "../Common/uav-spatial-grid.h"
+#include "../Common/uav-link-table.h"
+#include "../Common/uav-link-kernel.h"
+#include "../Common/uav-kinetic-topology.h"
+#include "../Common/uav-topology-log.h"
+#include "../Common/uav-window-links.h"
+#include "../Common/uav-abstract-phy.h"
+#include "../Common/uav-link-prober.h"
+#include "../Common/uav-burst-traffic.h"
+#include "../Common/uav-graph-export.h"
+
+#include "uav-scenario.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// 场景部件与三个预设
+// 各部件的配置、回调和输出格式逐行取自 First/Second/Third 原程序；
+// 预设 first/second/third 以相同的种子运行时，输出文件与对应原程序相同。
+
+namespace ns3 {
+
+// ---- 移动模型 ----
+
+// First / Second：初始位置与活动范围同为 area×area×[50,150]
+struct UavBoxMobility {
+    static void Install(NodeContainer& nodes, const UavScenarioConfig& c) {
+        MobilityHelper mobility;
+        mobility.SetPositionAllocator("ns3::RandomBoxPositionAllocator",
+            "X", StringValue("ns3::UniformRandomVariable[Min=0|Max=" + std::to_string(c.area) + "]"),
+            "Y", StringValue("ns3::UniformRandomVariable[Min=0|Max=" + std::to_string(c.area) + "]"),
+            "Z", StringValue("ns3::UniformRandomVariable[Min=50|Max=150]"));
+        mobility.SetMobilityModel("ns3::GaussMarkovMobilityModel",
+            "MeanVelocity", StringValue("ns3::UniformRandomVariable[Min=" + std::to_string(c.speed - 5) + "|Max=" + std::to_string(c.speed + 5) + "]"),
+            "Bounds", BoxValue(Box(0, c.area, 0, c.area, 50, 150)));
+        mobility.Install(nodes);
+    }
+};
+
+// Third：初始位置分布在 2 倍区域内，活动范围 area×area×[0,100]，GaussMarkov 参数全部显式给出
+struct UavWideStartMobility {
+    static void Install(NodeContainer& nodes, const UavScenarioConfig& c) {
+        MobilityHelper mobility;
+        mobility.SetPositionAllocator("ns3::RandomBoxPositionAllocator",
+            "X", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=" + std::to_string(2 * c.area) + "]"),
+            "Y", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=" + std::to_string(2 * c.area) + "]"),
+            "Z", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=200.0]"));
+        mobility.SetMobilityModel("ns3::GaussMarkovMobilityModel",
+            "Bounds", BoxValue(Box(0, c.area, 0, c.area, 0, 100)),
+            "TimeStep", TimeValue(Seconds(1.0)),
+            "Alpha", DoubleValue(0.7),
+            "MeanVelocity", StringValue("ns3::UniformRandomVariable[Min=" + std::to_string(c.speed - 5) + "|Max=" + std::to_string(c.speed + 5) + "]"),
+            "MeanDirection", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=6.283185]"),
+            "MeanPitch", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=0.0]"),
+            "NormalVelocity", StringValue("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=2.0]"),
+            "NormalDirection", StringValue("ns3::NormalRandomVariable[Mean=0.0|Variance=0.5|Bound=1.0]"),
+            "NormalPitch", StringValue("ns3::NormalRandomVariable[Mean=0.0|Variance=0.1|Bound=0.2]"));
+        mobility.Install(nodes);
+    }
+};
+
+// ---- 无线设备（--phyMode=abstract 时装 uav-abstract-phy.h 的等效模型） ----
+
+// First：Friis 5 GHz，23 dBm，QoS + A-MPDU/A-MSDU 聚合，MinstrelHt
+struct UavFriisRadio {
+    static NetDeviceContainer Install(NodeContainer& nodes, UavAbstractPhyHelper& abstractPhy,
+                                      const UavScenarioConfig& c) {
+        if (c.abstractPhy) {
+            abstractPhy.SetPropagationLoss("ns3::FriisPropagationLossModel", "Frequency", DoubleValue(5.0e9));
+            abstractPhy.SetChannelAttribute("TxPower", DoubleValue(23.0));
+            return abstractPhy.Install(nodes);
+        }
+        YansWifiChannelHelper channel;
+        channel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
+        channel.AddPropagationLoss("ns3::FriisPropagationLossModel", "Frequency", DoubleValue(5.0e9));
+
+        YansWifiPhyHelper phy;
+        phy.SetChannel(channel.Create());
+        phy.Set("TxPowerStart", DoubleValue(23.0));
+        phy.Set("TxPowerEnd", DoubleValue(23.0));
+
+        WifiMacHelper mac;
+        mac.SetType("ns3::AdhocWifiMac",
+            "QosSupported", BooleanValue(true),
+            "BE_MaxAmpduSize", UintegerValue(65535),
+            "BE_MaxAmsduSize", UintegerValue(3839));
+
+        WifiHelper wifi;
+        wifi.SetStandard(WIFI_STANDARD_80211ac);
+        wifi.SetRemoteStationManager("ns3::MinstrelHtWifiManager");
+        return wifi.Install(phy, mac, nodes);
+    }
+};
+
+// Second：默认 LogDistance 信道，23 dBm，灵敏度 -85 dBm，QoS，MinstrelHt
+struct UavDefaultChannelRadio {
+    static NetDeviceContainer Install(NodeContainer& nodes, UavAbstractPhyHelper& abstractPhy,
+                                      const UavScenarioConfig& c) {
+        if (c.abstractPhy) {
+            abstractPhy.SetChannelAttribute("TxPower", DoubleValue(23.0));
+            abstractPhy.SetChannelAttribute("RxSensitivity", DoubleValue(-85.0));
+            return abstractPhy.Install(nodes);
+        }
+        YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
+        YansWifiPhyHelper phy;
+        phy.Set("TxPowerStart", DoubleValue(23.0));
+        phy.Set("TxPowerEnd", DoubleValue(23.0));
+        phy.Set("RxSensitivity", DoubleValue(-85.0));
+        phy.SetChannel(channel.Create());
+
+        WifiMacHelper mac;
+        mac.SetType("ns3::AdhocWifiMac",
+                   "QosSupported", BooleanValue(true));
+
+        WifiHelper wifi;
+        wifi.SetStandard(WIFI_STANDARD_80211ac);
+        wifi.SetRemoteStationManager("ns3::MinstrelHtWifiManager");
+        return wifi.Install(phy, mac, nodes);
+    }
+};
+
+// Third：默认 LogDistance 信道，28 dBm，灵敏度 -90 dBm，固定速率 VhtMcs0
+struct UavConstantRateRadio {
+    static NetDeviceContainer Install(NodeContainer& nodes, UavAbstractPhyHelper& abstractPhy,
+                                      const UavScenarioConfig& c) {
+        if (c.abstractPhy) {
+            abstractPhy.SetChannelAttribute("TxPower", DoubleValue(28.0));
+            abstractPhy.SetChannelAttribute("RxSensitivity", DoubleValue(-90.0));
+            return abstractPhy.Install(nodes);
+        }
+        WifiHelper wifi;
+        wifi.SetStandard(WIFI_STANDARD_80211ac);
+        wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                     "DataMode", StringValue("VhtMcs0"),
+                                     "ControlMode", StringValue("VhtMcs0"));
+        YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
+        Ptr<YansWifiChannel> wifiChannel = channel.Create();
+
+        YansWifiPhyHelper phy;
+        phy.SetChannel(wifiChannel);
+        phy.Set("TxPowerStart", DoubleValue(28.0));
+        phy.Set("TxPowerEnd", DoubleValue(28.0));
+        phy.Set("RxSensitivity", DoubleValue(-90.0));
+
+        WifiMacHelper mac;
+        mac.SetType("ns3::AdhocWifiMac");
+        return wifi.Install(phy, mac, nodes);
+    }
+};
+
+// ---- 路由 ----
+
+struct UavAodvRouting {
+    static void Install(NodeContainer& nodes) {
+        InternetStackHelper stack;
+        AodvHelper aodv;
+        stack.SetRoutingHelper(aodv);
+        stack.Install(nodes);
+    }
+
+    // 协议栈和路由的随机流从 stream 起重新编号，返回用掉的流数
+    static int64_t AssignStreams(NodeContainer& nodes, int64_t stream) {
+        int64_t used = InternetStackHelper().AssignStreams(nodes, stream);
+        return used + AodvHelper().AssignStreams(nodes, stream + used);
+    }
+};
+
+// 不装 ad hoc 路由，只有 InternetStackHelper 默认的静态路由（单跳通信）
+struct UavNoRouting {
+    static void Install(NodeContainer& nodes) {
+        InternetStackHelper stack;
+        stack.Install(nodes);
+    }
+
+    static int64_t AssignStreams(NodeContainer& nodes, int64_t stream) {
+        return InternetStackHelper().AssignStreams(nodes, stream);
+    }
+};
+
+// ---- 传输记录的文本行格式 ----
+
+// First：Time: 1.2s, Node ID: 3, Position: (x, y, z)
+struct UavFirstTextFormat {
+    static constexpr bool needsPosition = true;
+
+    static void Write(std::ostream& os, double time, uint32_t node, UavTraceEvent, uint32_t,
+                      const Vector& pos, uint32_t) {
+        os << "Time: " << time << "s, Node ID: " << node
+           << ", Position: (" << pos.x << ", " << pos.y << ", " << pos.z << ")\n";
+    }
+};
+
+// Second：time,node,event,x,y,z
+struct UavSecondTextFormat {
+    static constexpr bool needsPosition = true;
+
+    static void Write(std::ostream& os, double time, uint32_t node, UavTraceEvent event, uint32_t,
+                      const Vector& pos, uint32_t) {
+        os << time << "," << node << "," << UavTraceEventName(event) << ","
+           << pos.x << "," << pos.y << "," << pos.z << "\n";
+    }
+};
+
+// Third：1.234s Node3 Tx Data（不含位置）
+struct UavThirdTextFormat {
+    static constexpr bool needsPosition = false;
+
+    static void Write(std::ostream& os, double time, uint32_t node, UavTraceEvent event, uint32_t,
+                      const Vector&, uint32_t) {
+        os << std::fixed << std::setprecision(3) << time << "s "
+           << "Node" << node << " " << UavTraceEventName(event) << "\n";
+    }
+};
+
+// ---- 业务 ----
+
+// First：环形 UDP OnOff，节点 i 发往 (i+1)%n，每个节点在自己的 0.1 秒时隙内发送
+template <typename S>
+class UavRingTraffic {
+public:
+    explicit UavRingTraffic(S& scenario) : m_scenario(scenario) {}
+
+    void Configure(const UavScenarioConfig&) {}
+    void InstallReceivers() {}
+
+    void InstallSenders() {
+        NodeContainer& nodes = m_scenario.GetNodes();
+        const Ipv4InterfaceContainer& interfaces = m_scenario.GetInterfaces();
+        uint32_t numNodes = nodes.GetN();
+        double simulationTime = m_scenario.GetConfig().duration;
+        for (uint32_t i = 0; i < numNodes; ++i) {
+            OnOffHelper client("ns3::UdpSocketFactory", Address(InetSocketAddress(interfaces.GetAddress((i+1)%numNodes), 50000)));
+            client.SetAttribute("PacketSize", UintegerValue(512));
+            client.SetAttribute("DataRate", DataRateValue(DataRate("2Mbps")));
+
+            ApplicationContainer clientApps = client.Install(nodes.Get(i));
+            clientApps.Start(Seconds(1.0 + i*0.1));
+            clientApps.Stop(Seconds(simulationTime - 1));
+        }
+        ScheduleTxSlots(nodes);
+    }
+
+    void Connect() {
+        if constexpr (S::kTransmissions) {
+            UavConnectMacTx(m_scenario.GetNodes(), &UavRingTraffic::TxTrace);
+        }
+    }
+
+    // 发送时隙固定，没有流量随机数
+    void Reseed() {}
+
+    void Finish() {}
+
+private:
+    static constexpr double TIME_SLOT = 0.1;
+
+    static void ScheduleTxSlots(NodeContainer& nodes) {
+        for (uint32_t i = 0; i < nodes.GetN(); ++i) {
+            Ptr<Node> node = nodes.Get(i);
+            Simulator::Schedule(Seconds(i * TIME_SLOT), [node]() {
+                Ptr<OnOffApplication> onoff = DynamicCast<OnOffApplication>(node->GetApplication(0));
+                if (onoff) {
+                    onoff->SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=0.05]"));
+                    onoff->SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0.95]"));
+                }
+            });
+        }
+    }
+
+    static void TxTrace(uint32_t nodeId, Ptr<const Packet> packet) {
+        UAV_PROFILE_SCOPE(UAV_PROFILE_TX_TRACE);
+        S::Current().Record(UAV_PROFILE_TX_TRACE, nodeId, UAV_EVENT_MAC_TX, UAV_TRACE_NO_PEER, packet->GetSize());
+    }
+
+    S& m_scenario;
+};
+
+// Second：每个节点一个回显服务器和一个常驻探测应用，每 0.5 秒探测当前拓扑中的全部邻居
+template <typename S>
+class UavProbeTraffic {
+public:
+    explicit UavProbeTraffic(S& scenario) : m_scenario(scenario) {}
+
+    void Configure(const UavScenarioConfig&) {}
+
+    void InstallReceivers() {
+        UdpEchoServerHelper ackServer(ECHO_PORT);
+        m_servers = ackServer.Install(m_scenario.GetNodes());
+        m_servers.Start(Seconds(0.0));
+        m_servers.Stop(Seconds(m_scenario.GetConfig().duration));
+    }
+
+    // 首轮探测与首次拓扑更新同在 0.1 秒，拓扑更新先调度、先执行
+    void InstallSenders() {
+        NodeContainer& nodes = m_scenario.GetNodes();
+        for (uint32_t i = 0; i < nodes.GetN(); ++i) {
+            Ptr<UavLinkProber> prober = CreateObject<UavLinkProber>();
+            prober->SetAttribute("Interval", TimeValue(Seconds(PACKET_INTERVAL)));
+            prober->SetAttribute("RemotePort", UintegerValue(ECHO_PORT));
+            prober->SetAttribute("PacketSize", UintegerValue(512));
+            prober->SetDestinationCallback(MakeCallback(&UavProbeTraffic::GetProbeTargets, this));
+            if constexpr (S::kTransmissions) {
+                prober->TraceConnectWithoutContext("Rx", MakeBoundCallback(&UavProbeTraffic::ClientReceiveAck,
+                                                                           nodes.Get(i)->GetId()));
+            }
+            nodes.Get(i)->AddApplication(prober);
+            prober->SetStartTime(Seconds(0.1));
+            prober->SetStopTime(Seconds(m_scenario.GetConfig().duration));
+        }
+    }
+
+    // 探测目标取自拓扑，没有流量随机数
+    void Reseed() {}
+
+    void Finish() {}
+
+    void Connect() {
+        if constexpr (S::kTransmissions) {
+            UavConnectMacTx(m_scenario.GetNodes(), &UavProbeTraffic::TxTrace);
+            for (uint32_t i = 0; i < m_servers.GetN(); ++i) {
+                Ptr<UdpEchoServer> server = m_servers.Get(i)->GetObject<UdpEchoServer>();
+                server->TraceConnectWithoutContext("RxWithAddresses", MakeCallback(&UavProbeTraffic::ServerReceive));
+            }
+        }
+    }
+
+private:
+    static constexpr double PACKET_INTERVAL = 0.5;
+    static constexpr uint16_t ECHO_PORT = 2000;
+
+    // 探测目标：当前拓扑中该节点的全部邻居
+    void GetProbeTargets(uint32_t nodeId, std::vector<Ipv4Address>& targets) {
+        UAV_PROFILE_SCOPE(UAV_PROFILE_PROBE_TRANSMISSIONS);
+        const UavAddressIndex& index = m_scenario.GetAddressIndex();
+        m_scenario.GetTopology().ForEachNeighbor(nodeId, [&targets, &index](uint32_t j) {
+            targets.push_back(index.GetAddress(j));
+        });
+    }
+
+    static void LogTransmission(uint32_t nodeId, UavTraceEvent type) {
+        UAV_PROFILE_SCOPE(UAV_PROFILE_LOG_TRANSMISSION);
+        S::Current().Record(UAV_PROFILE_LOG_TRANSMISSION, nodeId, type);
+    }
+
+    static void TxTrace(uint32_t nodeId, Ptr<const Packet> packet) {
+        UAV_PROFILE_SCOPE(UAV_PROFILE_TX_TRACE);
+        LogTransmission(nodeId, UAV_EVENT_DATA);
+    }
+
+    static void ClientReceiveAck(uint32_t nodeId, Ptr<const Packet> packet, const Address& address) {
+        UAV_PROFILE_SCOPE(UAV_PROFILE_CLIENT_RECEIVE_ACK);
+        LogTransmission(nodeId, UAV_EVENT_ACK_RECEIVED);
+    }
+
+    static void ServerReceive(Ptr<const Packet> pkt, const Address& srcAddr, const Address& dstAddr) {
+        UAV_PROFILE_SCOPE(UAV_PROFILE_SERVER_RECEIVE);
+        InetSocketAddress srcInet = InetSocketAddress::ConvertFrom(srcAddr);
+        uint32_t srcNodeId = S::Current().GetAddressIndex().GetNodeId(srcInet.GetIpv4());
+        if (srcNodeId != UavAddressIndex::NOT_FOUND) {
+            LogTransmission(srcNodeId, UAV_EVENT_ACK);
+        }
+    }
+
+    S& m_scenario;
+    ApplicationContainer m_servers;
+};
+
+// Third：每个节点一个 TCP PacketSink；每秒以 1/2 概率在随机的一对节点间发起一次 0.02 秒的 OnOff 会话，
+// --traffic=burst 时改用每节点一个的 UavBurstApp（见 uav-burst-traffic.h）
+template <typename S>
+class UavRandomTcpTraffic {
+public:
+    explicit UavRandomTcpTraffic(S& scenario) : m_scenario(scenario) {}
+
+    void Configure(const UavScenarioConfig& c) {
+        if (c.verbose) {
+            LogComponentEnable("OnOffApplication", LOG_LEVEL_INFO);
+            LogComponentEnable("PacketSink", LOG_LEVEL_INFO);
+        }
+    }
+
+    void InstallReceivers() {
+        PacketSinkHelper sinkHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), SINK_PORT));
+        ApplicationContainer sinkApps = sinkHelper.Install(m_scenario.GetNodes());
+        sinkApps.Start(Seconds(0.0));
+        sinkApps.Stop(Seconds(m_scenario.GetConfig().duration));
+    }
+
+    // 分副本时只安装预热期内的流量，其余由各副本在 Reseed 中以自己的随机流生成
+    void InstallSenders() {
+        const UavScenarioConfig& c = m_scenario.GetConfig();
+        InstallTraffic(0.0, c.replicas > 0 ? c.warmup : c.duration);
+    }
+
+    // 副本：run 已换成副本自己的编号，重建随机流，生成预热之后的流量
+    void Reseed() {
+        InstallTraffic(Simulator::Now().GetSeconds(), m_scenario.GetConfig().duration);
+    }
+
+    // 传输记录和拓扑输出都关闭时不挂接
+    void Connect() {
+        if constexpr (S::kTransmissions || S::kTopologyOutput) {
+            UavConnectIpv4TxRx(m_scenario.GetNodes(), &UavRandomTcpTraffic::Ipv4Tracer);
+        }
+    }
+
+    // --traffic=burst 时打印突发应用的汇总
+    void Finish() {
+        if (m_burstApps.GetN() == 0) {
+            return;
+        }
+        uint64_t bursts = 0, sent = 0, dropped = 0, opened = 0;
+        for (uint32_t i = 0; i < m_burstApps.GetN(); ++i) {
+            Ptr<UavBurstApp> app = DynamicCast<UavBurstApp>(m_burstApps.Get(i));
+            bursts += app->GetBurstsSent();
+            sent += app->GetBytesSent();
+            dropped += app->GetBytesDropped();
+            opened += app->GetConnectionsOpened();
+        }
+        std::cout << "Burst traffic: " << bursts << " bursts, " << sent << " bytes sent, "
+                  << dropped << " bytes dropped, " << opened << " connections opened" << std::endl;
+    }
+
+private:
+    static constexpr uint16_t SINK_PORT = 9999;
+
+    // 生成 [start, stop) 内的流量；应用的起止时间相对当前时刻设置
+    void InstallTraffic(double start, double stop) {
+        NodeContainer& nodes = m_scenario.GetNodes();
+        const Ipv4InterfaceContainer& interfaces = m_scenario.GetInterfaces();
+        const UavScenarioConfig& c = m_scenario.GetConfig();
+        double simulationTime = c.duration;
+        Time now = Simulator::Now();
+
+        Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
+        rand->SetStream(1);  // 固定随机流以重现实验
+        if (c.burstTraffic) {
+            // 每节点一个常驻应用，按预先生成的计划突发，连接复用
+            TypeId protocol = TcpSocketFactory::GetTypeId();
+            if (c.burstUdp) {
+                protocol = UdpSocketFactory::GetTypeId();
+            }
+            if (c.burstUdp && start == 0.0) {
+                // UDP 接收端只在首次安装时创建，副本沿用预热时的
+                PacketSinkHelper udpSink("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), SINK_PORT));
+                ApplicationContainer udpSinks = udpSink.Install(nodes);
+                udpSinks.Start(Seconds(0.0));
+                udpSinks.Stop(Seconds(simulationTime));
+            }
+            UavBurstSchedule::Options options = c.burst;
+            options.start = start;
+            options.stop = stop;
+            m_burstApps.Add(UavInstallBurstTraffic(nodes, interfaces, options, rand, protocol, SINK_PORT,
+                                                   c.maxConnections));
+            return;
+        }
+        OnOffHelper onoff("ns3::TcpSocketFactory", Address());
+        onoff.SetAttribute("PacketSize", UintegerValue(512));
+        onoff.SetAttribute("DataRate", StringValue("10Mbps"));
+        onoff.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=0.001]"));
+        onoff.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0.0]"));
+
+        for (uint32_t t = static_cast<uint32_t>(std::ceil(start)); t < stop; ++t) {
+            if (rand->GetValue() < 0.5) {
+                uint32_t sender = rand->GetInteger(0, nodes.GetN() - 1);
+                uint32_t receiver = rand->GetInteger(0, nodes.GetN() - 1);
+                while (receiver == sender) {
+                    receiver = rand->GetInteger(0, nodes.GetN() - 1);
+                }
+                Address remoteAddress(InetSocketAddress(interfaces.GetAddress(receiver), SINK_PORT));
+                onoff.SetAttribute("Remote", AddressValue(remoteAddress));
+                ApplicationContainer app = onoff.Install(nodes.Get(sender));
+                app.Start(Seconds((double)t) - now);
+                app.Stop(Seconds(t + 0.02) - now);
+            }
+        }
+    }
+
+    static void Ipv4Tracer(uint32_t nodeId, bool isTx, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface) {
+        UAV_PROFILE_SCOPE(UAV_PROFILE_IPV4_TRACER);
+        if constexpr (!S::kTopologyOutput) {
+            // 只有传输记录时，节点、时间和抽样条件不满足的事件不必解析包头
+            if (!S::Current().GetConfig().traceFilter.AcceptNode(Simulator::Now().GetSeconds(), nodeId)) {
+                return;
+            }
+        }
+        // TCP 之外也接受 UDP（--burstProtocol=udp），UDP 负载按数据计
+        UavPacketInfo info;
+        if (!UavClassifyTransport(packet, info)) {
+            return;
+        }
+        uint32_t payloadSize = info.payloadSize;
+        if (payloadSize == 0 && !info.isAck) {
+            return; // SYN/FIN 控制包或空 UDP 报文，不记录
+        }
+        UavTraceEvent eventType;
+        if (isTx) {
+            eventType = (payloadSize > 0) ? UAV_EVENT_TX_DATA : UAV_EVENT_TX_ACK;
+        } else {
+            eventType = (payloadSize > 0) ? UAV_EVENT_RX_DATA : UAV_EVENT_RX_ACK;
+        }
+
+        // 对端未登记时按节点 0 计入窗口（与原程序一致），记录中标为无对端
+        S& scenario = S::Current();
+        uint32_t found = scenario.GetAddressIndex().GetNodeId(isTx ? info.destination : info.source);
+        bool peerKnown = found != UavAddressIndex::NOT_FOUND;
+        uint32_t peerNodeId = peerKnown ? found : 0;
+
+        scenario.Record(UAV_PROFILE_IPV4_TRACER, nodeId, eventType,
+                        peerKnown ? peerNodeId : UAV_TRACE_NO_PEER, payloadSize);
+        if constexpr (S::kTopologyOutput) {
+            if (peerNodeId != nodeId) {
+                scenario.GetTopology().Observe(Simulator::Now().GetSeconds(), std::min(nodeId, peerNodeId),
+                                               std::max(nodeId, peerNodeId), packet->GetSize());
+            }
+            scenario.GetTopology().CountPacket(Simulator::Now().GetSeconds(), nodeId, isTx);
+        }
+    }
+
+    S& m_scenario;
+    ApplicationContainer m_burstApps;   // --traffic=burst 的每节点应用，副本追加的也在内
+};
+
+// ---- 拓扑 ----
+
+// First：不跟踪拓扑
+template <typename S>
+class UavNoTopology {
+public:
+    explicit UavNoTopology(S&) {}
+
+    void Configure(const UavScenarioConfig&) {}
+    void Open() {}
+    void Reopen() {}
+    void Start() {}
+    void Finish(double) {}
+    void Close() {}
+    uint64_t GetBytesDropped() const { return 0; }
+};
+
+// Second：按几何距离判定链路，poll / simd 每 5 秒重算一次，kinetic 在穿越时刻增量维护。
+// 链路表同时供探测应用查询邻居，拓扑输出关闭时照常计算。
+template <typename S>
+class UavGeometricTopology {
+public:
+    explicit UavGeometricTopology(S& scenario) : m_scenario(scenario) {}
+
+    void Configure(const UavScenarioConfig& c) {
+        m_kineticMode = c.topologyMode == "kinetic";
+        m_simdMode = c.topologyMode == "simd";
+        m_range = c.range;
+        UavLinkBudget budget;
+        if (c.linkModel == "power") {
+            // 与 Wi-Fi 信道一致：LogDistance 默认参数，23 dBm，灵敏度 -85 dBm
+            budget.model = UAV_PATHLOSS_LOG_DISTANCE;
+            budget.txPowerDbm = 23.0;
+            budget.rxSensitivityDbm = -85.0;
+            m_linkKernel.Configure(budget);
+            m_range = m_linkKernel.GetRange();
+        } else {
+            budget.range = m_range;
+            m_linkKernel.Configure(budget);
+        }
+    }
+
+    void Open() {
+        if constexpr (S::kTopologyOutput) {
+            const UavScenarioConfig& c = m_scenario.GetConfig();
+            if (c.deltaTopology) {
+                m_topologyLog.Open(c.outputDir + "/topology-changes.delta", c.numNodes, UAV_SCENARIO_SECOND, 30.0,
+                                   c.traceOptions);
+            } else {
+                m_topologyFile.open(c.outputDir + "/topology-changes.txt", c.traceOptions);
+            }
+            if (m_kineticMode) {
+                m_linkEventFile.open(c.outputDir + "/link-events.txt", c.traceOptions);
+            }
+        }
+    }
+
+    // 副本在预热后重新打开输出：增量日志先写一帧当前链路，之后的单条变化才有基准
+    void Reopen() {
+        Open();
+        if constexpr (S::kTopologyOutput) {
+            if (m_topologyLog.IsOpen()) {
+                if (m_kineticMode) {
+                    m_linkBuffer.clear();
+                    m_kinetic.ForEachLink([this](uint32_t i, uint32_t j) {
+                        m_linkBuffer.emplace_back(i, j);
+                    });
+                }
+                m_topologyLog.Update(Simulator::Now().GetSeconds(), m_linkBuffer);
+            }
+        }
+    }
+
+    void Start() {
+        NodeContainer& nodes = m_scenario.GetNodes();
+        double simulationTime = m_scenario.GetConfig().duration;
+        // kinetic 模式：GaussMarkov 速度上限取平均速度上限再留余量，超出时自动放大
+        if (m_kineticMode) {
+            m_kinetic.Install(nodes, m_range, m_scenario.GetConfig().speed + 10.0, Seconds(1.0));
+            if constexpr (S::kTopologyOutput) {
+                m_kinetic.SetLinkChangeCallback(MakeCallback(&UavGeometricTopology::LinkChanged, this));
+            }
+            m_kinetic.Start(Seconds(0.1));
+        }
+        Simulator::Schedule(Seconds(0.1), &UavGeometricTopology::Update, this);
+        for (double t = UPDATE_INTERVAL; t < simulationTime; t += UPDATE_INTERVAL) {
+            Simulator::Schedule(Seconds(t), &UavGeometricTopology::Update, this);
+        }
+    }
+
+    void Finish(double) {}
+
+    void Close() {
+        m_topologyFile.close();
+        m_topologyLog.Close();
+        m_linkEventFile.close();
+    }
+
+    uint64_t GetBytesDropped() const {
+        return m_topologyFile.GetWriter().GetBytesDropped() + m_topologyLog.GetWriter().GetBytesDropped() +
+               m_linkEventFile.GetWriter().GetBytesDropped();
+    }
+
+    // kinetic 模式下直接取当前邻居，不必等下一次拓扑快照
+    template <typename Fn>
+    void ForEachNeighbor(uint32_t nodeId, Fn fn) const {
+        if (m_kineticMode) {
+            if (nodeId < m_kinetic.GetNumNodes()) {
+                m_kinetic.ForEachNeighbor(nodeId, fn);
+            }
+        } else if (nodeId < m_activeLinks.GetNumNodes()) {
+            m_activeLinks.ForEachNeighbor(nodeId, fn);
+        }
+    }
+
+private:
+    static constexpr double UPDATE_INTERVAL = 5.0;
+
+    void Update() {
+        UAV_PROFILE_SCOPE(UAV_PROFILE_UPDATE_TOPOLOGY);
+        const UavMobilitySnapshot& positions = m_scenario.GetPositions();
+        m_linkBuffer.clear();
+        if (m_kineticMode) {
+            m_kinetic.ForEachLink([this](uint32_t i, uint32_t j) {
+                m_linkBuffer.emplace_back(i, j);
+            });
+        } else if (m_simdMode) {
+            const double *x, *y, *z;
+            if (positions.GetMode() == UavMobilitySnapshot::SNAPSHOT) {
+                x = positions.GetX().data();
+                y = positions.GetY().data();
+                z = positions.GetZ().data();
+            } else {
+                positions.GetPositions(m_positionBuffer);
+                uint32_t n = m_positionBuffer.size();
+                m_soaX.resize(n);
+                m_soaY.resize(n);
+                m_soaZ.resize(n);
+                for (uint32_t i = 0; i < n; ++i) {
+                    m_soaX[i] = m_positionBuffer[i].x;
+                    m_soaY[i] = m_positionBuffer[i].y;
+                    m_soaZ[i] = m_positionBuffer[i].z;
+                }
+                x = m_soaX.data();
+                y = m_soaY.data();
+                z = m_soaZ.data();
+            }
+            m_linkKernel.ForEachLink(x, y, z, positions.GetN(), [this](uint32_t i, uint32_t j) {
+                m_linkBuffer.emplace_back(i, j);
+            });
+        } else {
+            std::vector<Vector>& pos = m_positionBuffer;
+            positions.GetPositions(pos);
+            m_grid.Build(pos, m_range);
+            m_grid.ForEachCandidatePair([&](uint32_t i, uint32_t j) {
+                if (CalculateDistance(pos[i], pos[j]) <= m_range) {
+                    m_linkBuffer.emplace_back(i, j);
+                }
+            });
+        }
+        m_activeLinks.Build(m_scenario.GetNodes().GetN(), m_linkBuffer);
+
+        if constexpr (S::kTopologyOutput) {
+            double timeNow = Simulator::Now().GetSeconds();
+            if (m_topologyLog.IsOpen()) {
+                m_topologyLog.Update(timeNow, m_linkBuffer);
+                return;
+            }
+            UAV_TRACE_TEXT(UAV_PROFILE_UPDATE_TOPOLOGY, m_topologyFile);
+            m_topologyFile << "Time: " << timeNow << "s | Active Links: ";
+            for (uint32_t i = 0; i < m_activeLinks.GetNumNodes(); ++i) {
+                m_activeLinks.ForEachNeighbor(i, [this, i](uint32_t j) {
+                    m_topologyFile << i << "<->" << j << " ";
+                });
+            }
+            m_topologyFile << "\n";
+        }
+    }
+
+    void LinkChanged(uint32_t i, uint32_t j, bool up) {
+        double timeNow = Simulator::Now().GetSeconds();
+        m_linkEventFile << timeNow << "," << i << "," << j << "," << (up ? "UP" : "DOWN") << "\n";
+        if (m_topologyLog.IsOpen()) {
+            if (up) {
+                m_topologyLog.AddLink(timeNow, i, j);
+            } else {
+                m_topologyLog.RemoveLink(timeNow, i, j);
+            }
+        }
+    }
+
+    S& m_scenario;
+    bool m_kineticMode = false;
+    bool m_simdMode = false;
+    double m_range = 250.0;
+    UavLinkTable m_activeLinks;
+    UavSpatialGrid m_grid;
+    UavLinkKernel m_linkKernel;
+    UavKineticTopology m_kinetic;
+    std::vector<UavLinkTable::Edge> m_linkBuffer;
+    std::vector<Vector> m_positionBuffer;
+    std::vector<double> m_soaX, m_soaY, m_soaZ;
+    UavAsyncOfstream m_topologyFile;
+    UavTopologyLogWriter m_topologyLog;
+    UavAsyncOfstream m_linkEventFile;
+};
+
+// Third：按时间窗口从观测到的收发推断活动链路（见 uav-window-links.h），只用于输出，
+// 拓扑输出关闭时整体不启用
+template <typename S>
+class UavWindowTopology {
+public:
+    explicit UavWindowTopology(S& scenario) : m_scenario(scenario) {}
+
+    void Configure(const UavScenarioConfig& c) {
+        if constexpr (S::kTopologyOutput) {
+            // 步长缺省时等于窗口长度（不重叠）
+            double stride = c.stride > 0.0 ? c.stride : c.window;
+            NS_ABORT_MSG_UNLESS(m_windows.Configure(c.window, stride),
+                                "window must be a positive multiple of stride: " << c.window << "/" << stride);
+            m_precision = (c.window == std::floor(c.window) && stride == std::floor(stride)) ? 0 : 3;
+            m_windows.SetCallback([this](const UavLinkWindow& window) { Output(window); });
+        }
+    }
+
+    void Open() {
+        if constexpr (S::kTopologyOutput) {
+            const UavScenarioConfig& c = m_scenario.GetConfig();
+            if (c.deltaTopology) {
+                m_topologyLog.Open(c.outputDir + "/topology-changes.delta", c.numNodes, UAV_SCENARIO_THIRD, 30.0,
+                                   c.traceOptions);
+            } else {
+                m_topologyFile.open(c.outputDir + "/topology-changes.txt", c.traceOptions);
+            }
+        }
+    }
+
+    // 副本在预热后重新打开输出；跨过预热时刻的窗口在副本中输出
+    void Reopen() { Open(); }
+
+    // 只保留下一次窗口关闭事件，不随仿真时长预先排满
+    void Start() {
+        if constexpr (S::kTopologyOutput) {
+            const UavScenarioConfig& c = m_scenario.GetConfig();
+            if (c.graphTensors) {
+                // 两种 PHY 都是 LogDistance 损耗、28 dBm 发射、-90 dBm 灵敏度
+                UavLinkBudget budget;
+                budget.model = UAV_PATHLOSS_LOG_DISTANCE;
+                budget.txPowerDbm = 28.0;
+                budget.rxSensitivityDbm = -90.0;
+                NS_ABORT_MSG_UNLESS(m_graphExport.Open(c.outputDir + "/graph-tensors", m_scenario.GetNodes(),
+                                                       m_windows.GetWindow(), m_windows.GetStride(), c.graphChunk,
+                                                       budget),
+                                    "Cannot write graph tensors to " << c.outputDir << "/graph-tensors");
+            }
+            double simulationTime = c.duration;
+            if (m_windows.GetNextWindowEnd() < simulationTime) {
+                Simulator::Schedule(Seconds(m_windows.GetNextWindowEnd()), &UavWindowTopology::CloseWindows, this,
+                                    simulationTime);
+            }
+        }
+    }
+
+    void Observe(double time, uint32_t a, uint32_t b, uint64_t bytes) { m_windows.Observe(time, a, b, bytes); }
+
+    // 每节点收发计数，只在导出图张量时使用
+    void CountPacket(double time, uint32_t nodeId, bool isTx) {
+        if (m_graphExport.IsOpen()) {
+            m_windows.AdvanceTo(time);
+            m_graphExport.CountPacket(time, nodeId, isTx);
+        }
+    }
+
+    // 输出尚未关闭的窗口（结束时刻与 Stop 同时或更晚的窗口）
+    void Finish(double simulationTime) {
+        if constexpr (S::kTopologyOutput) {
+            m_windows.Finish(simulationTime);
+            if (m_graphExport.IsOpen()) {
+                uint64_t windows = m_graphExport.GetWindows(), edges = m_graphExport.GetEdges();
+                if (m_graphExport.Close()) {
+                    std::cout << "Graph tensors: " << windows << " windows, " << edges << " edges" << std::endl;
+                } else {
+                    std::cerr << "Graph tensors: write error in " << m_scenario.GetConfig().outputDir
+                              << "/graph-tensors" << std::endl;
+                }
+            }
+        }
+    }
+
+    void Close() {
+        m_topologyFile.close();
+        m_topologyLog.Close();
+    }
+
+    uint64_t GetBytesDropped() const {
+        return m_topologyFile.GetWriter().GetBytesDropped() + m_topologyLog.GetWriter().GetBytesDropped();
+    }
+
+private:
+    void CloseWindows(double simulationTime) {
+        m_windows.AdvanceTo(Simulator::Now().GetSeconds());
+        double next = m_windows.GetNextWindowEnd();
+        if (next < simulationTime) {
+            Simulator::Schedule(Seconds(next) - Simulator::Now(), &UavWindowTopology::CloseWindows, this,
+                                simulationTime);
+        }
+    }
+
+    void Output(const UavLinkWindow& window) {
+        UAV_PROFILE_SCOPE(UAV_PROFILE_TOPOLOGY_OUTPUT);
+        double start = window.start;
+        double end = start + m_windows.GetWindow();
+        if (m_graphExport.IsOpen()) {
+            m_graphExport.Write(window);
+        }
+        if (m_topologyLog.IsOpen()) {
+            // 以窗口起点为时间戳，只写出与上一窗口的差异
+            m_linkBuffer.clear();
+            for (const UavWindowEdge& e : window.edges) {
+                m_linkBuffer.push_back(std::make_pair(e.i, e.j));
+            }
+            m_topologyLog.Update(start, m_linkBuffer);
+            return;
+        }
+        UAV_TRACE_TEXT(UAV_PROFILE_TOPOLOGY_OUTPUT, m_topologyFile);
+        m_topologyFile << std::fixed << std::setprecision(m_precision) << start << "-" << end << "s: ";
+        if (window.edges.empty()) {
+            m_topologyFile << "none";
+        } else {
+            bool first = true;
+            for (const UavWindowEdge& e : window.edges) {
+                if (!first) {
+                    m_topologyFile << ", ";
+                }
+                m_topologyFile << "Node" << e.i << "-Node" << e.j;
+                first = false;
+            }
+        }
+        m_topologyFile << std::endl;
+    }
+
+    S& m_scenario;
+    UavWindowLinkInference m_windows;
+    int m_precision = 0;           // 窗口参数都是整数秒时为 0
+    std::vector<UavTopologyLogWriter::Edge> m_linkBuffer;
+    UavAsyncOfstream m_topologyFile;
+    UavTopologyLogWriter m_topologyLog;
+    UavGraphExporter m_graphExport;
+};
+
+// ---- 预设 ----
+
+// First：MAC 层发送记录（uav-packet-sent），FlowMonitor
+struct UavFirstPreset {
+    typedef UavBoxMobility Mobility;
+    typedef UavFriisRadio Radio;
+    typedef UavAodvRouting Routing;
+    template <typename S> using Traffic = UavRingTraffic<S>;
+    template <typename S> using Topology = UavNoTopology<S>;
+    typedef UavFirstTextFormat TextFormat;
+
+    static constexpr UavTraceScenario kScenario = UAV_SCENARIO_FIRST;
+    static constexpr const char* kTransmissionFile = "uav-packet-sent";
+    static constexpr const char* kNarrowNetwork = "10.1.1.0";
+    static constexpr const char* kWideNetwork = "10.1.0.0";
+    static constexpr bool kFlowMonitor = true;
+    static constexpr double kDuration = 60.0;
+    static constexpr uint32_t kSeed = 1;
+};
+
+// Second：探测收发记录（node-transmissions）+ 几何拓扑（topology-changes），FlowMonitor
+struct UavSecondPreset {
+    typedef UavBoxMobility Mobility;
+    typedef UavDefaultChannelRadio Radio;
+    typedef UavAodvRouting Routing;
+    template <typename S> using Traffic = UavProbeTraffic<S>;
+    template <typename S> using Topology = UavGeometricTopology<S>;
+    typedef UavSecondTextFormat TextFormat;
+
+    static constexpr UavTraceScenario kScenario = UAV_SCENARIO_SECOND;
+    static constexpr const char* kTransmissionFile = "node-transmissions";
+    static constexpr const char* kNarrowNetwork = "10.1.1.0";
+    static constexpr const char* kWideNetwork = "10.1.0.0";
+    static constexpr bool kFlowMonitor = true;
+    static constexpr double kDuration = 60.0;
+    static constexpr uint32_t kSeed = 12345;
+};
+
+// Third：IP 层 TCP 收发记录（node-transmissions）+ 窗口推断拓扑（topology-changes）
+struct UavThirdPreset {
+    typedef UavWideStartMobility Mobility;
+    typedef UavConstantRateRadio Radio;
+    typedef UavNoRouting Routing;
+    template <typename S> using Traffic = UavRandomTcpTraffic<S>;
+    template <typename S> using Topology = UavWindowTopology<S>;
+    typedef UavThirdTextFormat TextFormat;
+
+    static constexpr UavTraceScenario kScenario = UAV_SCENARIO_THIRD;
+    static constexpr const char* kTransmissionFile = "node-transmissions";
+    static constexpr const char* kNarrowNetwork = "10.0.0.0";
+    static constexpr const char* kWideNetwork = "10.0.0.0";
+    static constexpr bool kFlowMonitor = false;
+    static constexpr double kDuration = 100.0;
+    static constexpr uint32_t kSeed = 1;
+};
+
+} // namespace ns3
+
+#endif // UAV_PRESETS_H
@@ -0,0 +1,232 @@
+#ifndef UAV_SCENARIO_MAIN_H
+#define UAV_SCENARIO_MAIN_H
+
+#include "ns3/core-module.h"
+
+#include "uav-scenario.h"
+#include "uav-presets.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 场景程序的入口：命令行参数、参数检查和按输出组合实例化场景。
+// Scenario 用 --preset 选择预设，First/Second/Third 各自固定一个预设，命令行参数与原程序相同。
+
+namespace ns3 {
+
+// 按传输记录格式选择输出部件；每种组合是一个独立实例化的场景
+template <typename Preset, bool kTopology>
+int RunWithTopology(const UavScenarioConfig& config, bool transmissions, const std::string& traceFormat) {
+    if (!transmissions) {
+        return UavScenario<Preset, UavNoTransmissionSink, kTopology>().Run(config);
+    }
+    if (traceFormat == "binary") {
+        return UavScenario<Preset, UavBinaryTransmissionSink, kTopology>().Run(config);
+    }
+    return UavScenario<Preset, UavTextTransmissionSink<typename Preset::TextFormat>, kTopology>().Run(config);
+}
+
+template <typename Preset>
+int RunPreset(const UavScenarioConfig& config, const std::string& traces, const std::string& traceFormat) {
+    bool transmissions = traces == "all" || traces == "transmissions";
+    if (traces == "all" || traces == "topology") {
+        return RunWithTopology<Preset, true>(config, transmissions, traceFormat);
+    }
+    return RunWithTopology<Preset, false>(config, transmissions, traceFormat);
+}
+
+// 只对部分预设有效的参数。固定预设时只注册适用于它的参数，其余参数像原程序一样被 CommandLine 拒绝；
+// 由 --preset 选择时全部注册（--help 中以 "second:" 等前缀标明），给出不适用于所选预设的参数则退出
+class UavPresetOptions {
+public:
+    UavPresetOptions(CommandLine& cmd, const std::string& preset, bool fixedPreset)
+        : m_cmd(cmd), m_preset(preset), m_fixedPreset(fixedPreset) {}
+
+    // presets 为以 '/' 分隔的预设名，与说明文字的前缀相同
+    template <typename T>
+    void Add(const std::string& presets, const std::string& name, const std::string& help, T& value) {
+        bool applies = ("/" + presets + "/").find("/" + m_preset + "/") != std::string::npos;
+        if (m_fixedPreset && !applies) {
+            return;
+        }
+        m_cmd.AddValue(name, presets + ": " + help, value);
+        if (!applies) {
+            m_foreign.push_back(name);
+        }
+    }
+
+    // 在 CommandLine::Parse 之后调用
+    void Check(int argc, char *argv[]) const {
+        for (int i = 1; i < argc; ++i) {
+            // CommandLine 接受 "--name"、"-name" 以及 "=value" 形式
+            std::string arg = argv[i];
+            size_t start = arg.find_first_not_of('-');
+            if (start == 0 || start == std::string::npos) {
+                continue;
+            }
+            std::string name = arg.substr(start, arg.find('=') - start);
+            NS_ABORT_MSG_IF(std::find(m_foreign.begin(), m_foreign.end(), name) != m_foreign.end(),
+                            "--" << name << " does not apply to --preset=" << m_preset);
+        }
+    }
+
+private:
+    CommandLine& m_cmd;
+    std::string m_preset;
+    bool m_fixedPreset;
+    std::vector<std::string> m_foreign;   // 已注册但不适用于所选预设的参数
+};
+
+// 解析命令行并运行场景，program 为 CommandLine 显示的程序名（调用方的 __FILE__）。
+// preset 非空时固定为该预设，不接受 --preset（First/Second/Third 的入口）；为空时由 --preset 选择，默认 first
+inline int UavScenarioMain(int argc, char *argv[], const std::string& program, std::string preset = "") {
+    bool fixedPreset = !preset.empty();
+    if (!fixedPreset) {
+        // 预设决定 duration 和 seed 的默认值，先于其他参数取出
+        preset = "first";
+        for (int i = 1; i < argc; ++i) {
+            if (std::strncmp(argv[i], "--preset=", 9) == 0) {
+                preset = argv[i] + 9;
+            }
+        }
+    }
+    UavScenarioConfig config;
+    uint32_t seed = 1;
+    if (preset == "first") {
+        config.duration = UavFirstPreset::kDuration;
+        seed = UavFirstPreset::kSeed;
+    } else if (preset == "second") {
+        config.duration = UavSecondPreset::kDuration;
+        seed = UavSecondPreset::kSeed;
+    } else if (preset == "third") {
+        config.duration = UavThirdPreset::kDuration;
+        seed = UavThirdPreset::kSeed;
+    } else {
+        NS_ABORT_MSG("Unknown preset: " << preset);
+    }
+
+    uint32_t run = 1;
+    std::string traces = "all";          // 编译期选择的输出组合，见 uav-scenario.h
+    std::string traceFormat = "text";
+    std::string tracePolicy = "block";
+    std::string positionMode = "exact";
+    std::string phyMode = "wifi";
+    std::string flowStats = "xml";
+    std::string topologyFormat = "text";
+    std::string traffic = "onoff";
+    std::string burstProtocol = "tcp";
+    std::string traceFilter;
+
+    CommandLine cmd(program);
+    UavPresetOptions options(cmd, preset, fixedPreset);
+    if (!fixedPreset) {
+        cmd.AddValue("preset", "Scenario preset: first|second|third", preset);
+    }
+    cmd.AddValue("traces", "Trace outputs compiled in: all|transmissions|topology|none", traces);
+    cmd.AddValue("numNodes", "Number of UAVs", config.numNodes);
+    cmd.AddValue("area", "Side of the square flight area in meters", config.area);
+    cmd.AddValue("speed", "Mean UAV speed in m/s (drawn from speed +/- 5)", config.speed);
+    cmd.AddValue("duration", "Simulation time in seconds", config.duration);
+    cmd.AddValue("seed", "RNG seed", seed);
+    cmd.AddValue("run", "RNG run number (independent replication)", run);
+    cmd.AddValue("outputDir", "Directory for all output files", config.outputDir);
+    cmd.AddValue("traceFormat", "Transmission trace format (text|binary)", traceFormat);
+    cmd.AddValue("stats", "Write run-stats.txt/run-stats.json and print a runtime summary", config.writeStats);
+    cmd.AddValue("statsInterval", "Sampling period of event rate and queue depth with --stats, in seconds", config.statsInterval);
+    cmd.AddValue("asyncTrace", "Write trace files from a background thread", config.traceOptions.async);
+    cmd.AddValue("traceBufferKb", "Size of each trace buffer in KiB", config.traceOptions.bufferKb);
+    cmd.AddValue("traceBuffers", "Trace buffers per file (bounds trace memory)", config.traceOptions.numBuffers);
+    cmd.AddValue("tracePolicy", "When all trace buffers are full: block|drop", tracePolicy);
+    cmd.AddValue("traceFilter", "Record only matching transmissions, e.g. 'nodes=0-4;events=tx-data;time=10-50;sample=10'", traceFilter);
+    cmd.AddValue("positionMode", "Node positions in traces: exact|snapshot|interpolate", positionMode);
+    cmd.AddValue("positionStep", "Refresh period of the position snapshot in seconds", config.positionStep);
+    cmd.AddValue("recordTrajectory", "Write the flight paths to this trajectory file", config.recordTrajectory);
+    cmd.AddValue("replayTrajectory", "Replay flight paths from this trajectory file instead of Gauss-Markov", config.replayTrajectory);
+    cmd.AddValue("trajectoryStep", "Sampling period of --recordTrajectory in seconds", config.trajectoryStep);
+    cmd.AddValue("phyMode", "Radio model: wifi (802.11ac) or abstract (range + collision)", phyMode);
+    options.Add("first/second", "flowStats", "flow statistics, xml (end of run) or stream (per-interval CSV)", flowStats);
+    options.Add("first/second", "flowInterval", "interval of --flowStats=stream in seconds", config.flowInterval);
+    options.Add("second/third", "topologyFormat", "topology log format (text|delta)", topologyFormat);
+    options.Add("second", "range", "geometric communication range in meters", config.range);
+    options.Add("second", "topologyMode", "link detection, poll|simd|kinetic", config.topologyMode);
+    options.Add("second", "linkModel", "link rule, range (--range) or power (received power vs Rx sensitivity)", config.linkModel);
+    options.Add("third", "window", "topology inference window length in seconds", config.window);
+    options.Add("third", "stride", "start-to-start spacing of topology windows (0 = window, no overlap)", config.stride);
+    options.Add("third", "verbose", "enable OnOffApplication/PacketSink logging", config.verbose);
+    options.Add("third", "traffic", "sender applications, onoff (one OnOff app per burst) or burst (one pooled app per node)", traffic);
+    options.Add("third", "burstRate", "burst draws per second", config.burst.rate);
+    options.Add("third", "burstProbability", "probability that a draw starts a burst", config.burst.probability);
+    options.Add("third", "burstBytes", "bytes per burst", config.burst.minBytes);
+    options.Add("third", "burstBytesMax", "upper bound of a uniform burst size (0 = burstBytes)", config.burst.maxBytes);
+    options.Add("third", "burstProtocol", "burst transport, tcp (pooled connections) or udp", burstProtocol);
+    options.Add("third", "maxConnections", "TCP connections kept open per node", config.maxConnections);
+    options.Add("third", "graphTensors", "write per-window graph tensors (NPY chunks) to <outputDir>/graph-tensors", config.graphTensors);
+    options.Add("third", "graphChunk", "windows per graph tensor chunk", config.graphChunk);
+    cmd.AddValue("replicas", "Fork this many replicas from the state at --warmup, each with its own run number (0 = off)", config.replicas);
+    cmd.AddValue("warmup", "Warm-up time shared by all --replicas, in seconds", config.warmup);
+    cmd.AddValue("replicaJobs", "Replicas running at the same time (0 = number of CPUs)", config.replicaJobs);
+    cmd.Parse(argc, argv);
+    options.Check(argc, argv);
+
+    NS_ABORT_MSG_UNLESS(traces == "all" || traces == "transmissions" || traces == "topology" || traces == "none",
+                        "Unknown trace selection: " << traces);
+    NS_ABORT_MSG_UNLESS(traceFormat == "text" || traceFormat == "binary",
+                        "Unknown trace format: " << traceFormat);
+    NS_ABORT_MSG_UNLESS(UavParseBackPressure(tracePolicy, config.traceOptions.policy),
+                        "Unknown trace policy: " << tracePolicy);
+    NS_ABORT_MSG_UNLESS(UavMobilitySnapshot::ParseMode(positionMode, config.positionMode),
+                        "Unknown position mode: " << positionMode);
+    std::string filterError;
+    NS_ABORT_MSG_UNLESS(config.traceFilter.Parse(traceFilter, &filterError), filterError);
+    NS_ABORT_MSG_UNLESS(phyMode == "wifi" || phyMode == "abstract",
+                        "Unknown PHY mode: " << phyMode);
+    config.abstractPhy = phyMode == "abstract";
+    NS_ABORT_MSG_UNLESS(flowStats == "xml" || flowStats == "stream",
+                        "Unknown flow statistics mode: " << flowStats);
+    NS_ABORT_MSG_UNLESS(config.flowInterval > 0.0, "--flowInterval must be positive");
+    config.flowStream = flowStats == "stream";
+    NS_ABORT_MSG_UNLESS(topologyFormat == "text" || topologyFormat == "delta",
+                        "Unknown topology format: " << topologyFormat);
+    config.deltaTopology = topologyFormat == "delta";
+    NS_ABORT_MSG_UNLESS(config.topologyMode == "poll" || config.topologyMode == "simd" || config.topologyMode == "kinetic",
+                        "Unknown topology mode: " << config.topologyMode);
+    NS_ABORT_MSG_UNLESS(config.linkModel == "range" || config.linkModel == "power",
+                        "Unknown link model: " << config.linkModel);
+    NS_ABORT_MSG_UNLESS(traffic == "onoff" || traffic == "burst",
+                        "Unknown traffic mode: " << traffic);
+    config.burstTraffic = traffic == "burst";
+    NS_ABORT_MSG_UNLESS(burstProtocol == "tcp" || burstProtocol == "udp",
+                        "Unknown burst protocol: " << burstProtocol);
+    config.burstUdp = burstProtocol == "udp";
+    NS_ABORT_MSG_UNLESS(config.burst.rate > 0.0, "--burstRate must be positive");
+    NS_ABORT_MSG_UNLESS(config.maxConnections > 0, "--maxConnections must be positive");
+    NS_ABORT_MSG_UNLESS(config.graphChunk > 0, "--graphChunk must be positive");
+    // 图张量在 third 的窗口拓扑里导出，拓扑输出编译掉时不会写出任何内容
+    NS_ABORT_MSG_UNLESS(!config.graphTensors || (preset == "third" && (traces == "all" || traces == "topology")),
+                        "--graphTensors needs --preset=third and --traces=all|topology");
+    if (config.replicas > 0) {
+        NS_ABORT_MSG_UNLESS(config.warmup > 0.0 && config.warmup < config.duration,
+                            "--warmup must be between 0 and --duration with --replicas");
+        // 这些输出在整个运行期间保持打开，无法在预热结束时交给各副本
+        NS_ABORT_MSG_UNLESS(config.recordTrajectory.empty() && !config.flowStream && !config.graphTensors,
+                            "--replicas cannot be combined with --recordTrajectory, --flowStats=stream or --graphTensors");
+    }
+
+    SeedManager::SetSeed(seed);
+    SeedManager::SetRun(run);
+    SystemPath::MakeDirectories(config.outputDir);
+
+    if (preset == "second") {
+        return RunPreset<UavSecondPreset>(config, traces, traceFormat);
+    }
+    if (preset == "third") {
+        return RunPreset<UavThirdPreset>(config, traces, traceFormat);
+    }
+    return RunPreset<UavFirstPreset>(config, traces, traceFormat);
+}
+
+} // namespace ns3
+
+#endif // UAV_SCENARIO_MAIN_H
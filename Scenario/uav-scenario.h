@@ -0,0 +1,383 @@
+#ifndef UAV_SCENARIO_H
+#define UAV_SCENARIO_H
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/flow-monitor-module.h"
+
+#include "../Common/uav-async-writer.h"
+#include "../Common/uav-binary-trace.h"
+#include "../Common/uav-trace-filter.h"
+#include "../Common/uav-address-index.h"
+#include "../Common/uav-profile.h"
+#include "../Common/uav-runtime-stats.h"
+#include "../Common/uav-mobility-snapshot.h"
+#include "../Common/uav-abstract-phy.h"
+#include "../Common/uav-trajectory-mobility.h"
+#include "../Common/uav-flow-stats.h"
+#include "../Common/uav-burst-traffic.h"
+#include "../Common/uav-fork-replicas.h"
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// 统一场景框架
+// 一个场景由预设（见 uav-presets.h）给出的各个部件拼成：
+//   Mobility     移动模型         static void Install(NodeContainer&, const UavScenarioConfig&)
+//   Radio        无线设备         static NetDeviceContainer Install(NodeContainer&, UavAbstractPhyHelper&, const UavScenarioConfig&)
+//   Routing      协议栈与路由     static void Install(NodeContainer&) / static int64_t AssignStreams(NodeContainer&, int64_t)
+//   Traffic<S>   业务与收发回调   Configure / InstallReceivers / InstallSenders / Reseed / Connect / Finish
+//   Topology<S>  拓扑跟踪与输出   Configure / Open / Reopen / Start / Finish / Close / GetBytesDropped
+// 传输记录的输出（Transmissions）和拓扑输出开关（kTopology）是模板参数：关闭的输出连同它的
+// trace 挂接在编译期消去，输出格式的分支也在编译期确定，写记录的代码直接内联进回调。
+// 各步骤按 First/Second/Third 原程序创建对象、消耗随机流和调度事件的顺序执行，
+// 相同种子下输出与原程序一致。
+// --replicas=N 时先跑到 --warmup，再 fork 出 N 个副本（见 uav-fork-replicas.h）：副本 k 以 run 基数 + k
+// 重设移动、无线、路由和业务的随机流，输出写到 outputDir/replica-k/，预热段只计算一次。
+
+namespace ns3 {
+
+// 命令行参数（见 UAV.cc），各预设只使用与自己有关的部分
+struct UavScenarioConfig {
+    uint32_t numNodes = 20;
+    double area = 500.0;                // 移动区域边长（米）
+    double speed = 15.0;                // 平均速度（m/s），实际取 speed±5
+    double duration = 60.0;
+    std::string outputDir = ".";
+    bool writeStats = false;
+    double statsInterval = 1.0;
+    UavAsyncOptions traceOptions;
+    UavMobilitySnapshot::Mode positionMode = UavMobilitySnapshot::EXACT;
+    double positionStep = 0.1;
+    std::string recordTrajectory;
+    std::string replayTrajectory;
+    double trajectoryStep = 1.0;
+    bool abstractPhy = false;           // --phyMode=abstract
+    bool flowStream = false;            // --flowStats=stream
+    double flowInterval = 1.0;
+    bool deltaTopology = false;         // --topologyFormat=delta
+    UavTraceFilter traceFilter;         // --traceFilter（见 uav-trace-filter.h）
+    // second
+    double range = 250.0;
+    std::string topologyMode = "poll";
+    std::string linkModel = "range";
+    // third
+    double window = 10.0;
+    double stride = 0.0;
+    bool verbose = true;
+    bool burstTraffic = false;          // --traffic=burst（见 uav-burst-traffic.h）
+    UavBurstSchedule::Options burst;
+    bool burstUdp = false;
+    uint32_t maxConnections = 8;
+    bool graphTensors = false;          // 窗口图张量（见 uav-graph-export.h）
+    uint32_t graphChunk = 256;
+    uint32_t replicas = 0;              // 从预热状态 fork 的副本数，0 为不分副本
+    double warmup = 0.0;                // 预热时长（秒）
+    uint32_t replicaJobs = 0;           // 同时运行的副本数，0 为 CPU 数
+};
+
+// 不输出传输记录：回调不挂接，也不查位置
+struct UavNoTransmissionSink {
+    static constexpr bool enabled = false;
+    static constexpr bool needsPosition = false;
+
+    bool Open(const std::string&, UavTraceScenario, const UavAsyncOptions&) { return true; }
+    void Write(int, double, uint32_t, UavTraceEvent, uint32_t, const Vector&, uint32_t) {}
+    void Close() {}
+    uint64_t GetBytesDropped() const { return 0; }
+};
+
+// 文本传输记录，行格式由预设的 Format 给出（Format::needsPosition 为 false 时不查位置）
+template <typename Format>
+class UavTextTransmissionSink {
+public:
+    static constexpr bool enabled = true;
+    static constexpr bool needsPosition = Format::needsPosition;
+
+    bool Open(const std::string& stem, UavTraceScenario, const UavAsyncOptions& options) {
+        m_file.open(stem + ".txt", options);
+        return m_file.is_open();
+    }
+
+    void Write(int slot, double time, uint32_t node, UavTraceEvent event, uint32_t peer,
+               const Vector& pos, uint32_t bytes) {
+        UAV_TRACE_TEXT(slot, m_file);
+        Format::Write(m_file, time, node, event, peer, pos, bytes);
+    }
+
+    void Close() { m_file.close(); }
+    uint64_t GetBytesDropped() const { return m_file.GetWriter().GetBytesDropped(); }
+
+private:
+    UavAsyncOfstream m_file;
+};
+
+// 二进制传输记录（见 uav-binary-trace.h）
+class UavBinaryTransmissionSink {
+public:
+    static constexpr bool enabled = true;
+    static constexpr bool needsPosition = true;
+
+    bool Open(const std::string& stem, UavTraceScenario scenario, const UavAsyncOptions& options) {
+        return m_trace.Open(stem + ".bin", scenario, options);
+    }
+
+    void Write(int slot, double time, uint32_t node, UavTraceEvent event, uint32_t peer,
+               const Vector& pos, uint32_t bytes) {
+        m_trace.Write(time, node, event, peer, pos.x, pos.y, pos.z, bytes);
+        UAV_TRACE_RECORD(slot, sizeof(UavTraceRecord));
+    }
+
+    void Close() { m_trace.Close(); }
+    uint64_t GetBytesDropped() const { return m_trace.GetWriter().GetBytesDropped(); }
+
+private:
+    UavBinaryTraceWriter m_trace;
+};
+
+template <typename Preset, typename Transmissions, bool kTopology>
+class UavScenario {
+public:
+    typedef typename Preset::template Traffic<UavScenario> Traffic;
+    typedef typename Preset::template Topology<UavScenario> Topology;
+
+    static constexpr bool kTransmissions = Transmissions::enabled;
+    static constexpr bool kTopologyOutput = kTopology;
+
+    UavScenario() : m_traffic(*this), m_topology(*this) {}
+
+    // 正在运行的场景；trace 挂接只接受函数指针（见 uav-trace-hookup.h），回调经此找回场景
+    static UavScenario& Current() { return *CurrentPtr(); }
+
+    int Run(const UavScenarioConfig& config) {
+        CurrentPtr() = this;
+        m_config = config;
+        m_traffic.Configure(m_config);
+        m_topology.Configure(m_config);
+
+        if constexpr (kTransmissions) {
+            NS_ABORT_MSG_UNLESS(m_transmissions.Open(m_config.outputDir + "/" + Preset::kTransmissionFile,
+                                                     Preset::kScenario, m_config.traceOptions),
+                                "Cannot open transmission trace in " << m_config.outputDir);
+        }
+        m_topology.Open();
+        Simulator::ScheduleDestroy(&UavScenario::CloseTraceFiles, this);
+
+        m_nodes.Create(m_config.numNodes);
+        InstallMobility();
+
+        m_devices = Preset::Radio::Install(m_nodes, m_abstractPhy, m_config);
+        Preset::Routing::Install(m_nodes);
+
+        Ipv4AddressHelper address;
+        // 超过 254 个节点时 /24 不够用，改用 /16
+        if (m_config.numNodes <= 254) {
+            address.SetBase(Preset::kNarrowNetwork, "255.255.255.0");
+        } else {
+            address.SetBase(Preset::kWideNetwork, "255.255.0.0");
+        }
+        m_interfaces = address.Assign(m_devices);
+        m_addressIndex.Build(m_nodes);
+
+        m_traffic.InstallReceivers();
+        m_topology.Start();
+        m_traffic.InstallSenders();
+
+        FlowMonitorHelper flowmon;
+        Ptr<FlowMonitor> monitor;
+        UavFlowStatsExporter flowExporter;
+        if constexpr (Preset::kFlowMonitor) {
+            monitor = flowmon.InstallAll();
+            if (m_config.flowStream) {
+                NS_ABORT_MSG_UNLESS(flowExporter.Start(monitor, DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier()),
+                                                       m_config.outputDir, Seconds(m_config.flowInterval),
+                                                       m_config.traceOptions),
+                                    "Cannot open flow statistics files in " << m_config.outputDir);
+            }
+        }
+
+        m_traffic.Connect();
+
+        UavRuntimeStats runtimeStats;
+        if (m_config.writeStats) {
+            runtimeStats.Start(Seconds(m_config.statsInterval));
+        }
+        double simulationTime = m_config.duration;
+        double wallStart = UavWallClock();
+        if (m_config.replicas > 0) {
+            Simulator::Stop(Seconds(m_config.warmup));
+            Simulator::Run();
+            if (!ForkReplicas(wallStart)) {
+                // 父进程：副本都已结束
+                Simulator::Destroy();
+                CurrentPtr() = nullptr;
+                return m_replicas.GetFailures() > 0 ? 1 : 0;
+            }
+            // 副本只统计自己的部分：不含共享的预热，也不含排队等待 fork 的时间
+            wallStart = UavWallClock();
+            Simulator::Stop(Seconds(simulationTime) - Simulator::Now());
+        } else {
+            Simulator::Stop(Seconds(simulationTime));
+        }
+        Simulator::Run();
+        double wallSeconds = UavWallClock() - wallStart;
+        m_topology.Finish(simulationTime);
+        if (m_config.writeStats) {
+            UavProfiler::Get().WriteStats(m_config.outputDir + "/run-stats.txt", simulationTime, wallSeconds,
+                                          Simulator::GetEventCount(), m_config.numNodes);
+            runtimeStats.WriteReport(m_config.outputDir + "/run-stats.json", simulationTime, wallSeconds,
+                                     Simulator::GetEventCount(), m_config.numNodes);
+            runtimeStats.PrintSummary(std::cout, wallSeconds, Simulator::GetEventCount());
+        }
+        m_traffic.Finish();
+        if (m_abstractPhy.GetChannel()) {
+            Ptr<UavRangeChannel> radio = m_abstractPhy.GetChannel();
+            std::cout << "Abstract PHY: " << radio->GetDelivered() << " frames delivered, "
+                      << radio->GetCollisions() << " collisions, " << radio->GetLost() << " lost" << std::endl;
+        }
+
+        if constexpr (Preset::kFlowMonitor) {
+            if (m_config.flowStream) {
+                flowExporter.Finish();
+            } else {
+                monitor->SerializeToXmlFile(m_config.outputDir + "/uav-flowmon.xml", true, true);
+            }
+        }
+        Simulator::Destroy(); // 关闭文件（CloseTraceFiles）
+        CurrentPtr() = nullptr;
+        return 0;
+    }
+
+    // 写一条传输记录；slot 为调用方的计时项（见 uav-profile.h）
+    void Record(int slot, uint32_t nodeId, UavTraceEvent event, uint32_t peer = UAV_TRACE_NO_PEER,
+                uint32_t bytes = 0) {
+        if constexpr (kTransmissions) {
+            double timeNow = Simulator::Now().GetSeconds();
+            if (!m_config.traceFilter.Accept(timeNow, nodeId, event)) {
+                return;
+            }
+            if constexpr (Transmissions::needsPosition) {
+                m_transmissions.Write(slot, timeNow, nodeId, event, peer, m_positions.GetPosition(nodeId), bytes);
+            } else {
+                m_transmissions.Write(slot, timeNow, nodeId, event, peer, Vector(), bytes);
+            }
+        }
+    }
+
+    const UavScenarioConfig& GetConfig() const { return m_config; }
+    NodeContainer& GetNodes() { return m_nodes; }
+    const Ipv4InterfaceContainer& GetInterfaces() const { return m_interfaces; }
+    const UavAddressIndex& GetAddressIndex() const { return m_addressIndex; }
+    const UavMobilitySnapshot& GetPositions() const { return m_positions; }
+    Traffic& GetTraffic() { return m_traffic; }
+    Topology& GetTopology() { return m_topology; }
+
+private:
+    static constexpr int64_t REPLICA_STREAM_BASE = 100;   // 副本重设随机流的起始编号
+
+    static UavScenario*& CurrentPtr() {
+        static UavScenario* current = nullptr;
+        return current;
+    }
+
+    void InstallMobility() {
+        if (!m_config.replayTrajectory.empty()) {
+            // 回放预生成的轨迹，不再计算 GaussMarkov 移动
+            std::string error;
+            NS_ABORT_MSG_UNLESS(UavInstallTrajectory(m_nodes, m_config.replayTrajectory, &error), error);
+        } else {
+            Preset::Mobility::Install(m_nodes, m_config);
+        }
+        if (!m_config.recordTrajectory.empty()) {
+            NS_ABORT_MSG_UNLESS(m_trajectoryRecorder.Start(m_nodes, m_config.recordTrajectory,
+                                                           Seconds(m_config.trajectoryStep), Preset::kScenario),
+                                "Cannot write trajectory file: " << m_config.recordTrajectory);
+        }
+        m_positions.Install(m_nodes, m_config.positionMode, Seconds(m_config.positionStep));
+    }
+
+    // 预热结束后 fork 副本。fork 只复制调用线程，之前须关闭全部输出、等后台写线程退出，
+    // 并冲掉 stdio 缓冲，否则缓冲中的内容会在每个进程里各写一次。
+    // 返回 true 表示当前是副本进程，已切换随机流和输出目录，可以继续仿真
+    bool ForkReplicas(double wallStart) {
+        CloseTraceFiles();
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        double warmupSeconds = UavWallClock() - wallStart;
+        uint32_t replica = m_replicas.Run(m_config.replicas, m_config.replicaJobs);
+        if (replica == 0) {
+            std::string summary = m_config.outputDir + "/replicas.csv";
+            if (!m_replicas.WriteCsv(summary)) {
+                std::cerr << "Cannot write " << summary << std::endl;
+            }
+            std::cout << "Replicas: " << m_config.replicas << " from a " << m_config.warmup << "s warm-up ("
+                      << std::fixed << std::setprecision(3) << warmupSeconds << "s wall), "
+                      << m_replicas.GetFailures() << " failed, see " << summary << std::defaultfloat << std::endl;
+            return false;
+        }
+
+        uint64_t run = SeedManager::GetRun() + replica;
+        SeedManager::SetRun(run);
+        m_config.outputDir += "/replica-" + std::to_string(replica);
+        SystemPath::MakeDirectories(m_config.outputDir);
+        if (!std::freopen((m_config.outputDir + "/stdout.txt").c_str(), "w", stdout)) {
+            std::cerr << "Replica " << replica << ": cannot redirect stdout" << std::endl;
+        }
+        if constexpr (kTransmissions) {
+            NS_ABORT_MSG_UNLESS(m_transmissions.Open(m_config.outputDir + "/" + Preset::kTransmissionFile,
+                                                     Preset::kScenario, m_config.traceOptions),
+                                "Cannot open transmission trace in " << m_config.outputDir);
+        }
+        m_topology.Reopen();
+
+        // 已创建的随机变量按新的 run 重新编号；业务由 Reseed 生成预热之后的部分
+        int64_t stream = REPLICA_STREAM_BASE;
+        for (uint32_t k = 0; k < m_nodes.GetN(); ++k) {
+            stream += m_nodes.Get(k)->GetObject<MobilityModel>()->AssignStreams(stream);
+        }
+        if (m_abstractPhy.GetChannel()) {
+            stream += m_abstractPhy.GetChannel()->AssignStreams(stream);
+        } else {
+            stream += WifiHelper().AssignStreams(m_devices, stream);
+        }
+        Preset::Routing::AssignStreams(m_nodes, stream);
+        m_traffic.Reseed();
+        std::cout << "Replica " << replica << " (run " << run << ") from t=" << Simulator::Now().GetSeconds()
+                  << "s, shared warm-up " << std::fixed << std::setprecision(3) << warmupSeconds << "s wall"
+                  << std::defaultfloat << std::endl;
+        return true;
+    }
+
+    // 由 Simulator::Destroy 调用，等待后台线程把剩余 trace 写完
+    void CloseTraceFiles() {
+        m_transmissions.Close();
+        m_topology.Close();
+        uint64_t dropped = m_transmissions.GetBytesDropped() + m_topology.GetBytesDropped();
+        if (dropped > 0) {
+            std::cerr << "Trace buffers full: " << dropped << " bytes dropped" << std::endl;
+        }
+    }
+
+    UavScenarioConfig m_config;
+    NodeContainer m_nodes;
+    NetDeviceContainer m_devices;
+    Ipv4InterfaceContainer m_interfaces;
+    UavAddressIndex m_addressIndex;           // IP 地址 → 节点号
+    UavMobilitySnapshot m_positions;          // 节点位置（--positionMode）
+    UavTrajectoryRecorder m_trajectoryRecorder;
+    UavAbstractPhyHelper m_abstractPhy;
+    Transmissions m_transmissions;
+    Traffic m_traffic;
+    Topology m_topology;
+    UavForkReplicas m_replicas;
+};
+
+} // namespace ns3
+
+#endif // UAV_SCENARIO_H
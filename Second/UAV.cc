@@ -11,100 +11,172 @@
 #include <map>
 #include <cmath>
 
+#include "../Common/uav-spatial-grid.h"
+#include "../Common/uav-link-table.h"
+#include "../Common/uav-async-writer.h"
+#include "../Common/uav-binary-trace.h"
+#include "../Common/uav-trace-filter.h"
+#include "../Common/uav-trace-hookup.h"
+#include "../Common/uav-address-index.h"
+#include "../Common/uav-profile.h"
+#include "../Common/uav-runtime-stats.h"
+#include "../Common/uav-mobility-snapshot.h"
+#include "../Common/uav-kinetic-topology.h"
+#include "../Common/uav-topology-log.h"
+#include "../Common/uav-abstract-phy.h"
+#include "../Common/uav-link-kernel.h"
+#include "../Common/uav-trajectory-mobility.h"
+#include "../Common/uav-flow-stats.h"
+#include "../Common/uav-link-prober.h"
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("UavAdhocNetwork");
 
-const double SIM_AREA_SIZE = 500.0;     // 仿真区域大小（米）
-// const double UAV_SPEED = 15.0;          // 平均移动速度（m/s）
-const double COMM_RANGE = 250.0;        // 通信有效范围（米）
+double SIM_AREA_SIZE = 500.0;           // 仿真区域大小（米），可由 --area 覆盖
+double UAV_SPEED = 15.0;                // 平均移动速度（m/s），可由 --speed 覆盖
+double COMM_RANGE = 250.0;              // 通信有效范围（米），可由 --range 覆盖
 const double TOPOLOGY_UPDATE_INTERVAL = 5.0;  // 拓扑更新间隔（秒）
 const double PACKET_INTERVAL = 0.5;     // 数据包发送间隔（秒）
 
 NodeContainer nodes;
-std::ofstream topologyFile("topology-changes.txt");
-std::ofstream transmissionFile("node-transmissions.txt");
-std::map<std::pair<uint32_t, uint32_t>, bool> activeLinks; // 当前活动链路
-ApplicationContainer clientApps;
+UavAsyncOfstream topologyFile;
+UavTopologyLogWriter topologyLog;    // 增量拓扑日志（--topologyFormat=delta 时替代 topologyFile）
+UavAsyncOfstream transmissionFile;   // 文本格式传输记录
+UavAsyncOfstream linkEventFile;      // 链路建立/断开事件（--topologyMode=kinetic）
+UavBinaryTraceWriter binaryTrace;    // 二进制格式传输记录（--traceFormat=binary）
+UavLinkTable activeLinks; // 当前活动链路（无向，位矩阵/CSR 自动选择）
+ApplicationContainer proberApps; // 每节点一个常驻的链路探测应用
+UavSpatialGrid topologyGrid; // 邻居检测用的空间网格索引
+std::vector<UavLinkTable::Edge> linkBuffer; // 拓扑更新时复用的边缓冲
+UavAddressIndex addressIndex; // IP 地址 → 节点号
+UavMobilitySnapshot mobilitySnapshot; // 节点位置（--positionMode）
+UavTrajectoryRecorder trajectoryRecorder; // 轨迹录制（--recordTrajectory）
+UavTraceFilter traceFilter; // 记录过滤（--traceFilter），在查位置之前判定
+std::vector<Vector> positionBuffer; // 拓扑更新时复用的位置缓冲
+UavKineticTopology kineticTopology; // 事件驱动的拓扑跟踪（--topologyMode=kinetic）
+bool kineticMode = false;
+UavLinkKernel linkKernel; // 向量化的整群链路判定（--topologyMode=simd）
+bool simdMode = false;
+std::vector<double> soaX, soaY, soaZ; // simd 模式下复用的 SoA 位置缓冲
 
 // // 三维距离计算函数
 // double CalculateDistance(Vector a, Vector b) {
 //     return std::sqrt(std::pow(a.x-b.x,2) + std::pow(a.y-b.y,2) + std::pow(a.z-b.z,2));
 // }
 
+// 地址分配后构建的哈希索引，O(1) 查找，未找到返回 UINT32_MAX
 uint32_t GetNodeIdByIp(Ipv4Address ip) {
-    for (uint32_t i = 0; i < nodes.GetN(); ++i) {
-        if (nodes.Get(i)->GetObject<Ipv4>()->GetAddress(1,0).GetLocal() == ip) {
-            return i;
-        }
-    }
-    return UINT32_MAX;
-}
-
-uint32_t GetNodeIdFromContext(const std::string &context) {
-    // context 形如 "/NodeList/2/DeviceList/0/$ns3::WifiNetDevice/Mac/MacTx"
-    // 我们只要抓出中间那个 "2" 就行
-    std::string prefix = "/NodeList/";
-    size_t startPos = context.find(prefix);
-    if (startPos == std::string::npos) {
-        return 0;
-    }
-    startPos += prefix.size();  // 跳过 "/NodeList/"
-    size_t endPos = context.find('/', startPos);
-    // endPos - startPos 就是节点编号的字符串长度
-    std::string nodeIdStr = context.substr(startPos, endPos - startPos);
-    return std::stoul(nodeIdStr);  // 转成 uint32_t
+    return addressIndex.GetNodeId(ip);
 }
 
 
 // 更新拓扑结构（基于实际位置）
 void UpdateTopology(NodeContainer& nodes) {
-    activeLinks.clear();
-    std::vector<Ptr<MobilityModel>> mob(nodes.GetN());
-    
-    // 获取所有节点位置
-    for (uint32_t i = 0; i < nodes.GetN(); ++i) {
-        mob[i] = nodes.Get(i)->GetObject<MobilityModel>();
-    }
-
-    // 检测有效通信链路
-    for (uint32_t i = 0; i < nodes.GetN(); ++i) {
-        for (uint32_t j = i+1; j < nodes.GetN(); ++j) {
-            double distance = CalculateDistance(mob[i]->GetPosition(), mob[j]->GetPosition());
-            if (distance <= COMM_RANGE) {
-                activeLinks[{i,j}] = true;
-                activeLinks[{j,i}] = true; // 双向链路
+    UAV_PROFILE_SCOPE(UAV_PROFILE_UPDATE_TOPOLOGY);
+    linkBuffer.clear();
+    if (kineticMode) {
+        // 链路状态由 kineticTopology 在穿越时刻维护，这里只取当前快照
+        kineticTopology.ForEachLink([](uint32_t i, uint32_t j) {
+            linkBuffer.emplace_back(i, j);
+        });
+    } else if (simdMode) {
+        // 所有节点对按距离平方一次判定；snapshot 模式直接使用快照的 SoA 数组
+        const double *x, *y, *z;
+        if (mobilitySnapshot.GetMode() == UavMobilitySnapshot::SNAPSHOT) {
+            x = mobilitySnapshot.GetX().data();
+            y = mobilitySnapshot.GetY().data();
+            z = mobilitySnapshot.GetZ().data();
+        } else {
+            mobilitySnapshot.GetPositions(positionBuffer);
+            uint32_t n = positionBuffer.size();
+            soaX.resize(n);
+            soaY.resize(n);
+            soaZ.resize(n);
+            for (uint32_t i = 0; i < n; ++i) {
+                soaX[i] = positionBuffer[i].x;
+                soaY[i] = positionBuffer[i].y;
+                soaZ[i] = positionBuffer[i].z;
             }
+            x = soaX.data();
+            y = soaY.data();
+            z = soaZ.data();
         }
+        linkKernel.ForEachLink(x, y, z, mobilitySnapshot.GetN(), [](uint32_t i, uint32_t j) {
+            linkBuffer.emplace_back(i, j);
+        });
+    } else {
+        std::vector<Vector>& pos = positionBuffer;
+
+        // 获取所有节点位置
+        mobilitySnapshot.GetPositions(pos);
+
+        // 检测有效通信链路：格子边长取 COMM_RANGE，只对相邻格子内的节点对计算距离
+        topologyGrid.Build(pos, COMM_RANGE);
+        topologyGrid.ForEachCandidatePair([&](uint32_t i, uint32_t j) {
+            double distance = CalculateDistance(pos[i], pos[j]);
+            if (distance <= COMM_RANGE) {
+                linkBuffer.emplace_back(i, j); // 双向链路只存一次
+            }
+        });
     }
+    activeLinks.Build(nodes.GetN(), linkBuffer);
 
     // 记录拓扑变化
     double timeNow = Simulator::Now().GetSeconds();
+    if (topologyLog.IsOpen()) {
+        topologyLog.Update(timeNow, linkBuffer); // 只写出与上次的差异
+        return;
+    }
+    UAV_TRACE_TEXT(UAV_PROFILE_UPDATE_TOPOLOGY, topologyFile);
     topologyFile << "Time: " << timeNow << "s | Active Links: ";
-    for (auto& link : activeLinks) {
-        if(link.second) {
-            topologyFile << link.first.first << "<->" << link.first.second << " ";
-        }
+    for (uint32_t i = 0; i < activeLinks.GetNumNodes(); ++i) {
+        activeLinks.ForEachNeighbor(i, [i](uint32_t j) {
+            topologyFile << i << "<->" << j << " ";
+        });
     }
     topologyFile << "\n";
 }
 
+// 链路建立/断开（kinetic 模式下在精确的穿越时刻调用）
+void LogLinkChange(uint32_t i, uint32_t j, bool up) {
+    linkEventFile << Simulator::Now().GetSeconds() << "," << i << "," << j << ","
+                  << (up ? "UP" : "DOWN") << "\n";
+    if (topologyLog.IsOpen()) {
+        if (up) {
+            topologyLog.AddLink(Simulator::Now().GetSeconds(), i, j);
+        } else {
+            topologyLog.RemoveLink(Simulator::Now().GetSeconds(), i, j);
+        }
+    }
+}
+
 // 记录传输事件（包括ACK）
-void LogTransmission(uint32_t nodeId, const std::string& type) {
-    Ptr<Node> node = nodes.Get(nodeId);
-    Ptr<MobilityModel> mobility = node->GetObject<MobilityModel>();
-    Vector pos = mobility->GetPosition();
-    
-    transmissionFile << Simulator::Now().GetSeconds() << ","
+void LogTransmission(uint32_t nodeId, UavTraceEvent type) {
+    UAV_PROFILE_SCOPE(UAV_PROFILE_LOG_TRANSMISSION);
+    double timeNow = Simulator::Now().GetSeconds();
+    if (!traceFilter.Accept(timeNow, nodeId, type)) {
+        return;
+    }
+    Vector pos = mobilitySnapshot.GetPosition(nodeId);
+
+    if (binaryTrace.IsOpen()) {
+        binaryTrace.Write(timeNow, nodeId, type, UAV_TRACE_NO_PEER,
+                          pos.x, pos.y, pos.z);
+        UAV_TRACE_RECORD(UAV_PROFILE_LOG_TRANSMISSION, sizeof(UavTraceRecord));
+        return;
+    }
+    UAV_TRACE_TEXT(UAV_PROFILE_LOG_TRANSMISSION, transmissionFile);
+    transmissionFile << timeNow << ","
                     << nodeId << ","
-                    << type << ","
+                    << UavTraceEventName(type) << ","
                     << pos.x << "," << pos.y << "," << pos.z << "\n";
 }
 
-// 数据包发送回调
-void TxTrace(std::string context, Ptr<const Packet> packet) {
-    uint32_t nodeId = GetNodeIdFromContext(context);
-    LogTransmission(nodeId, "DATA");
+// 数据包发送回调（nodeId 在挂接时已绑定）
+void TxTrace(uint32_t nodeId, Ptr<const Packet> packet) {
+    UAV_PROFILE_SCOPE(UAV_PROFILE_TX_TRACE);
+    LogTransmission(nodeId, UAV_EVENT_DATA);
 }
 
 // // ACK接收回调（修正参数顺序）
@@ -144,86 +216,228 @@ void TxTrace(std::string context, Ptr<const Packet> packet) {
 //     Simulator::Schedule(Seconds(PACKET_INTERVAL), &ScheduleTransmissions);
 // }
 
-void ClientReceiveAck(Ptr<const Packet> packet, const Address& address) {
-    InetSocketAddress inetAddr = InetSocketAddress::ConvertFrom(address);
-    uint32_t nodeId = GetNodeIdByIp(inetAddr.GetIpv4());
-    if(nodeId != UINT32_MAX) {
-        LogTransmission(nodeId, "ACK_RECEIVED");
-    }
+// 客户端收到回显（nodeId 为收到 ACK 的探测节点，挂接时绑定）
+void ClientReceiveAck(uint32_t nodeId, Ptr<const Packet> packet, const Address& address) {
+    UAV_PROFILE_SCOPE(UAV_PROFILE_CLIENT_RECEIVE_ACK);
+    LogTransmission(nodeId, UAV_EVENT_ACK_RECEIVED);
 }
 
 // 服务器接收数据包回调（更名为ServerReceive）
 void ServerReceive(Ptr<const Packet> pkt, const Address& srcAddr, const Address& dstAddr) {
+    UAV_PROFILE_SCOPE(UAV_PROFILE_SERVER_RECEIVE);
     InetSocketAddress srcInet = InetSocketAddress::ConvertFrom(srcAddr);
     uint32_t srcNodeId = GetNodeIdByIp(srcInet.GetIpv4());
     if(srcNodeId != UINT32_MAX) {
-        LogTransmission(srcNodeId, "ACK");
+        LogTransmission(srcNodeId, UAV_EVENT_ACK);
     }
 }
 
-// 更新客户端应用创建逻辑
-void CreateClientApplication(uint32_t src, uint32_t dst) {
-    UdpEchoClientHelper client(nodes.Get(dst)->GetObject<Ipv4>()->GetAddress(1,0).GetLocal(), 2000);
-    client.SetAttribute("MaxPackets", UintegerValue(1));
-    client.SetAttribute("Interval", TimeValue(Seconds(PACKET_INTERVAL)));
-    client.SetAttribute("PacketSize", UintegerValue(512));
-    
-    ApplicationContainer app = client.Install(nodes.Get(src));
-    app.Start(Simulator::Now());
-    app.Stop(Simulator::Now() + Seconds(PACKET_INTERVAL * 0.9));
-    
-    // 绑定客户端接收回调
-    Ptr<UdpEchoClient> clientApp = app.Get(0)->GetObject<UdpEchoClient>();
-    clientApp->TraceConnectWithoutContext("Received", MakeCallback(&ClientReceiveAck));
-    
-    clientApps.Add(app);
+// 探测目标：当前拓扑中该节点的全部邻居（每条活动链路的两端各自探测对方，即双向通信）
+void GetProbeTargets(uint32_t nodeId, std::vector<Ipv4Address>& targets) {
+    UAV_PROFILE_SCOPE(UAV_PROFILE_PROBE_TRANSMISSIONS);
+    auto add = [&targets](uint32_t j) {
+        targets.push_back(addressIndex.GetAddress(j));
+    };
+    if (kineticMode) {
+        // kinetic 模式下直接探测当前邻居，不必等下一次拓扑快照
+        if (nodeId < kineticTopology.GetNumNodes()) {
+            kineticTopology.ForEachNeighbor(nodeId, add);
+        }
+    } else if (nodeId < activeLinks.GetNumNodes()) {
+        activeLinks.ForEachNeighbor(nodeId, add);
+    }
 }
 
-// 修改后的周期发送函数
-void ScheduleTransmissions() {
-    for (auto& link : activeLinks) {
-        if(link.second) {
-            CreateClientApplication(link.first.first, link.first.second);
-            CreateClientApplication(link.first.second, link.first.first); // 双向通信
-        }
+// 为每个节点安装一个常驻探测应用，按 PACKET_INTERVAL 周期向邻居发包
+void InstallProbers(NodeContainer& nodes, double startTime, double stopTime) {
+    for (uint32_t i = 0; i < nodes.GetN(); ++i) {
+        Ptr<UavLinkProber> prober = CreateObject<UavLinkProber>();
+        prober->SetAttribute("Interval", TimeValue(Seconds(PACKET_INTERVAL)));
+        prober->SetAttribute("RemotePort", UintegerValue(2000));
+        prober->SetAttribute("PacketSize", UintegerValue(512));
+        prober->SetDestinationCallback(MakeCallback(&GetProbeTargets));
+        prober->TraceConnectWithoutContext("Rx", MakeBoundCallback(&ClientReceiveAck, nodes.Get(i)->GetId()));
+        nodes.Get(i)->AddApplication(prober);
+        prober->SetStartTime(Seconds(startTime));
+        prober->SetStopTime(Seconds(stopTime));
+        proberApps.Add(prober);
+    }
+}
+
+// 由 Simulator::Destroy 调用，等待后台线程把剩余 trace 写完
+void CloseTraceFiles() {
+    topologyFile.close();
+    topologyLog.Close();
+    transmissionFile.close();
+    linkEventFile.close();
+    binaryTrace.Close();
+    uint64_t dropped = topologyFile.GetWriter().GetBytesDropped() +
+                       topologyLog.GetWriter().GetBytesDropped() +
+                       transmissionFile.GetWriter().GetBytesDropped() +
+                       linkEventFile.GetWriter().GetBytesDropped() +
+                       binaryTrace.GetWriter().GetBytesDropped();
+    if (dropped > 0) {
+        std::cerr << "Trace buffers full: " << dropped << " bytes dropped" << std::endl;
     }
-    Simulator::Schedule(Seconds(PACKET_INTERVAL), &ScheduleTransmissions);
 }
 
 int main(int argc , char *argv[]) {
     uint32_t numNodes = 20;
     double simulationTime = 60.0;
-    SeedManager::SetSeed(12345);
+    uint32_t seed = 12345;
+    uint32_t run = 1;
+    std::string outputDir = ".";
+    std::string traceFormat = "text";
+    bool writeStats = false;
+    double statsInterval = 1.0;        // --stats 的采样周期（仿真秒），见 uav-runtime-stats.h
+    UavAsyncOptions traceOptions;   // 异步 trace 写盘（见 uav-async-writer.h）
+    std::string tracePolicy = "block";
+    std::string positionMode = "exact";  // 位置快照精度档（见 uav-mobility-snapshot.h）
+    double positionStep = 0.1;
+    std::string recordTrajectory;       // 录制 / 回放轨迹文件（见 uav-trajectory-mobility.h）
+    std::string replayTrajectory;
+    double trajectoryStep = 1.0;        // 取 GaussMarkov 的 TimeStep，回放与原轨迹一致
+    std::string topologyMode = "poll";
+    std::string linkModel = "range";    // range 为固定半径，power 按 Wi-Fi 链路预算折算半径（见 uav-link-kernel.h）
+    std::string topologyFormat = "text";
+    std::string flowStats = "xml";       // xml 为结束时的 FlowMonitor XML，stream 见 uav-flow-stats.h
+    double flowInterval = 1.0;
+    std::string phyMode = "wifi";       // wifi 为完整 802.11ac 协议栈，abstract 见 uav-abstract-phy.h
+    std::string traceFilterSpec;        // 见 uav-trace-filter.h
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numNodes", "Number of UAVs", numNodes);
+    cmd.AddValue("area", "Side of the square flight area in meters", SIM_AREA_SIZE);
+    cmd.AddValue("speed", "Mean UAV speed in m/s (drawn from speed +/- 5)", UAV_SPEED);
+    cmd.AddValue("range", "Geometric communication range in meters", COMM_RANGE);
+    cmd.AddValue("duration", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("seed", "RNG seed", seed);
+    cmd.AddValue("run", "RNG run number (independent replication)", run);
+    cmd.AddValue("outputDir", "Directory for all output files", outputDir);
+    cmd.AddValue("traceFormat", "Transmission trace format (text|binary)", traceFormat);
+    cmd.AddValue("stats", "Write run-stats.txt/run-stats.json and print a runtime summary", writeStats);
+    cmd.AddValue("statsInterval", "Sampling period of event rate and queue depth with --stats, in seconds", statsInterval);
+    cmd.AddValue("asyncTrace", "Write trace files from a background thread", traceOptions.async);
+    cmd.AddValue("traceBufferKb", "Size of each trace buffer in KiB", traceOptions.bufferKb);
+    cmd.AddValue("traceBuffers", "Trace buffers per file (bounds trace memory)", traceOptions.numBuffers);
+    cmd.AddValue("tracePolicy", "When all trace buffers are full: block|drop", tracePolicy);
+    cmd.AddValue("positionMode", "Node positions in traces: exact|snapshot|interpolate", positionMode);
+    cmd.AddValue("positionStep", "Refresh period of the position snapshot in seconds", positionStep);
+    cmd.AddValue("recordTrajectory", "Write the flight paths to this trajectory file", recordTrajectory);
+    cmd.AddValue("replayTrajectory", "Replay flight paths from this trajectory file instead of Gauss-Markov", replayTrajectory);
+    cmd.AddValue("trajectoryStep", "Sampling period of --recordTrajectory in seconds", trajectoryStep);
+    cmd.AddValue("topologyFormat", "Topology log format (text|delta)", topologyFormat);
+    cmd.AddValue("topologyMode", "Link detection: poll (grid, every 5 s), simd (all pairs, every 5 s) or kinetic (predicted crossings)", topologyMode);
+    cmd.AddValue("linkModel", "Link rule: range (--range) or power (received power vs Rx sensitivity)", linkModel);
+    cmd.AddValue("phyMode", "Radio model: wifi (802.11ac) or abstract (range + collision)", phyMode);
+    cmd.AddValue("flowStats", "Flow statistics: xml (end of run) or stream (per-interval CSV)", flowStats);
+    cmd.AddValue("flowInterval", "Interval of --flowStats=stream in seconds", flowInterval);
+    cmd.AddValue("traceFilter", "Record only matching transmissions, e.g. 'nodes=0-4;events=tx-data;time=10-50;sample=10'", traceFilterSpec);
+    cmd.Parse(argc, argv);
+
+    SeedManager::SetSeed(seed);
+    SeedManager::SetRun(run);
+    SystemPath::MakeDirectories(outputDir);
+
+    NS_ABORT_MSG_UNLESS(traceFormat == "text" || traceFormat == "binary",
+                        "Unknown trace format: " << traceFormat);
+    NS_ABORT_MSG_UNLESS(UavParseBackPressure(tracePolicy, traceOptions.policy),
+                        "Unknown trace policy: " << tracePolicy);
+    UavMobilitySnapshot::Mode snapshotMode;
+    NS_ABORT_MSG_UNLESS(UavMobilitySnapshot::ParseMode(positionMode, snapshotMode),
+                        "Unknown position mode: " << positionMode);
+    std::string filterError;
+    NS_ABORT_MSG_UNLESS(traceFilter.Parse(traceFilterSpec, &filterError), filterError);
+    NS_ABORT_MSG_UNLESS(topologyMode == "poll" || topologyMode == "simd" || topologyMode == "kinetic",
+                        "Unknown topology mode: " << topologyMode);
+    kineticMode = topologyMode == "kinetic";
+    simdMode = topologyMode == "simd";
+    NS_ABORT_MSG_UNLESS(linkModel == "range" || linkModel == "power",
+                        "Unknown link model: " << linkModel);
+    UavLinkBudget budget;
+    if (linkModel == "power") {
+        // 与下面的 Wi-Fi 信道一致：LogDistance 默认参数，23 dBm，灵敏度 -85 dBm；
+        // 损耗随距离单调，折算成等效半径后 poll/kinetic 模式同样适用
+        budget.model = UAV_PATHLOSS_LOG_DISTANCE;
+        budget.txPowerDbm = 23.0;
+        budget.rxSensitivityDbm = -85.0;
+        linkKernel.Configure(budget);
+        COMM_RANGE = linkKernel.GetRange();
+    } else {
+        budget.range = COMM_RANGE;
+        linkKernel.Configure(budget);
+    }
+    NS_ABORT_MSG_UNLESS(topologyFormat == "text" || topologyFormat == "delta",
+                        "Unknown topology format: " << topologyFormat);
+    NS_ABORT_MSG_UNLESS(phyMode == "wifi" || phyMode == "abstract",
+                        "Unknown PHY mode: " << phyMode);
+    NS_ABORT_MSG_UNLESS(flowStats == "xml" || flowStats == "stream",
+                        "Unknown flow statistics mode: " << flowStats);
+    NS_ABORT_MSG_UNLESS(flowInterval > 0.0, "--flowInterval must be positive");
+    if (topologyFormat == "delta") {
+        topologyLog.Open(outputDir + "/topology-changes.delta", numNodes, UAV_SCENARIO_SECOND, 30.0, traceOptions);
+    } else {
+        topologyFile.open(outputDir + "/topology-changes.txt", traceOptions);
+    }
+    if (traceFormat == "binary") {
+        binaryTrace.Open(outputDir + "/node-transmissions.bin", UAV_SCENARIO_SECOND, traceOptions);
+    } else {
+        transmissionFile.open(outputDir + "/node-transmissions.txt", traceOptions);
+    }
+    if (kineticMode) {
+        linkEventFile.open(outputDir + "/link-events.txt", traceOptions);
+    }
+    Simulator::ScheduleDestroy(&CloseTraceFiles);
 
     nodes.Create(numNodes);
 
-    // 三维移动模型配置
-    MobilityHelper mobility;
-    mobility.SetPositionAllocator("ns3::RandomBoxPositionAllocator",
-        "X", StringValue("ns3::UniformRandomVariable[Min=0|Max=" + std::to_string(SIM_AREA_SIZE) + "]"),
-        "Y", StringValue("ns3::UniformRandomVariable[Min=0|Max=" + std::to_string(SIM_AREA_SIZE) + "]"),
-        "Z", StringValue("ns3::UniformRandomVariable[Min=50|Max=150]"));
-    mobility.SetMobilityModel("ns3::GaussMarkovMobilityModel",
-        "MeanVelocity", StringValue("ns3::UniformRandomVariable[Min=10|Max=20]"),
-        "Bounds", BoxValue(Box(0, SIM_AREA_SIZE, 0, SIM_AREA_SIZE, 50, 150)));
-    mobility.Install(nodes);
+    if (!replayTrajectory.empty()) {
+        // 回放预生成的轨迹，不再计算 GaussMarkov 移动
+        std::string error;
+        NS_ABORT_MSG_UNLESS(UavInstallTrajectory(nodes, replayTrajectory, &error), error);
+    } else {
+        // 三维移动模型配置
+        MobilityHelper mobility;
+        mobility.SetPositionAllocator("ns3::RandomBoxPositionAllocator",
+            "X", StringValue("ns3::UniformRandomVariable[Min=0|Max=" + std::to_string(SIM_AREA_SIZE) + "]"),
+            "Y", StringValue("ns3::UniformRandomVariable[Min=0|Max=" + std::to_string(SIM_AREA_SIZE) + "]"),
+            "Z", StringValue("ns3::UniformRandomVariable[Min=50|Max=150]"));
+        mobility.SetMobilityModel("ns3::GaussMarkovMobilityModel",
+            "MeanVelocity", StringValue("ns3::UniformRandomVariable[Min="+std::to_string(UAV_SPEED-5)+"|Max="+std::to_string(UAV_SPEED+5)+"]"),
+            "Bounds", BoxValue(Box(0, SIM_AREA_SIZE, 0, SIM_AREA_SIZE, 50, 150)));
+        mobility.Install(nodes);
+    }
+    if (!recordTrajectory.empty()) {
+        NS_ABORT_MSG_UNLESS(trajectoryRecorder.Start(nodes, recordTrajectory, Seconds(trajectoryStep), UAV_SCENARIO_SECOND),
+                            "Cannot write trajectory file: " << recordTrajectory);
+    }
+    mobilitySnapshot.Install(nodes, snapshotMode, Seconds(positionStep));
 
     // 无线网络配置
-    YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
-    YansWifiPhyHelper phy;
-    phy.Set("TxPowerStart", DoubleValue(23.0));
-    phy.Set("TxPowerEnd", DoubleValue(23.0));
-    phy.Set("RxSensitivity", DoubleValue(-85.0)); // 接收灵敏度
-    phy.SetChannel(channel.Create());
-
-    WifiMacHelper mac;
-    mac.SetType("ns3::AdhocWifiMac",
-               "QosSupported", BooleanValue(true));
-    
-    WifiHelper wifi;
-    wifi.SetStandard(WIFI_STANDARD_80211ac);
-    wifi.SetRemoteStationManager("ns3::MinstrelHtWifiManager");
-    NetDeviceContainer devices = wifi.Install(phy, mac, nodes);
+    NetDeviceContainer devices;
+    UavAbstractPhyHelper abstractPhy;
+    if (phyMode == "abstract") {
+        // 与 YansWifiChannelHelper::Default 相同的 LogDistance 损耗，功率和灵敏度同下
+        abstractPhy.SetChannelAttribute("TxPower", DoubleValue(23.0));
+        abstractPhy.SetChannelAttribute("RxSensitivity", DoubleValue(-85.0));
+        devices = abstractPhy.Install(nodes);
+    } else {
+        YansWifiChannelHelper channel = YansWifiChannelHelper::Default();
+        YansWifiPhyHelper phy;
+        phy.Set("TxPowerStart", DoubleValue(23.0));
+        phy.Set("TxPowerEnd", DoubleValue(23.0));
+        phy.Set("RxSensitivity", DoubleValue(-85.0)); // 接收灵敏度
+        phy.SetChannel(channel.Create());
+
+        WifiMacHelper mac;
+        mac.SetType("ns3::AdhocWifiMac",
+                   "QosSupported", BooleanValue(true));
+
+        WifiHelper wifi;
+        wifi.SetStandard(WIFI_STANDARD_80211ac);
+        wifi.SetRemoteStationManager("ns3::MinstrelHtWifiManager");
+        devices = wifi.Install(phy, mac, nodes);
+    }
 
     // 协议栈配置
     InternetStackHelper stack;
@@ -232,8 +446,14 @@ int main(int argc , char *argv[]) {
     stack.Install(nodes);
 
     Ipv4AddressHelper address;
-    address.SetBase("10.1.1.0", "255.255.255.0");
+    // 超过 254 个节点时 /24 不够用，改用 /16
+    if (numNodes <= 254) {
+        address.SetBase("10.1.1.0", "255.255.255.0");
+    } else {
+        address.SetBase("10.1.0.0", "255.255.0.0");
+    }
     Ipv4InterfaceContainer interfaces = address.Assign(devices);
+    addressIndex.Build(nodes);
 
     // 初始化ACK服务器
     UdpEchoServerHelper ackServer(2000);
@@ -242,15 +462,22 @@ int main(int argc , char *argv[]) {
     servers.Stop(Seconds(simulationTime));
 
     // 绑定回调函数
-    Config::Connect("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/MacTx", MakeCallback(&TxTrace));
+    UavConnectMacTx(nodes, &TxTrace);
     for (uint32_t i = 0; i < nodes.GetN(); ++i) {
         Ptr<UdpEchoServer> server = servers.Get(i)->GetObject<UdpEchoServer>();
         server->TraceConnectWithoutContext("RxWithAddresses", MakeCallback(&ServerReceive)); // 更名为ServerReceive
     }
 
-    // 调度拓扑更新和包发送
+    // kinetic 模式：GaussMarkov 速度上限取平均速度上限再留余量，超出时自动放大
+    if (kineticMode) {
+        kineticTopology.Install(nodes, COMM_RANGE, UAV_SPEED + 10.0, Seconds(1.0));
+        kineticTopology.SetLinkChangeCallback(MakeCallback(&LogLinkChange));
+        kineticTopology.Start(Seconds(0.1));
+    }
+
+    // 调度拓扑更新和包发送（同一时刻拓扑更新先于首轮探测执行）
     Simulator::Schedule(Seconds(0.1), &UpdateTopology, nodes);
-    Simulator::Schedule(Seconds(0.1), &ScheduleTransmissions);
+    InstallProbers(nodes, 0.1, simulationTime);
     for (double t = TOPOLOGY_UPDATE_INTERVAL; t < simulationTime; t += TOPOLOGY_UPDATE_INTERVAL) {
         Simulator::Schedule(Seconds(t), &UpdateTopology, nodes);
     }
@@ -258,14 +485,40 @@ int main(int argc , char *argv[]) {
     // 流量监控
     FlowMonitorHelper flowmon;
     Ptr<FlowMonitor> monitor = flowmon.InstallAll();
+    UavFlowStatsExporter flowExporter;
+    if (flowStats == "stream") {
+        NS_ABORT_MSG_UNLESS(flowExporter.Start(monitor, DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier()),
+                                               outputDir, Seconds(flowInterval), traceOptions),
+                            "Cannot open flow statistics files in " << outputDir);
+    }
     
+    UavRuntimeStats runtimeStats;
+    if (writeStats) {
+        runtimeStats.Start(Seconds(statsInterval));
+    }
     Simulator::Stop(Seconds(simulationTime));
+    double wallStart = UavWallClock();
     Simulator::Run();
+    double wallSeconds = UavWallClock() - wallStart;
+    if (writeStats) {
+        UavProfiler::Get().WriteStats(outputDir + "/run-stats.txt", simulationTime, wallSeconds,
+                                      Simulator::GetEventCount(), numNodes);
+        runtimeStats.WriteReport(outputDir + "/run-stats.json", simulationTime, wallSeconds,
+                                 Simulator::GetEventCount(), numNodes);
+        runtimeStats.PrintSummary(std::cout, wallSeconds, Simulator::GetEventCount());
+    }
+    if (abstractPhy.GetChannel()) {
+        Ptr<UavRangeChannel> radio = abstractPhy.GetChannel();
+        std::cout << "Abstract PHY: " << radio->GetDelivered() << " frames delivered, "
+                  << radio->GetCollisions() << " collisions, " << radio->GetLost() << " lost" << std::endl;
+    }
 
     // 结果输出
-    monitor->SerializeToXmlFile("uav-flowmon.xml", true, true);
-    topologyFile.close();
-    transmissionFile.close();
-    Simulator::Destroy();
+    if (flowStats == "stream") {
+        flowExporter.Finish();
+    } else {
+        monitor->SerializeToXmlFile(outputDir + "/uav-flowmon.xml", true, true);
+    }
+    Simulator::Destroy(); // 关闭文件（CloseTraceFiles）
     return 0;
 }
\ No newline at end of file
@@ -7,11 +7,25 @@
 #include <fstream>
 #include <iostream>
 #include <string>
-#include <set>
 #include <map>
 #include <algorithm>
 #include <iomanip>
 
+#include "../Common/uav-async-writer.h"
+#include "../Common/uav-binary-trace.h"
+#include "../Common/uav-trace-filter.h"
+#include "../Common/uav-trace-hookup.h"
+#include "../Common/uav-address-index.h"
+#include "../Common/uav-packet-classifier.h"
+#include "../Common/uav-profile.h"
+#include "../Common/uav-runtime-stats.h"
+#include "../Common/uav-mobility-snapshot.h"
+#include "../Common/uav-topology-log.h"
+#include "../Common/uav-window-links.h"
+#include "../Common/uav-abstract-phy.h"
+#include "../Common/uav-trajectory-mobility.h"
+#include "../Common/uav-burst-traffic.h"
+#include "../Common/uav-graph-export.h"
 
 using namespace ns3;
 using namespace std;
@@ -19,226 +33,474 @@ using namespace std;
 NS_LOG_COMPONENT_DEFINE("UavSimulation");
 
 // 全局文件流用于记录事件
-static ofstream g_transFile;
-static ofstream g_topoFile;
-// 链路集合数组（10个区间）
-static std::vector< std::set< std::pair<uint32_t,uint32_t> > > g_intervalLinks(10);
+static UavAsyncOfstream g_transFile;
+static UavAsyncOfstream g_topoFile;
+// 增量拓扑日志（--topologyFormat=delta 时替代 g_topoFile）
+static UavTopologyLogWriter g_topoLog;
+static std::vector<UavTopologyLogWriter::Edge> g_linkBuffer;
+// 二进制格式传输记录（--traceFormat=binary 时替代 g_transFile）
+static UavBinaryTraceWriter g_binTrace;
+// 按时间窗口推断活动链路（--window/--stride，默认每10秒一个不重叠窗口）
+static UavWindowLinkInference g_linkWindows;
+// 窗口标签的小数位数，窗口参数都是整数秒时为 0
+static int g_windowPrecision = 0;
 // IP地址到节点ID的映射表
-static std::map<uint32_t, uint32_t> g_ipToNodeId;
+static UavAddressIndex g_ipToNodeId;
+// 节点位置（--positionMode），二进制记录中的位置从这里取
+static UavMobilitySnapshot g_positions;
+// 轨迹录制（--recordTrajectory）
+static UavTrajectoryRecorder g_trajectoryRecorder;
+// 每个窗口的图张量（--graphTensors）
+static UavGraphExporter g_graphExport;
+// 传输记录过滤（--traceFilter）
+static UavTraceFilter g_traceFilter;
 
 
 
-// IPv4发送事件回调
-static void Ipv4Tracer(std::string context, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+// IPv4收发事件回调（nodeId 与收发方向在挂接时已绑定）
+static void Ipv4Tracer(uint32_t nodeId, bool isTx, Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
 {
-    // 提取 IP 头部
-    Ptr<Packet> pktCopy = packet->Copy();
-    Ipv4Header ipHeader;
-    pktCopy->RemoveHeader(ipHeader);
-
-    if (ipHeader.GetProtocol() != 6) return; // 只处理 TCP 包
-
-    TcpHeader tcpHeader;
-    pktCopy->RemoveHeader(tcpHeader);
-
-    bool isAck = tcpHeader.GetFlags() & TcpHeader::ACK;
-    uint32_t payloadSize = pktCopy->GetSize();
-
-    if (payloadSize == 0 && !isAck) return; // SYN/FIN控制包，不记录
-
-    // 提取当前节点 ID（从 context 中解析）
-    uint32_t nodeId = 0;
-    size_t pos1 = context.find("/NodeList/") + 10;
-    size_t pos2 = context.find("/", pos1);
-    if (pos1 != std::string::npos && pos2 != std::string::npos) {
-        nodeId = atoi(context.substr(pos1, pos2 - pos1).c_str());
-    }
-
-    // 判断是发送还是接收：Tx 或 Rx 会分别传不同 context
-    std::string eventType;
-    if (context.find("/Tx") != std::string::npos) {
-        eventType = (payloadSize > 0) ? "Tx Data" : "Tx Ack";
+    UAV_PROFILE_SCOPE(UAV_PROFILE_IPV4_TRACER);
+    double timeNow = Simulator::Now().GetSeconds();
+    // 节点、时间和抽样条件先判定；拓扑推断要用全部事件，包头仍需解析
+    bool record = g_traceFilter.AcceptNode(timeNow, nodeId);
+    // 按偏移读取 IP/TCP/UDP 头部字段，不复制数据包；UDP（--burstProtocol=udp）负载按数据计
+    UavPacketInfo info;
+    if (!UavClassifyTransport(packet, info)) return;
+
+    bool isAck = info.isAck;
+    uint32_t payloadSize = info.payloadSize;
+
+    if (payloadSize == 0 && !isAck) return; // SYN/FIN控制包或空 UDP 报文，不记录
+
+    UavTraceEvent eventType;
+    if (isTx) {
+        eventType = (payloadSize > 0) ? UAV_EVENT_TX_DATA : UAV_EVENT_TX_ACK;
     } else {
-        eventType = (payloadSize > 0) ? "Rx Data" : "Rx Ack";
+        eventType = (payloadSize > 0) ? UAV_EVENT_RX_DATA : UAV_EVENT_RX_ACK;
     }
 
-    // 写入 transmission 文件
-    g_transFile << std::fixed << std::setprecision(3)
-                << Simulator::Now().GetSeconds() << "s "
-                << "Node" << nodeId << " " << eventType << std::endl;
-
     // 推断通信对端：根据 IP 地址映射节点 ID
     uint32_t peerNodeId = 0;
-    Ipv4Address peerIp = (context.find("/Tx") != std::string::npos) ?
-        ipHeader.GetDestination() : ipHeader.GetSource();
-    auto it = g_ipToNodeId.find(peerIp.Get());
-    if (it != g_ipToNodeId.end()) {
-        peerNodeId = it->second;
+    Ipv4Address peerIp = isTx ? info.destination : info.source;
+    uint32_t found = g_ipToNodeId.GetNodeId(peerIp);
+    bool peerKnown = found != UavAddressIndex::NOT_FOUND;
+    if (peerKnown) {
+        peerNodeId = found;
+    }
+
+    // 写入 transmission 文件（被过滤的事件不查位置、不格式化）
+    if (record && g_traceFilter.AcceptEvent(eventType)) {
+        if (g_binTrace.IsOpen()) {
+            Vector pos = g_positions.GetPosition(nodeId);
+            g_binTrace.Write(timeNow, nodeId, eventType,
+                             peerKnown ? peerNodeId : UAV_TRACE_NO_PEER,
+                             pos.x, pos.y, pos.z, payloadSize);
+            UAV_TRACE_RECORD(UAV_PROFILE_IPV4_TRACER, sizeof(UavTraceRecord));
+        } else {
+            UAV_TRACE_TEXT(UAV_PROFILE_IPV4_TRACER, g_transFile);
+            g_transFile << std::fixed << std::setprecision(3)
+                        << timeNow << "s "
+                        << "Node" << nodeId << " " << UavTraceEventName(eventType) << "\n";
+        }
     }
 
     if (peerNodeId != nodeId) {
         uint32_t a = std::min(nodeId, peerNodeId);
         uint32_t b = std::max(nodeId, peerNodeId);
-        uint32_t idx = std::min((uint32_t)std::floor(Simulator::Now().GetSeconds() / 10.0), (uint32_t)9);
-        g_intervalLinks[idx].insert(std::make_pair(a, b));
+        g_linkWindows.Observe(timeNow, a, b, packet->GetSize());
+    }
+    if (g_graphExport.IsOpen()) {
+        g_linkWindows.AdvanceTo(timeNow);
+        g_graphExport.CountPacket(timeNow, nodeId, isTx);
     }
 }
 
 
-// 每10秒调用，输出拓扑活动链路
-static void TopologyOutput(uint32_t index)
+// 窗口关闭时输出该窗口的活动链路
+static void TopologyOutput(const UavLinkWindow& window)
 {
-    double start = index * 10.0;
-    double end = start + 10.0;
+    UAV_PROFILE_SCOPE(UAV_PROFILE_TOPOLOGY_OUTPUT);
+    double start = window.start;
+    double end = start + g_linkWindows.GetWindow();
+    if (g_graphExport.IsOpen()) {
+        g_graphExport.Write(window);
+    }
+    if (g_topoLog.IsOpen()) {
+        // 以窗口起点为时间戳，只写出与上一窗口的差异
+        g_linkBuffer.clear();
+        for (const UavWindowEdge& e : window.edges) {
+            g_linkBuffer.push_back(std::make_pair(e.i, e.j));
+        }
+        g_topoLog.Update(start, g_linkBuffer);
+        return;
+    }
     // 格式化输出时间段
-    g_topoFile << std::fixed << std::setprecision(0) 
+    UAV_TRACE_TEXT(UAV_PROFILE_TOPOLOGY_OUTPUT, g_topoFile);
+    g_topoFile << std::fixed << std::setprecision(g_windowPrecision)
                << start << "-" << end << "s: ";
-    if (g_intervalLinks[index].empty()) {
+    if (window.edges.empty()) {
         g_topoFile << "none";
     } else {
         bool first = true;
-        for (auto pr : g_intervalLinks[index]) {
+        for (const UavWindowEdge& e : window.edges) {
             if (!first) {
                 g_topoFile << ", ";
             }
-            g_topoFile << "Node" << pr.first << "-Node" << pr.second;
+            g_topoFile << "Node" << e.i << "-Node" << e.j;
             first = false;
         }
     }
     g_topoFile << std::endl;
-    // 清空当前区间集合，为下一个区间重新统计
-    g_intervalLinks[index].clear();
+}
+
+// 在每个窗口的结束时刻关闭窗口，没有流量的窗口也按时输出
+static void CloseWindows(double simulationTime)
+{
+    g_linkWindows.AdvanceTo(Simulator::Now().GetSeconds());
+    double next = g_linkWindows.GetNextWindowEnd();
+    if (next < simulationTime) {
+        Simulator::Schedule(Seconds(next) - Simulator::Now(), &CloseWindows, simulationTime);
+    }
+}
+
+// 由 Simulator::Destroy 调用，等待后台线程把剩余 trace 写完
+static void CloseTraceFiles()
+{
+    g_transFile.close();
+    g_binTrace.Close();
+    g_topoFile.close();
+    g_topoLog.Close();
+    uint64_t dropped = g_transFile.GetWriter().GetBytesDropped() +
+                       g_binTrace.GetWriter().GetBytesDropped() +
+                       g_topoFile.GetWriter().GetBytesDropped() +
+                       g_topoLog.GetWriter().GetBytesDropped();
+    if (dropped > 0) {
+        cerr << "Trace buffers full: " << dropped << " bytes dropped" << endl;
+    }
 }
 
 int main(int argc, char *argv[])
 {
-    // 创建20个节点
+    uint32_t numNodes = 20;
+    double areaSize = 500.0;        // 移动区域边长（米），初始位置分布在 2 倍范围内
+    double speed = 15.0;            // 平均速度（m/s），实际取 speed±5
+    double simulationTime = 100.0;
+    uint32_t seed = 1;
+    uint32_t run = 1;
+    std::string outputDir = ".";
+    std::string traceFormat = "text";
+    bool verbose = true;
+    bool writeStats = false;
+    double statsInterval = 1.0;        // --stats 的采样周期（仿真秒），见 uav-runtime-stats.h
+    UavAsyncOptions traceOptions;   // 异步 trace 写盘（见 uav-async-writer.h）
+    std::string tracePolicy = "block";
+    std::string positionMode = "exact";  // 位置快照精度档（见 uav-mobility-snapshot.h）
+    double positionStep = 0.1;
+    std::string recordTrajectory;       // 录制 / 回放轨迹文件（见 uav-trajectory-mobility.h）
+    std::string replayTrajectory;
+    double trajectoryStep = 1.0;        // 取 GaussMarkov 的 TimeStep，回放与原轨迹一致
+    std::string topologyFormat = "text";
+    double windowLength = 10.0;     // 拓扑推断窗口（见 uav-window-links.h）
+    double windowStride = 0.0;
+    std::string phyMode = "wifi";       // wifi 为完整 802.11ac 协议栈，abstract 见 uav-abstract-phy.h
+    std::string traffic = "onoff";      // onoff 为每次突发新装一个 OnOff 应用，burst 见 uav-burst-traffic.h
+    UavBurstSchedule::Options burstOptions;
+    bool graphTensors = false;          // 窗口图张量（见 uav-graph-export.h）
+    uint32_t graphChunk = 256;
+    std::string traceFilter;            // 见 uav-trace-filter.h
+    std::string burstProtocol = "tcp";
+    uint32_t maxConnections = 8;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numNodes", "Number of UAVs", numNodes);
+    cmd.AddValue("area", "Side of the square flight area in meters", areaSize);
+    cmd.AddValue("speed", "Mean UAV speed in m/s (drawn from speed +/- 5)", speed);
+    cmd.AddValue("duration", "Simulation time in seconds", simulationTime);
+    cmd.AddValue("seed", "RNG seed", seed);
+    cmd.AddValue("run", "RNG run number (independent replication)", run);
+    cmd.AddValue("outputDir", "Directory for all output files", outputDir);
+    cmd.AddValue("traceFormat", "Transmission trace format (text|binary)", traceFormat);
+    cmd.AddValue("verbose", "Enable OnOffApplication/PacketSink logging", verbose);
+    cmd.AddValue("stats", "Write run-stats.txt/run-stats.json and print a runtime summary", writeStats);
+    cmd.AddValue("statsInterval", "Sampling period of event rate and queue depth with --stats, in seconds", statsInterval);
+    cmd.AddValue("asyncTrace", "Write trace files from a background thread", traceOptions.async);
+    cmd.AddValue("traceBufferKb", "Size of each trace buffer in KiB", traceOptions.bufferKb);
+    cmd.AddValue("traceBuffers", "Trace buffers per file (bounds trace memory)", traceOptions.numBuffers);
+    cmd.AddValue("tracePolicy", "When all trace buffers are full: block|drop", tracePolicy);
+    cmd.AddValue("topologyFormat", "Topology log format (text|delta)", topologyFormat);
+    cmd.AddValue("positionMode", "Node positions in traces: exact|snapshot|interpolate", positionMode);
+    cmd.AddValue("positionStep", "Refresh period of the position snapshot in seconds", positionStep);
+    cmd.AddValue("recordTrajectory", "Write the flight paths to this trajectory file", recordTrajectory);
+    cmd.AddValue("replayTrajectory", "Replay flight paths from this trajectory file instead of Gauss-Markov", replayTrajectory);
+    cmd.AddValue("trajectoryStep", "Sampling period of --recordTrajectory in seconds", trajectoryStep);
+    cmd.AddValue("window", "Topology inference window length in seconds", windowLength);
+    cmd.AddValue("stride", "Start-to-start spacing of topology windows (0 = window, no overlap)", windowStride);
+    cmd.AddValue("phyMode", "Radio model: wifi (802.11ac) or abstract (range + collision)", phyMode);
+    cmd.AddValue("traffic", "Sender applications: onoff (one OnOff app per burst) or burst (one pooled app per node)", traffic);
+    cmd.AddValue("burstRate", "burst: draws per second", burstOptions.rate);
+    cmd.AddValue("burstProbability", "burst: probability that a draw starts a burst", burstOptions.probability);
+    cmd.AddValue("burstBytes", "burst: bytes per burst", burstOptions.minBytes);
+    cmd.AddValue("burstBytesMax", "burst: upper bound of a uniform burst size (0 = burstBytes)", burstOptions.maxBytes);
+    cmd.AddValue("burstProtocol", "burst: tcp (pooled connections) or udp (one socket per node)", burstProtocol);
+    cmd.AddValue("maxConnections", "burst: TCP connections kept open per node", maxConnections);
+    cmd.AddValue("graphTensors", "Write per-window graph tensors (NPY chunks) to <outputDir>/graph-tensors", graphTensors);
+    cmd.AddValue("graphChunk", "Windows per graph tensor chunk", graphChunk);
+    cmd.AddValue("traceFilter", "Record only matching transmissions, e.g. 'nodes=0-4;events=tx-data;time=10-50;sample=10'", traceFilter);
+    cmd.Parse(argc, argv);
+    NS_ABORT_MSG_UNLESS(traceFormat == "text" || traceFormat == "binary",
+                        "Unknown trace format: " << traceFormat);
+    NS_ABORT_MSG_UNLESS(UavParseBackPressure(tracePolicy, traceOptions.policy),
+                        "Unknown trace policy: " << tracePolicy);
+    UavMobilitySnapshot::Mode snapshotMode;
+    NS_ABORT_MSG_UNLESS(UavMobilitySnapshot::ParseMode(positionMode, snapshotMode),
+                        "Unknown position mode: " << positionMode);
+    NS_ABORT_MSG_UNLESS(topologyFormat == "text" || topologyFormat == "delta",
+                        "Unknown topology format: " << topologyFormat);
+    NS_ABORT_MSG_UNLESS(phyMode == "wifi" || phyMode == "abstract",
+                        "Unknown PHY mode: " << phyMode);
+    NS_ABORT_MSG_UNLESS(traffic == "onoff" || traffic == "burst",
+                        "Unknown traffic mode: " << traffic);
+    NS_ABORT_MSG_UNLESS(burstProtocol == "tcp" || burstProtocol == "udp",
+                        "Unknown burst protocol: " << burstProtocol);
+    NS_ABORT_MSG_UNLESS(burstOptions.rate > 0.0, "--burstRate must be positive");
+    NS_ABORT_MSG_UNLESS(maxConnections > 0, "--maxConnections must be positive");
+    NS_ABORT_MSG_UNLESS(graphChunk > 0, "--graphChunk must be positive");
+    std::string filterError;
+    NS_ABORT_MSG_UNLESS(g_traceFilter.Parse(traceFilter, &filterError), filterError);
+
+    SeedManager::SetSeed(seed);
+    SeedManager::SetRun(run);
+    SystemPath::MakeDirectories(outputDir);
+
+    // 拓扑统计窗口，步长缺省时等于窗口长度（不重叠）
+    if (windowStride <= 0.0) {
+        windowStride = windowLength;
+    }
+    NS_ABORT_MSG_UNLESS(g_linkWindows.Configure(windowLength, windowStride),
+                        "window must be a positive multiple of stride: " << windowLength << "/" << windowStride);
+    g_windowPrecision = (windowLength == std::floor(windowLength) && windowStride == std::floor(windowStride)) ? 0 : 3;
+    g_linkWindows.SetCallback(&TopologyOutput);
+
+    // 创建节点
     NodeContainer nodes;
-    nodes.Create(20);
-
-    LogComponentEnable("OnOffApplication", LOG_LEVEL_INFO);
-    LogComponentEnable("PacketSink", LOG_LEVEL_INFO);
-
-    // 配置移动模型: Gauss-Markov Mobility Model 三维随机移动
-    MobilityHelper mobility;
-    // 初始位置分布在立方体范围内随机均匀
-    mobility.SetPositionAllocator("ns3::RandomBoxPositionAllocator",
-        "X", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=1000.0]"),
-        "Y", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=1000.0]"),
-        "Z", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=200.0]")
-    );
-    // 设置GaussMarkov模型参数
-    mobility.SetMobilityModel("ns3::GaussMarkovMobilityModel",
-        "Bounds", BoxValue(Box(0, 500, 0, 500, 0, 100)),
-        "TimeStep", TimeValue(Seconds(1.0)),
-        "Alpha", DoubleValue(0.7),
-        "MeanVelocity", StringValue("ns3::UniformRandomVariable[Min=10.0|Max=20.0]"),
-        "MeanDirection", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=6.283185]"),
-        "MeanPitch", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=0.0]"),
-        "NormalVelocity", StringValue("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=2.0]"),
-        "NormalDirection", StringValue("ns3::NormalRandomVariable[Mean=0.0|Variance=0.5|Bound=1.0]"),
-        "NormalPitch", StringValue("ns3::NormalRandomVariable[Mean=0.0|Variance=0.1|Bound=0.2]")
-    );
-    mobility.Install(nodes);
-
-    // 配置Wi-Fi 802.11ac Adhoc通信
-    WifiHelper wifi;
-    wifi.SetStandard(WIFI_STANDARD_80211ac);
-    // 速率控制:使用固定速率避免速率自动调整的不确定性
-    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
-                                 "DataMode", StringValue("VhtMcs0"), 
-                                 "ControlMode", StringValue("VhtMcs0"));
-    // 物理层及信道设置
-    YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
-    Ptr<YansWifiChannel> wifiChannel = channel.Create ();
-
-    // 创建 YansWifiPhyHelper
-    YansWifiPhyHelper phy;
-    // 将上面创建的 WifiChannel 绑定到 phy
-    phy.SetChannel (wifiChannel);
-
-    // 设置发射功率 28 dBm，接收门限 -90 dBm
-    phy.Set ("TxPowerStart", DoubleValue (28.0));
-    phy.Set ("TxPowerEnd", DoubleValue (28.0));
-    phy.Set("RxSensitivity", DoubleValue(-90.0));
-    // MAC层设置为Adhoc模式
-    WifiMacHelper mac;
-    mac.SetType("ns3::AdhocWifiMac");
-    // 安装Wi-Fi设备到节点
-    NetDeviceContainer devices = wifi.Install(phy, mac, nodes);
+    nodes.Create(numNodes);
+
+    if (verbose) {
+        LogComponentEnable("OnOffApplication", LOG_LEVEL_INFO);
+        LogComponentEnable("PacketSink", LOG_LEVEL_INFO);
+    }
+
+    if (!replayTrajectory.empty()) {
+        // 回放预生成的轨迹，不再计算 GaussMarkov 移动
+        std::string error;
+        NS_ABORT_MSG_UNLESS(UavInstallTrajectory(nodes, replayTrajectory, &error), error);
+    } else {
+        // 配置移动模型: Gauss-Markov Mobility Model 三维随机移动
+        MobilityHelper mobility;
+        // 初始位置分布在立方体范围内随机均匀
+        mobility.SetPositionAllocator("ns3::RandomBoxPositionAllocator",
+            "X", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=" + std::to_string(2 * areaSize) + "]"),
+            "Y", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=" + std::to_string(2 * areaSize) + "]"),
+            "Z", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=200.0]")
+        );
+        // 设置GaussMarkov模型参数
+        mobility.SetMobilityModel("ns3::GaussMarkovMobilityModel",
+            "Bounds", BoxValue(Box(0, areaSize, 0, areaSize, 0, 100)),
+            "TimeStep", TimeValue(Seconds(1.0)),
+            "Alpha", DoubleValue(0.7),
+            "MeanVelocity", StringValue("ns3::UniformRandomVariable[Min=" + std::to_string(speed - 5) + "|Max=" + std::to_string(speed + 5) + "]"),
+            "MeanDirection", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=6.283185]"),
+            "MeanPitch", StringValue("ns3::UniformRandomVariable[Min=0.0|Max=0.0]"),
+            "NormalVelocity", StringValue("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=2.0]"),
+            "NormalDirection", StringValue("ns3::NormalRandomVariable[Mean=0.0|Variance=0.5|Bound=1.0]"),
+            "NormalPitch", StringValue("ns3::NormalRandomVariable[Mean=0.0|Variance=0.1|Bound=0.2]")
+        );
+        mobility.Install(nodes);
+    }
+    if (!recordTrajectory.empty()) {
+        NS_ABORT_MSG_UNLESS(g_trajectoryRecorder.Start(nodes, recordTrajectory, Seconds(trajectoryStep), UAV_SCENARIO_THIRD),
+                            "Cannot write trajectory file: " << recordTrajectory);
+    }
+    g_positions.Install(nodes, snapshotMode, Seconds(positionStep));
+    if (graphTensors) {
+        // 两种 PHY 都是 LogDistance 损耗、28 dBm 发射、-90 dBm 灵敏度
+        UavLinkBudget budget;
+        budget.model = UAV_PATHLOSS_LOG_DISTANCE;
+        budget.txPowerDbm = 28.0;
+        budget.rxSensitivityDbm = -90.0;
+        NS_ABORT_MSG_UNLESS(g_graphExport.Open(outputDir + "/graph-tensors", nodes, windowLength, windowStride,
+                                               graphChunk, budget),
+                            "Cannot write graph tensors to " << outputDir << "/graph-tensors");
+    }
+
+    NetDeviceContainer devices;
+    UavAbstractPhyHelper abstractPhy;
+    if (phyMode == "abstract") {
+        // 与 YansWifiChannelHelper::Default 相同的 LogDistance 损耗，功率和灵敏度同下；
+        // 空口速率取 VhtMcs0（80 MHz）
+        abstractPhy.SetChannelAttribute("TxPower", DoubleValue(28.0));
+        abstractPhy.SetChannelAttribute("RxSensitivity", DoubleValue(-90.0));
+        devices = abstractPhy.Install(nodes);
+    } else {
+        // 配置Wi-Fi 802.11ac Adhoc通信
+        WifiHelper wifi;
+        wifi.SetStandard(WIFI_STANDARD_80211ac);
+        // 速率控制:使用固定速率避免速率自动调整的不确定性
+        wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                     "DataMode", StringValue("VhtMcs0"), 
+                                     "ControlMode", StringValue("VhtMcs0"));
+        // 物理层及信道设置
+        YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+        Ptr<YansWifiChannel> wifiChannel = channel.Create ();
+
+        // 创建 YansWifiPhyHelper
+        YansWifiPhyHelper phy;
+        // 将上面创建的 WifiChannel 绑定到 phy
+        phy.SetChannel (wifiChannel);
+
+        // 设置发射功率 28 dBm，接收门限 -90 dBm
+        phy.Set ("TxPowerStart", DoubleValue (28.0));
+        phy.Set ("TxPowerEnd", DoubleValue (28.0));
+        phy.Set("RxSensitivity", DoubleValue(-90.0));
+        // MAC层设置为Adhoc模式
+        WifiMacHelper mac;
+        mac.SetType("ns3::AdhocWifiMac");
+        // 安装Wi-Fi设备到节点
+        devices = wifi.Install(phy, mac, nodes);
+    }
 
     // 安装TCP/IP协议栈
     InternetStackHelper stack;
     stack.Install(nodes);
     // 分配IP地址
     Ipv4AddressHelper address;
-    address.SetBase("10.0.0.0", "255.255.255.0");
+    // 超过 254 个节点时 /24 不够用，改用 /16
+    if (numNodes <= 254) {
+        address.SetBase("10.0.0.0", "255.255.255.0");
+    } else {
+        address.SetBase("10.0.0.0", "255.255.0.0");
+    }
     Ipv4InterfaceContainer interfaces = address.Assign(devices);
     // 填充IP映射表
-    for (uint32_t i = 0; i < nodes.GetN(); ++i) {
-        Ipv4Address ip = interfaces.GetAddress(i);
-        uint32_t nodeId = nodes.Get(i)->GetId();
-        g_ipToNodeId[ip.Get()] = nodeId;
-    }
+    g_ipToNodeId.Build(nodes);
 
     // 配置应用层：每个节点安装一个TCP PacketSink作为接收者
     uint16_t sinkPort = 9999;
     PacketSinkHelper sinkHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), sinkPort));
     ApplicationContainer sinkApps = sinkHelper.Install(nodes);
     sinkApps.Start(Seconds(0.0));
-    sinkApps.Stop(Seconds(100.0));
+    sinkApps.Stop(Seconds(simulationTime));
 
     // 配置发送端应用：OnOffApplication随机启动TCP会话
     Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable>();
     rand->SetStream(1);  // 固定随机流以重现实验（可选）
-    OnOffHelper onoff("ns3::TcpSocketFactory", Address());
-    onoff.SetAttribute("PacketSize", UintegerValue(512));
-    onoff.SetAttribute("DataRate", StringValue("10Mbps"));  // 高速率确保能发完
-    onoff.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=0.001]"));  // 非常短的窗口
-    onoff.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0.0]"));
-    LogComponentEnable("OnOffApplication", LOG_LEVEL_INFO);
-    LogComponentEnable("PacketSink", LOG_LEVEL_INFO);   
-
-    for (uint32_t t = 0; t < 100; ++t) {
-        // 每秒都有一定概率触发一次通信
-        if (rand->GetValue() < 0.5) {  // 20% 概率
-            // 随机选择发送节点和接收节点（确保不同）
-            uint32_t sender = rand->GetInteger(0, nodes.GetN() - 1);
-            uint32_t receiver = rand->GetInteger(0, nodes.GetN() - 1);
-            while (receiver == sender) {
-                receiver = rand->GetInteger(0, nodes.GetN() - 1);
+    ApplicationContainer burstApps;
+    if (traffic == "burst") {
+        // 每节点一个常驻应用，按预先生成的计划突发，连接复用（见 uav-burst-traffic.h）
+        TypeId protocol = TcpSocketFactory::GetTypeId();
+        if (burstProtocol == "udp") {
+            protocol = UdpSocketFactory::GetTypeId();
+            PacketSinkHelper udpSink("ns3::UdpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), sinkPort));
+            ApplicationContainer udpSinks = udpSink.Install(nodes);
+            udpSinks.Start(Seconds(0.0));
+            udpSinks.Stop(Seconds(simulationTime));
+        }
+        burstOptions.stop = simulationTime;
+        burstApps = UavInstallBurstTraffic(nodes, interfaces, burstOptions, rand, protocol, sinkPort, maxConnections);
+    } else {
+        OnOffHelper onoff("ns3::TcpSocketFactory", Address());
+        onoff.SetAttribute("PacketSize", UintegerValue(512));
+        onoff.SetAttribute("DataRate", StringValue("10Mbps"));  // 高速率确保能发完
+        onoff.SetAttribute("OnTime", StringValue("ns3::ConstantRandomVariable[Constant=0.001]"));  // 非常短的窗口
+        onoff.SetAttribute("OffTime", StringValue("ns3::ConstantRandomVariable[Constant=0.0]"));
+
+        for (uint32_t t = 0; t < simulationTime; ++t) {
+            // 每秒都有一定概率触发一次通信
+            if (rand->GetValue() < 0.5) {  // 20% 概率
+                // 随机选择发送节点和接收节点（确保不同）
+                uint32_t sender = rand->GetInteger(0, nodes.GetN() - 1);
+                uint32_t receiver = rand->GetInteger(0, nodes.GetN() - 1);
+                while (receiver == sender) {
+                    receiver = rand->GetInteger(0, nodes.GetN() - 1);
+                }
+                // 设置应用的远端地址为接收节点的IP和端口
+                Address remoteAddress(InetSocketAddress(interfaces.GetAddress(receiver), sinkPort));
+                onoff.SetAttribute("Remote", AddressValue(remoteAddress));
+                // 在发送方节点安装OnOff应用
+                ApplicationContainer app = onoff.Install(nodes.Get(sender));
+                // 设置应用启动时间为t秒
+                app.Start(Seconds((double)t));
+                // 停止时间为t+0.02秒，确保只发送一个包后停止
+                app.Stop(Seconds(t + 0.02));
             }
-            // 设置应用的远端地址为接收节点的IP和端口
-            Address remoteAddress(InetSocketAddress(interfaces.GetAddress(receiver), sinkPort));
-            onoff.SetAttribute("Remote", AddressValue(remoteAddress));
-            // 在发送方节点安装OnOff应用
-            ApplicationContainer app = onoff.Install(nodes.Get(sender));
-            // 设置应用启动时间为t秒
-            app.Start(Seconds((double)t));
-            // 停止时间为t+0.02秒，确保只发送一个包后停止
-            app.Stop(Seconds(t + 0.02));
         }
     }
 
     // 打开输出文件
-    g_transFile.open("node-transmissions.txt");
-    g_topoFile.open("topology-changes.txt");
+    if (traceFormat == "binary") {
+        g_binTrace.Open(outputDir + "/node-transmissions.bin", UAV_SCENARIO_THIRD, traceOptions);
+    } else {
+        g_transFile.open(outputDir + "/node-transmissions.txt", traceOptions);
+    }
+    if (topologyFormat == "delta") {
+        g_topoLog.Open(outputDir + "/topology-changes.delta", numNodes, UAV_SCENARIO_THIRD, 30.0, traceOptions);
+    } else {
+        g_topoFile.open(outputDir + "/topology-changes.txt", traceOptions);
+    }
+    Simulator::ScheduleDestroy(&CloseTraceFiles);
     // 连接IP层Tx和Rx跟踪器
-    Config::Connect("/NodeList/*/$ns3::Ipv4L3Protocol/Tx", MakeCallback(&Ipv4Tracer));
-    Config::Connect("/NodeList/*/$ns3::Ipv4L3Protocol/Rx", MakeCallback(&Ipv4Tracer));
+    UavConnectIpv4TxRx(nodes, &Ipv4Tracer);
 
-    // 安排每10秒输出拓扑活动链路
-    for (uint32_t idx = 0; idx < 10; ++idx) {
-        Simulator::Schedule(Seconds((idx + 1) * 10.0), &TopologyOutput, idx);
+    // 按窗口结束时刻输出拓扑活动链路（只保留下一次事件，不随仿真时长预先排满）
+    if (g_linkWindows.GetNextWindowEnd() < simulationTime) {
+        Simulator::Schedule(Seconds(g_linkWindows.GetNextWindowEnd()), &CloseWindows, simulationTime);
     }
 
     // 运行仿真
-    Simulator::Stop(Seconds(100.0));
+    UavRuntimeStats runtimeStats;
+    if (writeStats) {
+        runtimeStats.Start(Seconds(statsInterval));
+    }
+    Simulator::Stop(Seconds(simulationTime));
+    double wallStart = UavWallClock();
     Simulator::Run();
+    double wallSeconds = UavWallClock() - wallStart;
+    // 输出尚未关闭的窗口（结束时刻与 Stop 同时或更晚的窗口）
+    g_linkWindows.Finish(simulationTime);
+    if (g_graphExport.IsOpen()) {
+        uint64_t windows = g_graphExport.GetWindows(), edges = g_graphExport.GetEdges();
+        if (g_graphExport.Close()) {
+            std::cout << "Graph tensors: " << windows << " windows, " << edges << " edges" << std::endl;
+        } else {
+            cerr << "Graph tensors: write error in " << outputDir << "/graph-tensors" << endl;
+        }
+    }
+    if (writeStats) {
+        UavProfiler::Get().WriteStats(outputDir + "/run-stats.txt", simulationTime, wallSeconds,
+                                      Simulator::GetEventCount(), numNodes);
+        runtimeStats.WriteReport(outputDir + "/run-stats.json", simulationTime, wallSeconds,
+                                 Simulator::GetEventCount(), numNodes);
+        runtimeStats.PrintSummary(std::cout, wallSeconds, Simulator::GetEventCount());
+    }
+    if (burstApps.GetN() > 0) {
+        uint64_t bursts = 0, sent = 0, dropped = 0, opened = 0;
+        for (uint32_t i = 0; i < burstApps.GetN(); ++i) {
+            Ptr<UavBurstApp> app = DynamicCast<UavBurstApp>(burstApps.Get(i));
+            bursts += app->GetBurstsSent();
+            sent += app->GetBytesSent();
+            dropped += app->GetBytesDropped();
+            opened += app->GetConnectionsOpened();
+        }
+        std::cout << "Burst traffic: " << bursts << " bursts, " << sent << " bytes sent, "
+                  << dropped << " bytes dropped, " << opened << " connections opened" << std::endl;
+    }
+    if (abstractPhy.GetChannel()) {
+        Ptr<UavRangeChannel> radio = abstractPhy.GetChannel();
+        std::cout << "Abstract PHY: " << radio->GetDelivered() << " frames delivered, "
+                  << radio->GetCollisions() << " collisions, " << radio->GetLost() << " lost" << std::endl;
+    }
+    // 关闭文件（CloseTraceFiles）
     Simulator::Destroy();
-
-    // 关闭文件
-    g_transFile.close();
-    g_topoFile.close();
     return 0;
 }
@@ -0,0 +1,149 @@
+#include "uav-tools.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+// 等价性检查：以相同参数分别运行参考程序和待测程序，逐字节比较两边输出目录中的文件。
+// 用于确认统一场景的预设（Scenario --preset=...）与原 First/Second/Third 的输出一致。
+//
+//   uav-tools compare --reference=<bin> --candidate=<bin> [--out=compare]
+//       [--referenceArg=...] [--candidateArg=...] [--arg=...]
+
+namespace {
+
+// 与计时有关、每次运行都不同的文件，不参与比较
+bool IsTimingFile(const std::string& name) {
+    return name == "run.log" || name == "run-stats.txt" || name == "run-stats.json";
+}
+
+// 递归列出 dir 下的普通文件，返回相对路径
+void ListFiles(const std::string& dir, const std::string& prefix, std::set<std::string>& files) {
+    DIR* d = opendir((dir + prefix).c_str());
+    if (!d) {
+        return;
+    }
+    while (struct dirent* entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        std::string relative = prefix + "/" + name;
+        struct stat st;
+        if (stat((dir + relative).c_str(), &st) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            ListFiles(dir, relative, files);
+        } else if (S_ISREG(st.st_mode) && !IsTimingFile(name)) {
+            files.insert(relative.substr(1));
+        }
+    }
+    closedir(d);
+}
+
+// 返回第一个不同字节的偏移，相同时返回 -1
+long long FirstDifference(const std::string& a, const std::string& b) {
+    std::ifstream fa(a, std::ios::binary), fb(b, std::ios::binary);
+    char bufA[65536], bufB[65536];
+    long long offset = 0;
+    while (true) {
+        fa.read(bufA, sizeof(bufA));
+        fb.read(bufB, sizeof(bufB));
+        std::streamsize na = fa.gcount(), nb = fb.gcount();
+        std::streamsize n = std::min(na, nb);
+        for (std::streamsize k = 0; k < n; ++k) {
+            if (bufA[k] != bufB[k]) {
+                return offset + k;
+            }
+        }
+        if (na != nb) {
+            return offset + n;
+        }
+        if (na == 0) {
+            return -1;
+        }
+        offset += n;
+    }
+}
+
+} // namespace
+
+int RunCompare(const std::vector<std::string>& args) {
+    std::string reference, candidate, outDir = "compare", value;
+    std::vector<std::string> referenceArgs, candidateArgs, extraArgs;
+
+    for (const std::string& arg : args) {
+        if (ParseOption(arg, "reference", reference) || ParseOption(arg, "candidate", candidate) ||
+            ParseOption(arg, "out", outDir)) {
+            continue;
+        } else if (ParseOption(arg, "referenceArg", value)) {
+            referenceArgs.push_back(value);
+        } else if (ParseOption(arg, "candidateArg", value)) {
+            candidateArgs.push_back(value);
+        } else if (ParseOption(arg, "arg", value)) {
+            extraArgs.push_back(value);
+        } else {
+            std::cerr << "Unknown compare option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (reference.empty() || candidate.empty()) {
+        std::cerr << "Usage: uav-tools compare --reference=<bin> --candidate=<bin> [--out=dir] "
+                     "[--referenceArg=...] [--candidateArg=...] [--arg=--extra=1]" << std::endl;
+        return 1;
+    }
+
+    // 两边使用相同的公共参数（种子、run、规模等），各自的附加参数在其后
+    const std::string sides[2] = {"reference", "candidate"};
+    const std::string* binaries[2] = {&reference, &candidate};
+    const std::vector<std::string>* sideArgs[2] = {&referenceArgs, &candidateArgs};
+    for (int s = 0; s < 2; ++s) {
+        std::string dir = outDir + "/" + sides[s];
+        if (!MakeDirectories(dir)) {
+            std::cerr << "cannot create " << dir << std::endl;
+            return 1;
+        }
+        std::vector<std::string> argv = {*binaries[s], "--outputDir=" + dir};
+        argv.insert(argv.end(), extraArgs.begin(), extraArgs.end());
+        argv.insert(argv.end(), sideArgs[s]->begin(), sideArgs[s]->end());
+        ChildResult result = RunChild(argv, dir + "/run.log");
+        std::cout << sides[s] << ": exit " << result.exitStatus << ", " << result.wallSeconds << " s" << std::endl;
+        if (result.exitStatus != 0) {
+            std::cerr << sides[s] << " failed, see " << dir << "/run.log" << std::endl;
+            return 1;
+        }
+    }
+
+    std::set<std::string> referenceFiles, candidateFiles;
+    ListFiles(outDir + "/reference", "", referenceFiles);
+    ListFiles(outDir + "/candidate", "", candidateFiles);
+    uint32_t differences = 0;
+    for (const std::string& file : referenceFiles) {
+        if (!candidateFiles.count(file)) {
+            std::cout << "  missing   " << file << std::endl;
+            ++differences;
+            continue;
+        }
+        long long offset = FirstDifference(outDir + "/reference/" + file, outDir + "/candidate/" + file);
+        if (offset >= 0) {
+            std::cout << "  differs   " << file << " (first at byte " << offset << ")" << std::endl;
+            ++differences;
+        } else {
+            std::cout << "  same      " << file << std::endl;
+        }
+    }
+    for (const std::string& file : candidateFiles) {
+        if (!referenceFiles.count(file)) {
+            std::cout << "  extra     " << file << std::endl;
+            ++differences;
+        }
+    }
+    std::cout << (differences == 0 ? "outputs identical" : "outputs differ") << " (" << referenceFiles.size()
+              << " reference files)" << std::endl;
+    return differences == 0 ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#include "uav-tools.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+std::vector<std::string> SplitList(const std::string& text, char sep) {
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, sep)) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+std::vector<uint32_t> ParseRange(const std::string& text) {
+    std::vector<uint32_t> values;
+    for (const std::string& part : SplitList(text, ',')) {
+        size_t dash = part.find('-');
+        if (dash == std::string::npos) {
+            values.push_back(std::stoul(part));
+        } else {
+            uint32_t first = std::stoul(part.substr(0, dash));
+            uint32_t last = std::stoul(part.substr(dash + 1));
+            for (uint32_t v = first; v <= last; ++v) {
+                values.push_back(v);
+            }
+        }
+    }
+    return values;
+}
+
+bool MakeDirectories(const std::string& path) {
+    std::string partial;
+    for (const std::string& part : SplitList(path, '/')) {
+        partial += (partial.empty() && path[0] != '/') ? part : "/" + part;
+        if (mkdir(partial.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 用 posix_spawn 启动子进程并等待结束，记录退出码、墙钟时间和峰值常驻内存
+ChildResult RunChild(std::vector<std::string> args, const std::string& logPath) {
+    ChildResult result;
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, logPath.c_str(),
+                                     O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+    std::vector<char*> argv;
+    for (std::string& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid;
+    int rc = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (rc != 0) {
+        result.exitStatus = 127;
+        return result;
+    }
+
+    int status = 0;
+    struct rusage usage;
+    std::memset(&usage, 0, sizeof(usage));
+    while (wait4(pid, &status, 0, &usage) < 0 && errno == EINTR) {
+    }
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.maxRssKb = usage.ru_maxrss;
+    if (WIFEXITED(status)) {
+        result.exitStatus = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        result.exitStatus = 128 + WTERMSIG(status);
+    }
+    return result;
+}
@@ -0,0 +1,167 @@
+#include "uav-tools.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+// 规模基准：在不同集群规模下无界面运行 First/Second/Third，
+// 汇总事件吞吐、每仿真秒墙钟耗时、峰值内存、trace 字节数以及自身回调耗时，
+// 结果写入 <out>/scaling.csv 供回归跟踪。
+//
+//   uav-tools scale --first=<bin> --second=<bin> --third=<bin> --out=scale
+//       [--sizes=20,50,100,250,500,1000] [--duration=30] [--scaleArea=1] [--arg=...]
+
+namespace {
+
+const char* const kCallbacks[] = {"TxTrace", "UpdateTopology", "Ipv4Tracer", "TopologyOutput", "LogTransmission",
+                                  "ServerReceive", "ClientReceiveAck", "ProbeTransmissions"};
+
+// 读取场景写出的 run-stats.txt（key=value）
+std::map<std::string, std::string> ReadStats(const std::string& path) {
+    std::map<std::string, std::string> stats;
+    std::ifstream is(path);
+    std::string line;
+    while (std::getline(is, line)) {
+        size_t eq = line.find('=');
+        if (eq != std::string::npos) {
+            stats[line.substr(0, eq)] = line.substr(eq + 1);
+        }
+    }
+    return stats;
+}
+
+// 输出目录中除日志/统计文件外所有文件的总字节数
+uint64_t TraceBytes(const std::string& dir) {
+    uint64_t total = 0;
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+        return 0;
+    }
+    while (struct dirent* entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == ".." || name == "run.log" || name == "run-stats.txt") {
+            continue;
+        }
+        struct stat st;
+        if (stat((dir + "/" + name).c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+            total += st.st_size;
+        }
+    }
+    closedir(d);
+    return total;
+}
+
+std::string Get(const std::map<std::string, std::string>& stats, const std::string& key) {
+    auto it = stats.find(key);
+    return it == stats.end() ? "0" : it->second;
+}
+
+} // namespace
+
+int RunScale(const std::vector<std::string>& args) {
+    std::map<std::string, std::string> binaries;
+    std::string sizesText = "20,50,100,250,500,1000", outDir = "scale", duration, value;
+    bool scaleArea = true;
+    std::vector<std::string> extraArgs;
+
+    for (const std::string& arg : args) {
+        if (ParseOption(arg, "first", value)) {
+            binaries["First"] = value;
+        } else if (ParseOption(arg, "second", value)) {
+            binaries["Second"] = value;
+        } else if (ParseOption(arg, "third", value)) {
+            binaries["Third"] = value;
+        } else if (ParseOption(arg, "sizes", sizesText) || ParseOption(arg, "out", outDir) ||
+                   ParseOption(arg, "duration", duration)) {
+            continue;
+        } else if (ParseOption(arg, "scaleArea", value)) {
+            scaleArea = value != "0" && value != "false";
+        } else if (ParseOption(arg, "arg", value)) {
+            extraArgs.push_back(value);
+        } else {
+            std::cerr << "Unknown scale option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (binaries.empty()) {
+        std::cerr << "Usage: uav-tools scale --first=<bin> --second=<bin> --third=<bin> [--out=dir] "
+                     "[--sizes=20,50,...] [--duration=s] [--scaleArea=1] [--arg=--extra=1]" << std::endl;
+        return 1;
+    }
+    if (!MakeDirectories(outDir)) {
+        std::cerr << "cannot create " << outDir << std::endl;
+        return 1;
+    }
+
+    std::ofstream csv(outDir + "/scaling.csv");
+    csv << "scenario,nodes,exit_status,simulated_seconds,wall_seconds,events,events_per_second,"
+           "wall_per_simulated_second,peak_rss_kb,trace_bytes,callback_seconds,ns3_seconds";
+    for (const char* cb : kCallbacks) {
+        csv << "," << cb << "_calls," << cb << "_seconds";
+    }
+    csv << "\n";
+
+    std::cout << std::setw(8) << "scenario" << std::setw(8) << "nodes" << std::setw(12) << "wall(s)"
+              << std::setw(14) << "events/s" << std::setw(12) << "wall/sim" << std::setw(12) << "rss(MB)"
+              << std::setw(12) << "trace(MB)" << std::setw(12) << "callback%" << "\n";
+
+    uint32_t failed = 0;
+    // 依次串行运行，避免并发干扰计时
+    for (const auto& scenario : binaries) {
+        for (uint32_t n : ParseRange(sizesText)) {
+            std::string dir = outDir + "/" + scenario.first + "/n-" + std::to_string(n);
+            if (!MakeDirectories(dir)) {
+                std::cerr << "cannot create " << dir << std::endl;
+                return 1;
+            }
+            std::vector<std::string> argv = {scenario.second, "--numNodes=" + std::to_string(n),
+                                             "--outputDir=" + dir, "--stats=true"};
+            if (scaleArea) {
+                // 保持与 20 架 / 500 米相同的平面密度
+                argv.push_back("--area=" + std::to_string(500.0 * std::sqrt(n / 20.0)));
+            }
+            if (!duration.empty()) {
+                argv.push_back("--duration=" + duration);
+            }
+            if (scenario.first == "Third") {
+                argv.push_back("--verbose=false");
+            }
+            argv.insert(argv.end(), extraArgs.begin(), extraArgs.end());
+
+            ChildResult result = RunChild(argv, dir + "/run.log");
+            std::map<std::string, std::string> stats = ReadStats(dir + "/run-stats.txt");
+            uint64_t traceBytes = TraceBytes(dir);
+            double wall = std::stod(Get(stats, "wall_seconds"));
+            double callback = std::stod(Get(stats, "callback_seconds"));
+            long rss = stats.count("peak_rss_kb") ? std::stol(stats["peak_rss_kb"]) : result.maxRssKb;
+            failed += result.exitStatus != 0;
+
+            csv << scenario.first << "," << n << "," << result.exitStatus << ","
+                << Get(stats, "simulated_seconds") << "," << wall << "," << Get(stats, "events") << ","
+                << Get(stats, "events_per_second") << "," << Get(stats, "wall_per_simulated_second") << ","
+                << rss << "," << traceBytes << "," << callback << "," << std::max(0.0, wall - callback);
+            for (const char* cb : kCallbacks) {
+                std::string key = std::string("callback.") + cb;
+                csv << "," << Get(stats, key + ".calls") << "," << Get(stats, key + ".seconds");
+            }
+            csv << "\n";
+            csv.flush();
+
+            std::cout << std::setw(8) << scenario.first << std::setw(8) << n << std::fixed
+                      << std::setprecision(2) << std::setw(12) << wall
+                      << std::setprecision(0) << std::setw(14) << std::stod(Get(stats, "events_per_second"))
+                      << std::setprecision(3) << std::setw(12) << std::stod(Get(stats, "wall_per_simulated_second"))
+                      << std::setprecision(1) << std::setw(12) << rss / 1024.0
+                      << std::setw(12) << traceBytes / 1048576.0
+                      << std::setw(12) << (wall > 0 ? 100.0 * callback / wall : 0.0)
+                      << (result.exitStatus != 0 ? "  FAILED" : "") << std::endl;
+        }
+    }
+    std::cerr << "results: " << outDir << "/scaling.csv" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
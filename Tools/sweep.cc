@@ -0,0 +1,151 @@
+#include "uav-tools.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+// 参数扫描：对 --param 给出的取值做笛卡尔积，每个组合跑 runs 个独立重复，
+// 用本机所有核心并行执行场景程序，每次运行有独立的 RngRun 和输出目录。
+//
+//   uav-tools sweep --binary=build/scratch/Second/Second --out=sweep
+//       --param=numNodes=20,50,100 --param=speed=10,15 --runs=1-10 [--jobs=8]
+//       [--arg=--traceFormat=binary]
+//
+// 结果汇总在 <out>/manifest.csv，每次运行的标准输出/错误在其目录下的 run.log。
+
+namespace {
+
+struct SweepJob {
+    std::string config;                // 形如 numNodes-20_speed-10
+    uint32_t run = 1;
+    std::string outputDir;
+    std::vector<std::string> argv;
+    ChildResult result;
+};
+
+std::string JoinCommand(const std::vector<std::string>& argv) {
+    std::string cmd;
+    for (const std::string& arg : argv) {
+        cmd += (cmd.empty() ? "" : " ") + arg;
+    }
+    return cmd;
+}
+
+} // namespace
+
+int RunSweep(const std::vector<std::string>& args) {
+    std::string binary, outDir = "sweep", runsText = "1", value;
+    uint32_t jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::pair<std::string, std::vector<std::string>>> params;
+    std::vector<std::string> extraArgs;
+
+    for (const std::string& arg : args) {
+        if (ParseOption(arg, "binary", binary) || ParseOption(arg, "out", outDir) ||
+            ParseOption(arg, "runs", runsText)) {
+            continue;
+        } else if (ParseOption(arg, "jobs", value)) {
+            jobs = std::max(1ul, std::stoul(value));
+        } else if (ParseOption(arg, "param", value)) {
+            size_t eq = value.find('=');
+            if (eq == std::string::npos) {
+                std::cerr << "Bad --param (expected name=v1,v2,...): " << value << std::endl;
+                return 1;
+            }
+            params.emplace_back(value.substr(0, eq), SplitList(value.substr(eq + 1), ','));
+        } else if (ParseOption(arg, "arg", value)) {
+            extraArgs.push_back(value);
+        } else {
+            std::cerr << "Unknown sweep option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (binary.empty()) {
+        std::cerr << "Usage: uav-tools sweep --binary=<scenario> [--out=dir] [--runs=1-10] "
+                     "[--param=name=v1,v2] [--arg=--extra=1] [--jobs=N]" << std::endl;
+        return 1;
+    }
+
+    // 参数组合（笛卡尔积）× 重复次数 → 任务队列
+    std::vector<std::vector<std::pair<std::string, std::string>>> configs(1);
+    for (const auto& param : params) {
+        std::vector<std::vector<std::pair<std::string, std::string>>> next;
+        for (const auto& config : configs) {
+            for (const std::string& v : param.second) {
+                next.push_back(config);
+                next.back().emplace_back(param.first, v);
+            }
+        }
+        configs.swap(next);
+    }
+
+    std::vector<SweepJob> queue;
+    for (const auto& config : configs) {
+        std::string name;
+        for (const auto& kv : config) {
+            name += (name.empty() ? "" : "_") + kv.first + "-" + kv.second;
+        }
+        if (name.empty()) {
+            name = "default";
+        }
+        for (uint32_t run : ParseRange(runsText)) {
+            SweepJob job;
+            job.config = name;
+            job.run = run;
+            job.outputDir = outDir + "/" + name + "/run-" + std::to_string(run);
+            job.argv.push_back(binary);
+            for (const auto& kv : config) {
+                job.argv.push_back("--" + kv.first + "=" + kv.second);
+            }
+            job.argv.push_back("--run=" + std::to_string(run));
+            job.argv.push_back("--outputDir=" + job.outputDir);
+            job.argv.insert(job.argv.end(), extraArgs.begin(), extraArgs.end());
+            if (!MakeDirectories(job.outputDir)) {
+                std::cerr << "cannot create " << job.outputDir << std::endl;
+                return 1;
+            }
+            queue.push_back(job);
+        }
+    }
+
+    // 工作队列：每个工作线程取下一个任务并等待其子进程结束
+    std::atomic<size_t> next(0);
+    std::mutex printMutex;
+    size_t done = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto worker = [&]() {
+        for (size_t i = next++; i < queue.size(); i = next++) {
+            queue[i].result = RunChild(queue[i].argv, queue[i].outputDir + "/run.log");
+            std::lock_guard<std::mutex> lock(printMutex);
+            ++done;
+            std::cerr << "[" << done << "/" << queue.size() << "] " << queue[i].config
+                      << " run " << queue[i].run << ": exit " << queue[i].result.exitStatus
+                      << ", " << std::fixed << std::setprecision(1) << queue[i].result.wallSeconds << " s" << std::endl;
+        }
+    };
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < std::min<size_t>(jobs, queue.size()); ++t) {
+        workers.emplace_back(worker);
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream manifest(outDir + "/manifest.csv");
+    manifest << "config,run,exit_status,wall_seconds,max_rss_kb,output_dir,command\n";
+    uint32_t failed = 0;
+    for (const SweepJob& job : queue) {
+        manifest << job.config << "," << job.run << "," << job.result.exitStatus << ","
+                 << std::fixed << std::setprecision(3) << job.result.wallSeconds << ","
+                 << job.result.maxRssKb << "," << job.outputDir << ",\"" << JoinCommand(job.argv) << "\"\n";
+        failed += job.result.exitStatus != 0;
+    }
+    std::cerr << queue.size() << " runs on " << jobs << " workers in " << std::setprecision(1)
+              << total << " s, " << failed << " failed; manifest: " << outDir << "/manifest.csv" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
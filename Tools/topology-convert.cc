@@ -0,0 +1,142 @@
+#include "uav-tools.h"
+#include "../Common/uav-binary-trace.h"
+#include "../Common/uav-topology-log.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+// 增量拓扑日志（--topologyFormat=delta）的查询与转换
+//   uav-tools topology topology-changes.delta [output] [--format=auto|second|third|events]
+//   uav-tools topology topology-changes.delta --at=42.5
+// 不带 --at 时在每个有变化的时刻输出一行完整快照（链路没有变化的采样时刻不会出现），
+// events 格式输出原始的增量记录。
+
+typedef UavTopologyLogReader::Edge Edge;
+
+// Second 的格式：双向链路两个方向各输出一次，按节点号升序
+static void WriteSecond(std::ostream& os, double time, const std::vector<Edge>& links, uint32_t numNodes) {
+    std::vector<std::vector<uint32_t>> neighbors(numNodes);
+    for (const Edge& e : links) {
+        neighbors[e.first].push_back(e.second);
+        neighbors[e.second].push_back(e.first);
+    }
+    os << "Time: " << time << "s | Active Links: ";
+    for (uint32_t i = 0; i < numNodes; ++i) {
+        std::sort(neighbors[i].begin(), neighbors[i].end());
+        for (uint32_t j : neighbors[i]) {
+            os << i << "<->" << j << " ";
+        }
+    }
+    os << "\n";
+}
+
+// Third 的格式：时间戳为 10 秒区间的起点
+static void WriteThird(std::ostream& os, double time, const std::vector<Edge>& links, uint32_t) {
+    os << std::fixed << std::setprecision(0) << time << "-" << time + 10.0 << "s: ";
+    if (links.empty()) {
+        os << "none";
+    }
+    for (size_t k = 0; k < links.size(); ++k) {
+        os << (k ? ", " : "") << "Node" << links[k].first << "-Node" << links[k].second;
+    }
+    os << std::endl;
+}
+
+int RunTopologyConvert(const std::vector<std::string>& args) {
+    std::string format = "auto", at;
+    std::vector<std::string> paths;
+    for (const std::string& arg : args) {
+        if (!ParseOption(arg, "format", format) && !ParseOption(arg, "at", at)) {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty() || paths.size() > 2) {
+        std::cerr << "Usage: uav-tools topology <topology.delta> [output] "
+                     "[--format=auto|second|third|events] [--at=t]\n";
+        return 1;
+    }
+
+    UavTopologyLogReader reader;
+    std::string error;
+    if (!reader.Open(paths[0], &error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if (format == "auto") {
+        format = reader.GetHeader().scenario == UAV_SCENARIO_THIRD ? "third" : "second";
+    }
+    void (*write)(std::ostream&, double, const std::vector<Edge>&, uint32_t) = nullptr;
+    if (format == "second") {
+        write = &WriteSecond;
+    } else if (format == "third") {
+        write = &WriteThird;
+    } else if (format != "events") {
+        std::cerr << "Unknown format: " << format << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (paths.size() == 2) {
+        file.open(paths[1]);
+        if (!file) {
+            std::cerr << "cannot open " << paths[1] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& os = paths.size() == 2 ? file : std::cout;
+    uint32_t numNodes = reader.GetNumNodes();
+
+    // 单个时刻：按索引定位最近的关键帧后回放
+    if (!at.empty()) {
+        std::vector<Edge> links;
+        double t = std::stod(at);
+        if (!reader.GetLinksAt(t, links)) {
+            std::cerr << "read error" << std::endl;
+            return 1;
+        }
+        if (write) {
+            write(os, t, links, numNodes);
+        } else {
+            for (const Edge& e : links) {
+                os << t << ",LINK," << e.first << "," << e.second << "\n";
+            }
+        }
+        return 0;
+    }
+
+    // 全量回放：同一时刻的若干块合并为一行快照
+    static const char* const kTypes[] = {"KEYFRAME", "ADD", "REMOVE"};
+    std::vector<Edge> links, merged;
+    double pending = 0.0;
+    bool havePending = false;
+    reader.ForEachBlock([&](const UavTopologyBlockHeader& block, const std::vector<Edge>& edges) {
+        if (!write) {
+            for (const Edge& e : edges) {
+                os << block.time << "," << kTypes[std::min<uint32_t>(block.type, 2)] << ","
+                   << e.first << "," << e.second << "\n";
+            }
+            return;
+        }
+        if (havePending && block.time != pending) {
+            write(os, pending, links, numNodes);
+        }
+        pending = block.time;
+        havePending = true;
+        merged.clear();
+        if (block.type == UAV_TOPOLOGY_KEYFRAME) {
+            merged = edges;
+        } else if (block.type == UAV_TOPOLOGY_ADD) {
+            std::set_union(links.begin(), links.end(), edges.begin(), edges.end(), std::back_inserter(merged));
+        } else {
+            std::set_difference(links.begin(), links.end(), edges.begin(), edges.end(), std::back_inserter(merged));
+        }
+        links.swap(merged);
+    });
+    if (write && havePending) {
+        write(os, pending, links, numNodes);
+    }
+    return 0;
+}
@@ -0,0 +1,745 @@
+#include "uav-tools.h"
+#include "../Common/uav-binary-trace.h"
+#include "../Common/uav-link-kernel.h"
+#include "../Common/uav-topology-log.h"
+#include "../Common/uav-window-links.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 由传输 trace 离线推断每个时间窗口的通信图，并与 UpdateTopology 的几何真值比较
+//   uav-tools infer node-transmissions.txt [output] [--truth=topology-changes.txt] [--window=10]
+// trace 可以是三个场景的文本格式或二进制格式（node-transmissions.bin 等）。
+// 文件整体 mmap，文本按行边界切成与线程数相同的块并行解析，二进制记录直接原地使用。
+// 每条观测到的通信交给 UavWindowLinkInference（与 Third 仿真内的推断相同）按窗口聚合：
+//   peer    记录带有对端节点（Third 的二进制 trace）：直接取 (node, peer)
+//   match   Third 的文本 trace 没有对端：把 Rx 匹配到 --maxDelay 内最近一条同类型、
+//           尚未匹配的其他节点的 Tx
+//   range   First/Second 的 trace 只有发送方和位置：每 --step 秒取有事件的节点的最新位置，
+//           距离不超过 --range 的两个节点视为通信
+// 真值可以是 Second 的 topology-changes.txt、Third 格式的窗口拓扑或增量拓扑日志；
+// 窗口 [start, end) 的真值为其中各快照链路的并集，窗口内没有快照时取 start 之前最近的快照。
+
+typedef std::pair<uint32_t, uint32_t> Edge;
+
+// 只读映射整个文件
+class MappedFile {
+public:
+    ~MappedFile() {
+        if (m_data) {
+            ::munmap(m_data, m_size);
+        }
+    }
+
+    bool Open(const std::string& path, std::string* error) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            *error = "cannot open " + path;
+            return false;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            *error = "cannot stat " + path;
+            return false;
+        }
+        m_size = st.st_size;
+        if (m_size > 0) {
+            m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m_data == MAP_FAILED) {
+                m_data = nullptr;
+                ::close(fd);
+                *error = "cannot map " + path;
+                return false;
+            }
+            ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+        return true;
+    }
+
+    const char* Begin() const { return static_cast<const char*>(m_data); }
+    const char* End() const { return Begin() + m_size; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    void* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+// ---- 文本解析 ----
+
+static bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// 解析十进制浮点数（ostream 默认格式及 fixed 格式），p 移到数字之后
+// 有效数字不超过 19 位且指数不大时直接用整数尾数除以 10 的幂，其余交给 strtod
+static bool ParseDouble(const char*& p, const char* end, double& value) {
+    static const double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char* start = p;
+    bool negative = p < end && *p == '-';
+    if (negative || (p < end && *p == '+')) {
+        ++p;
+    }
+    uint64_t mantissa = 0;
+    int digits = 0, scale = 0;
+    bool any = false;
+    for (; p < end && IsDigit(*p); ++p, any = true) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            digits += mantissa != 0;
+        } else {
+            ++scale;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && IsDigit(*p); ++p, any = true) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                digits += mantissa != 0;
+                --scale;
+            }
+        }
+    }
+    if (!any) {
+        p = start;
+        return false;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* e = p + 1;
+        bool expNegative = e < end && *e == '-';
+        if (e < end && (*e == '-' || *e == '+')) {
+            ++e;
+        }
+        int exponent = 0;
+        if (e < end && IsDigit(*e)) {
+            for (; e < end && IsDigit(*e); ++e) {
+                exponent = std::min(exponent * 10 + (*e - '0'), 10000);
+            }
+            scale += expNegative ? -exponent : exponent;
+            p = e;
+        }
+    }
+    if (mantissa < (uint64_t(1) << 53) && scale >= -22 && scale <= 22) {
+        double v = static_cast<double>(mantissa);
+        value = scale < 0 ? v / kPow10[-scale] : v * kPow10[scale];
+    } else {
+        std::string text(start, p);
+        value = std::strtod(text.c_str(), nullptr);
+        return true;
+    }
+    if (negative) {
+        value = -value;
+    }
+    return true;
+}
+
+static bool ParseUint(const char*& p, const char* end, uint32_t& value) {
+    if (p == end || !IsDigit(*p)) {
+        return false;
+    }
+    uint64_t v = 0;
+    for (; p < end && IsDigit(*p); ++p) {
+        v = v * 10 + (*p - '0');
+    }
+    value = static_cast<uint32_t>(v);
+    return true;
+}
+
+// 跳过固定的文本，不匹配时返回 false
+static bool Expect(const char*& p, const char* end, const char* text) {
+    for (; *text; ++text, ++p) {
+        if (p == end || *p != *text) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool ParseEvent(const char* begin, const char* end, uint16_t& event) {
+    for (uint16_t e = 0; e < UAV_EVENT_COUNT; ++e) {
+        const char* name = UavTraceEventName(e);
+        size_t n = std::strlen(name);
+        if (static_cast<size_t>(end - begin) == n && std::memcmp(begin, name, n) == 0) {
+            event = e;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void InitRecord(UavTraceRecord& r) {
+    std::memset(&r, 0, sizeof(r));
+    r.peer = UAV_TRACE_NO_PEER;
+}
+
+// First："Time: 1.2s, Node ID: 3, Position: (x, y, z)"
+static bool ParseFirstLine(const char* p, const char* end, UavTraceRecord& r) {
+    InitRecord(r);
+    r.event = UAV_EVENT_MAC_TX;
+    return Expect(p, end, "Time: ") && ParseDouble(p, end, r.time) && Expect(p, end, "s, Node ID: ") &&
+           ParseUint(p, end, r.node) && Expect(p, end, ", Position: (") && ParseDouble(p, end, r.x) &&
+           Expect(p, end, ", ") && ParseDouble(p, end, r.y) && Expect(p, end, ", ") && ParseDouble(p, end, r.z);
+}
+
+// Second："12.3,4,DATA,x,y,z"
+static bool ParseSecondLine(const char* p, const char* end, UavTraceRecord& r) {
+    InitRecord(r);
+    if (!ParseDouble(p, end, r.time) || !Expect(p, end, ",") || !ParseUint(p, end, r.node) || !Expect(p, end, ",")) {
+        return false;
+    }
+    const char* name = p;
+    while (p < end && *p != ',') {
+        ++p;
+    }
+    return ParseEvent(name, p, r.event) && Expect(p, end, ",") && ParseDouble(p, end, r.x) &&
+           Expect(p, end, ",") && ParseDouble(p, end, r.y) && Expect(p, end, ",") && ParseDouble(p, end, r.z);
+}
+
+// Third："12.345s Node3 Tx Data"
+static bool ParseThirdLine(const char* p, const char* end, UavTraceRecord& r) {
+    InitRecord(r);
+    if (!ParseDouble(p, end, r.time) || !Expect(p, end, "s Node") || !ParseUint(p, end, r.node) ||
+        !Expect(p, end, " ")) {
+        return false;
+    }
+    while (end > p && (end[-1] == '\r' || end[-1] == ' ')) {
+        --end;
+    }
+    return ParseEvent(p, end, r.event);
+}
+
+typedef bool (*LineParser)(const char*, const char*, UavTraceRecord&);
+
+// 按第一条非空行判断文本格式
+static UavTraceScenario DetectTextFormat(const char* begin, const char* end) {
+    while (begin < end && (*begin == '\n' || *begin == '\r')) {
+        ++begin;
+    }
+    const char* eol = std::find(begin, end, '\n');
+    std::string line(begin, eol);
+    if (line.compare(0, 6, "Time: ") == 0) {
+        return UAV_SCENARIO_FIRST;
+    }
+    if (line.find("s Node") != std::string::npos) {
+        return UAV_SCENARIO_THIRD;
+    }
+    if (line.find(',') != std::string::npos) {
+        return UAV_SCENARIO_SECOND;
+    }
+    return UAV_SCENARIO_GENERIC;
+}
+
+// 一个块的解析结果
+struct ParsedChunk {
+    std::vector<UavTraceRecord> records;
+    uint64_t badLines = 0;
+};
+
+static void ParseChunk(const char* p, const char* end, LineParser parse, ParsedChunk& out) {
+    out.records.reserve((end - p) / 24);
+    UavTraceRecord r;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!eol) {
+            eol = end;
+        }
+        if (eol > p && !(eol - p == 1 && *p == '\r')) {
+            if (parse(p, eol, r)) {
+                out.records.push_back(r);
+            } else {
+                ++out.badLines;
+            }
+        }
+        p = eol + 1;
+    }
+}
+
+// 按行边界切成 threads 块并行解析，块按文件顺序排列
+static std::vector<ParsedChunk> ParseText(const char* begin, const char* end, LineParser parse, uint32_t threads) {
+    size_t size = end - begin;
+    threads = std::max<uint32_t>(1, std::min<size_t>(threads, size / (1 << 20) + 1));
+    std::vector<const char*> bounds(1, begin);
+    for (uint32_t k = 1; k < threads; ++k) {
+        const char* p = std::max(begin + size * k / threads, bounds.back());
+        const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        bounds.push_back(eol ? eol + 1 : end);
+    }
+    bounds.push_back(end);
+
+    std::vector<ParsedChunk> chunks(threads);
+    std::vector<std::thread> workers;
+    for (uint32_t k = 0; k < threads; ++k) {
+        workers.emplace_back(&ParseChunk, bounds[k], bounds[k + 1], parse, std::ref(chunks[k]));
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    return chunks;
+}
+
+// ---- 真值 ----
+
+struct TruthSnapshot {
+    double time;
+    std::vector<Edge> links;   // i < j，升序
+};
+
+static void SortLinks(std::vector<Edge>& links) {
+    for (Edge& e : links) {
+        if (e.first > e.second) {
+            std::swap(e.first, e.second);
+        }
+    }
+    std::sort(links.begin(), links.end());
+    links.erase(std::unique(links.begin(), links.end()), links.end());
+}
+
+// Second："Time: 5s | Active Links: 0<->3 3<->0 ..."
+static bool ParseSecondTruth(const char* p, const char* end, TruthSnapshot& s) {
+    if (!Expect(p, end, "Time: ") || !ParseDouble(p, end, s.time) || !Expect(p, end, "s | Active Links:")) {
+        return false;
+    }
+    Edge e;
+    while (true) {
+        while (p < end && *p == ' ') {
+            ++p;
+        }
+        if (!ParseUint(p, end, e.first)) {
+            break;
+        }
+        if (!Expect(p, end, "<->") || !ParseUint(p, end, e.second)) {
+            return false;
+        }
+        s.links.push_back(e);
+    }
+    return true;
+}
+
+// Third："0-10s: Node1-Node2, Node3-Node5" 或 "0-10s: none"，快照时刻取窗口起点
+static bool ParseThirdTruth(const char* p, const char* end, TruthSnapshot& s) {
+    double windowEnd;
+    if (!ParseDouble(p, end, s.time) || !Expect(p, end, "-") || !ParseDouble(p, end, windowEnd) ||
+        !Expect(p, end, "s: ")) {
+        return false;
+    }
+    Edge e;
+    while (Expect(p, end, "Node")) {
+        if (!ParseUint(p, end, e.first) || !Expect(p, end, "-Node") || !ParseUint(p, end, e.second)) {
+            return false;
+        }
+        s.links.push_back(e);
+        if (!Expect(p, end, ", ")) {
+            break;
+        }
+    }
+    return true;
+}
+
+static bool LoadTruth(const std::string& path, std::vector<TruthSnapshot>& snapshots, std::string* error) {
+    MappedFile file;
+    if (!file.Open(path, error)) {
+        return false;
+    }
+    if (file.GetSize() >= sizeof(UAV_TOPOLOGY_MAGIC) &&
+        std::memcmp(file.Begin(), UAV_TOPOLOGY_MAGIC, sizeof(UAV_TOPOLOGY_MAGIC)) == 0) {
+        // 增量拓扑日志：同一时刻的若干块合并为一个快照
+        UavTopologyLogReader reader;
+        if (!reader.Open(path, error)) {
+            return false;
+        }
+        std::vector<Edge> links, merged;
+        reader.ForEachBlock([&](const UavTopologyBlockHeader& block, const std::vector<Edge>& edges) {
+            merged.clear();
+            if (block.type == UAV_TOPOLOGY_KEYFRAME) {
+                merged = edges;
+            } else if (block.type == UAV_TOPOLOGY_ADD) {
+                std::set_union(links.begin(), links.end(), edges.begin(), edges.end(), std::back_inserter(merged));
+            } else {
+                std::set_difference(links.begin(), links.end(), edges.begin(), edges.end(), std::back_inserter(merged));
+            }
+            links.swap(merged);
+            if (snapshots.empty() || snapshots.back().time != block.time) {
+                snapshots.push_back(TruthSnapshot{block.time, {}});
+            }
+            snapshots.back().links = links;
+        });
+        return true;
+    }
+
+    const char* p = file.Begin();
+    const char* end = file.End();
+    while (p < end) {
+        const char* eol = std::find(p, end, '\n');
+        if (eol > p) {
+            TruthSnapshot s;
+            bool ok = ParseSecondTruth(p, eol, s);
+            if (!ok) {
+                s = TruthSnapshot();
+                ok = ParseThirdTruth(p, eol, s);
+            }
+            if (!ok) {
+                *error = path + ": unrecognized topology line: " + std::string(p, std::min(eol, p + 60));
+                return false;
+            }
+            SortLinks(s.links);
+            snapshots.push_back(std::move(s));
+        }
+        p = eol + 1;
+    }
+    std::stable_sort(snapshots.begin(), snapshots.end(),
+                     [](const TruthSnapshot& a, const TruthSnapshot& b) { return a.time < b.time; });
+    return true;
+}
+
+// 窗口 [start, end) 的真值链路
+static void TruthForWindow(const std::vector<TruthSnapshot>& snapshots, double start, double end,
+                           std::vector<Edge>& links, bool& known) {
+    links.clear();
+    auto first = std::lower_bound(snapshots.begin(), snapshots.end(), start,
+                                  [](const TruthSnapshot& s, double t) { return s.time < t; });
+    auto it = first;
+    std::vector<Edge> merged;
+    for (; it != snapshots.end() && it->time < end; ++it) {
+        merged.clear();
+        std::set_union(links.begin(), links.end(), it->links.begin(), it->links.end(), std::back_inserter(merged));
+        links.swap(merged);
+    }
+    known = it != first;
+    if (!known && first != snapshots.begin()) {
+        links = std::prev(first)->links;
+        known = true;
+    }
+}
+
+// ---- 推断 ----
+
+// Tx → Rx 匹配（Third 文本 trace）
+class TxRxMatcher {
+public:
+    explicit TxRxMatcher(double maxDelay) : m_maxDelay(maxDelay) {}
+
+    template <typename Fn>
+    void Add(const UavTraceRecord& r, Fn observe) {
+        bool tx = r.event == UAV_EVENT_TX_DATA || r.event == UAV_EVENT_TX_ACK;
+        bool rx = r.event == UAV_EVENT_RX_DATA || r.event == UAV_EVENT_RX_ACK;
+        if (!tx && !rx) {
+            return;
+        }
+        std::deque<Pending>& queue = m_pending[r.event == UAV_EVENT_TX_ACK || r.event == UAV_EVENT_RX_ACK];
+        while (!queue.empty() && queue.front().time < r.time - m_maxDelay) {
+            queue.pop_front();
+        }
+        if (tx) {
+            queue.push_back(Pending{r.time, r.node, false});
+            return;
+        }
+        for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+            if (!it->matched && it->node != r.node) {
+                it->matched = true;
+                ++m_matched;
+                observe(r.time, it->node, r.node, r.bytes);
+                return;
+            }
+        }
+        ++m_unmatched;
+    }
+
+    uint64_t GetMatched() const { return m_matched; }
+    uint64_t GetUnmatched() const { return m_unmatched; }
+
+private:
+    struct Pending {
+        double time;
+        uint32_t node;
+        bool matched;
+    };
+
+    double m_maxDelay;
+    std::deque<Pending> m_pending[2];   // [0] 数据，[1] ACK
+    uint64_t m_matched = 0;
+    uint64_t m_unmatched = 0;
+};
+
+// 按位置判定链路（First/Second 的 trace）
+class RangeLinker {
+public:
+    RangeLinker(double range, double step) : m_step(step) {
+        UavLinkBudget budget;
+        budget.range = range;
+        m_kernel.Configure(budget);
+    }
+
+    template <typename Fn>
+    void Add(const UavTraceRecord& r, Fn observe) {
+        int64_t step = static_cast<int64_t>(std::floor(r.time / m_step));
+        if (step != m_current) {
+            Flush(observe);
+            m_current = step;
+        }
+        if (r.node >= m_slot.size()) {
+            m_slot.resize(r.node + 1, UINT32_MAX);
+        }
+        uint32_t& slot = m_slot[r.node];
+        if (slot == UINT32_MAX) {
+            slot = m_nodes.size();
+            m_nodes.push_back(r.node);
+            m_x.push_back(0.0);
+            m_y.push_back(0.0);
+            m_z.push_back(0.0);
+        }
+        m_x[slot] = r.x;
+        m_y[slot] = r.y;
+        m_z[slot] = r.z;
+    }
+
+    // 本步内有事件的节点两两判定，观测时刻取步起点
+    template <typename Fn>
+    void Flush(Fn observe) {
+        double time = m_current * m_step;
+        m_kernel.ForEachLink(m_x.data(), m_y.data(), m_z.data(), m_nodes.size(), [&](uint32_t i, uint32_t j) {
+            observe(time, m_nodes[i], m_nodes[j], 0);
+        });
+        for (uint32_t node : m_nodes) {
+            m_slot[node] = UINT32_MAX;
+        }
+        m_nodes.clear();
+        m_x.clear();
+        m_y.clear();
+        m_z.clear();
+    }
+
+private:
+    UavLinkKernel m_kernel;
+    double m_step;
+    int64_t m_current = 0;
+    std::vector<uint32_t> m_slot;    // 节点 → 本步 SoA 下标
+    std::vector<uint32_t> m_nodes;
+    std::vector<double> m_x, m_y, m_z;
+};
+
+struct InferTotals {
+    uint64_t windows = 0;
+    uint64_t scored = 0;
+    uint64_t truePositives = 0;
+    uint64_t inferred = 0;
+    uint64_t truth = 0;
+};
+
+static double Ratio(uint64_t a, uint64_t b) {
+    return b ? static_cast<double>(a) / b : 0.0;
+}
+
+int RunTopologyInfer(const std::vector<std::string>& args) {
+    std::string truthPath, metricsPath, mode = "auto";
+    std::string window = "10", stride = "0", range = "250", step = "1", maxDelay = "0.01";
+    std::string threadsText = std::to_string(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::string> paths;
+    for (const std::string& arg : args) {
+        if (!ParseOption(arg, "truth", truthPath) && !ParseOption(arg, "metrics", metricsPath) &&
+            !ParseOption(arg, "mode", mode) && !ParseOption(arg, "window", window) &&
+            !ParseOption(arg, "stride", stride) && !ParseOption(arg, "range", range) &&
+            !ParseOption(arg, "step", step) && !ParseOption(arg, "maxDelay", maxDelay) &&
+            !ParseOption(arg, "threads", threadsText)) {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty() || paths.size() > 2) {
+        std::cerr << "Usage: uav-tools infer <trace> [output] [--truth=topology] [--metrics=file.csv] "
+                     "[--window=10] [--stride=0] [--mode=auto|peer|match|range] [--range=250] [--step=1] "
+                     "[--maxDelay=0.01] [--threads=N]\n";
+        return 1;
+    }
+    double windowLength = std::stod(window);
+    double windowStride = std::stod(stride) > 0.0 ? std::stod(stride) : windowLength;
+    UavWindowLinkInference inference;
+    if (!inference.Configure(windowLength, windowStride)) {
+        std::cerr << "window must be a positive multiple of stride: " << windowLength << "/" << windowStride << std::endl;
+        return 1;
+    }
+    uint32_t threads = std::max(1, std::stoi(threadsText));
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::string error;
+    MappedFile trace;
+    if (!trace.Open(paths[0], &error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    // 记录序列：二进制直接指向映射区，文本为各块解析结果
+    std::vector<std::pair<const UavTraceRecord*, size_t>> spans;
+    std::vector<ParsedChunk> chunks;
+    uint64_t badLines = 0;
+    UavTraceScenario scenario;
+    bool binary = trace.GetSize() >= sizeof(UavTraceFileHeader) &&
+                  std::memcmp(trace.Begin(), UAV_TRACE_MAGIC, sizeof(UAV_TRACE_MAGIC)) == 0;
+    if (binary) {
+        const UavTraceFileHeader* header = reinterpret_cast<const UavTraceFileHeader*>(trace.Begin());
+        if (header->version != UAV_TRACE_VERSION || header->recordSize != sizeof(UavTraceRecord)) {
+            std::cerr << paths[0] << " has an unsupported trace version" << std::endl;
+            return 1;
+        }
+        scenario = static_cast<UavTraceScenario>(header->scenario);
+        spans.emplace_back(reinterpret_cast<const UavTraceRecord*>(trace.Begin() + sizeof(UavTraceFileHeader)),
+                           (trace.GetSize() - sizeof(UavTraceFileHeader)) / sizeof(UavTraceRecord));
+    } else {
+        scenario = DetectTextFormat(trace.Begin(), trace.End());
+        LineParser parse = scenario == UAV_SCENARIO_FIRST ? &ParseFirstLine :
+                           scenario == UAV_SCENARIO_SECOND ? &ParseSecondLine :
+                           scenario == UAV_SCENARIO_THIRD ? &ParseThirdLine : nullptr;
+        if (!parse) {
+            std::cerr << paths[0] << ": unrecognized trace format" << std::endl;
+            return 1;
+        }
+        chunks = ParseText(trace.Begin(), trace.End(), parse, threads);
+        for (const ParsedChunk& c : chunks) {
+            spans.emplace_back(c.records.data(), c.records.size());
+            badLines += c.badLines;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    if (mode == "auto") {
+        mode = scenario != UAV_SCENARIO_THIRD ? "range" : binary ? "peer" : "match";
+    }
+    if (mode != "peer" && mode != "match" && mode != "range") {
+        std::cerr << "Unknown mode: " << mode << std::endl;
+        return 1;
+    }
+
+    std::vector<TruthSnapshot> truth;
+    if (!truthPath.empty() && !LoadTruth(truthPath, truth, &error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::ofstream file, metrics;
+    if (paths.size() == 2) {
+        file.open(paths[1]);
+        if (!file) {
+            std::cerr << "cannot open " << paths[1] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& os = paths.size() == 2 ? file : std::cout;
+    if (!metricsPath.empty()) {
+        metrics.open(metricsPath);
+        if (!metrics) {
+            std::cerr << "cannot open " << metricsPath << std::endl;
+            return 1;
+        }
+        metrics << "start,end,inferred,truth,true_positives,precision,recall\n";
+    }
+
+    // 窗口关闭：按 Third 的格式输出推断的链路，有真值时逐窗口评分
+    int precision = (windowLength == std::floor(windowLength) && windowStride == std::floor(windowStride)) ? 0 : 3;
+    InferTotals totals;
+    std::vector<Edge> inferred, expected, common;
+    inference.SetCallback([&](const UavLinkWindow& w) {
+        ++totals.windows;
+        os << std::fixed << std::setprecision(precision) << w.start << "-" << w.start + windowLength << "s: ";
+        if (w.edges.empty()) {
+            os << "none";
+        }
+        inferred.clear();
+        for (size_t k = 0; k < w.edges.size(); ++k) {
+            os << (k ? ", " : "") << "Node" << w.edges[k].i << "-Node" << w.edges[k].j;
+            inferred.emplace_back(w.edges[k].i, w.edges[k].j);
+        }
+        os << "\n";
+        if (truth.empty()) {
+            return;
+        }
+        bool known;
+        TruthForWindow(truth, w.start, w.end, expected, known);
+        if (!known) {
+            return;
+        }
+        common.clear();
+        std::set_intersection(inferred.begin(), inferred.end(), expected.begin(), expected.end(),
+                              std::back_inserter(common));
+        ++totals.scored;
+        totals.truePositives += common.size();
+        totals.inferred += inferred.size();
+        totals.truth += expected.size();
+        if (metrics.is_open()) {
+            metrics << std::fixed << std::setprecision(precision) << w.start << "," << w.end << "," << inferred.size() << ","
+                    << expected.size() << "," << common.size() << "," << std::setprecision(4)
+                    << Ratio(common.size(), inferred.size()) << "," << Ratio(common.size(), expected.size()) << "\n";
+        }
+    });
+
+    auto observe = [&inference](double time, uint32_t a, uint32_t b, uint64_t bytes) {
+        if (a != b) {
+            inference.Observe(time, std::min(a, b), std::max(a, b), bytes);
+        }
+    };
+    TxRxMatcher matcher(std::stod(maxDelay));
+    RangeLinker linker(std::stod(range), std::stod(step));
+    uint64_t records = 0, outOfOrder = 0;
+    double lastTime = 0.0;
+    for (const auto& span : spans) {
+        for (size_t k = 0; k < span.second; ++k) {
+            const UavTraceRecord& r = span.first[k];
+            if (r.time < lastTime) {
+                ++outOfOrder;   // 窗口推断要求时间单调不减
+                continue;
+            }
+            lastTime = r.time;
+            ++records;
+            if (mode == "peer") {
+                if (r.peer != UAV_TRACE_NO_PEER) {
+                    observe(r.time, r.node, r.peer, r.bytes);
+                }
+            } else if (mode == "match") {
+                matcher.Add(r, observe);
+            } else {
+                linker.Add(r, observe);
+            }
+        }
+    }
+    if (mode == "range") {
+        linker.Flush(observe);
+    }
+    inference.Finish(std::nextafter(lastTime, INFINITY));
+    auto t2 = std::chrono::steady_clock::now();
+
+    double parseSeconds = std::chrono::duration<double>(t1 - t0).count();
+    double totalSeconds = std::chrono::duration<double>(t2 - t0).count();
+    std::cerr << "Read " << records << " records from " << paths[0] << " ("
+              << (binary ? "binary" : "text, " + std::to_string(chunks.size()) + " parse threads") << ") in "
+              << std::fixed << std::setprecision(3) << parseSeconds << " s, total " << totalSeconds << " s, "
+              << std::setprecision(1) << trace.GetSize() / 1e6 / std::max(totalSeconds, 1e-9) << " MB/s" << std::endl;
+    if (badLines || outOfOrder) {
+        std::cerr << "Skipped " << badLines << " unparsable lines, " << outOfOrder << " out-of-order records" << std::endl;
+    }
+    if (mode == "match") {
+        std::cerr << "Matched " << matcher.GetMatched() << " receptions, " << matcher.GetUnmatched()
+                  << " without a transmission within " << maxDelay << " s" << std::endl;
+    }
+    std::cerr << "Inferred " << totals.windows << " windows (" << mode << ")" << std::endl;
+    if (!truth.empty()) {
+        std::cerr << "Scored " << totals.scored << " windows against " << truthPath << ": precision "
+                  << std::setprecision(4) << Ratio(totals.truePositives, totals.inferred) << ", recall "
+                  << Ratio(totals.truePositives, totals.truth) << " (" << totals.truePositives << " of "
+                  << totals.inferred << " inferred, " << totals.truth << " true links)" << std::endl;
+    }
+    return 0;
+}
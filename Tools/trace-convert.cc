@@ -0,0 +1,99 @@
+#include "uav-tools.h"
+#include "../Common/uav-binary-trace.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+// 按各场景原有的文本格式输出一条记录
+static void WriteFirst(std::ostream& os, const UavTraceRecord& r) {
+    os << "Time: " << r.time << "s, Node ID: " << r.node
+       << ", Position: (" << r.x << ", " << r.y << ", " << r.z << ")\n";
+}
+
+static void WriteSecond(std::ostream& os, const UavTraceRecord& r) {
+    os << r.time << "," << r.node << "," << UavTraceEventName(r.event) << ","
+       << r.x << "," << r.y << "," << r.z << "\n";
+}
+
+static void WriteThird(std::ostream& os, const UavTraceRecord& r) {
+    os << std::fixed << std::setprecision(3)
+       << r.time << "s " << "Node" << r.node << " " << UavTraceEventName(r.event) << "\n";
+}
+
+// 通用 CSV，保留全部字段和完整精度
+static void WriteCsv(std::ostream& os, const UavTraceRecord& r) {
+    os << r.time << "," << r.node << "," << UavTraceEventName(r.event) << ",";
+    if (r.peer != UAV_TRACE_NO_PEER) {
+        os << r.peer;
+    }
+    os << "," << r.x << "," << r.y << "," << r.z << "," << r.bytes << "\n";
+}
+
+int RunTraceConvert(const std::vector<std::string>& args) {
+    std::string format = "auto";
+    std::vector<std::string> paths;
+    for (const std::string& arg : args) {
+        if (!ParseOption(arg, "format", format)) {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty() || paths.size() > 2) {
+        std::cerr << "Usage: uav-tools convert <trace.bin> [output] [--format=auto|first|second|third|csv]\n";
+        return 1;
+    }
+
+    UavBinaryTraceReader reader;
+    std::string error;
+    if (!reader.Open(paths[0], &error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    if (format == "auto") {
+        switch (reader.GetHeader().scenario) {
+        case UAV_SCENARIO_FIRST: format = "first"; break;
+        case UAV_SCENARIO_SECOND: format = "second"; break;
+        case UAV_SCENARIO_THIRD: format = "third"; break;
+        default: format = "csv"; break;
+        }
+    }
+
+    void (*write)(std::ostream&, const UavTraceRecord&) = nullptr;
+    if (format == "first") {
+        write = &WriteFirst;
+    } else if (format == "second") {
+        write = &WriteSecond;
+    } else if (format == "third") {
+        write = &WriteThird;
+    } else if (format == "csv") {
+        write = &WriteCsv;
+    } else {
+        std::cerr << "Unknown format: " << format << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (paths.size() == 2) {
+        file.open(paths[1]);
+        if (!file) {
+            std::cerr << "cannot open " << paths[1] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& os = paths.size() == 2 ? file : std::cout;
+    if (format == "csv") {
+        os << std::setprecision(std::numeric_limits<double>::max_digits10)
+           << "time,node,event,peer,x,y,z,bytes\n";
+    }
+
+    UavTraceRecord record;
+    uint64_t count = 0;
+    while (reader.Next(record)) {
+        write(os, record);
+        ++count;
+    }
+    std::cerr << "Converted " << count << " records (" << format << ")" << std::endl;
+    return 0;
+}
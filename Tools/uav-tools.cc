@@ -0,0 +1,52 @@
+// 仿真数据离线处理工具，不依赖 ns-3，可单独编译：
+//   g++ -O2 -std=c++17 -pthread Tools/*.cc -o uav-tools
+#include "uav-tools.h"
+
+#include <iostream>
+
+static void PrintUsage() {
+    std::cerr << "Usage: uav-tools <command> [args]\n"
+              << "Commands:\n"
+              << "  convert <trace.bin> [output] [--format=auto|first|second|third|csv]\n"
+              << "      Convert a binary trace back to the scenario text/CSV format\n"
+              << "  topology <topology.delta> [output] [--format=auto|second|third|events] [--at=t]\n"
+              << "      Rebuild topology snapshots from a delta topology log\n"
+              << "  infer <trace> [output] [--truth=topology] [--window=10] [--stride=0] [--metrics=file.csv]\n"
+              << "      Infer per-window communication graphs from a transmission trace and score them\n"
+              << "  sweep --binary=<scenario> [--out=dir] [--runs=1-10] [--param=name=v1,v2 ...] [--jobs=N]\n"
+              << "      Run a parameter sweep in parallel and write a manifest\n"
+              << "  scale --first=<bin> --second=<bin> --third=<bin> [--sizes=20,50,...] [--out=dir]\n"
+              << "      Run the scenarios headless at several swarm sizes and write scaling.csv\n"
+              << "  compare --reference=<bin> --candidate=<bin> [--referenceArg=...] [--candidateArg=...] [--arg=...]\n"
+              << "      Run two scenario programs with the same arguments and diff their outputs byte by byte\n";
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        PrintUsage();
+        return 1;
+    }
+    std::string command = argv[1];
+    std::vector<std::string> args(argv + 2, argv + argc);
+
+    if (command == "convert") {
+        return RunTraceConvert(args);
+    }
+    if (command == "topology") {
+        return RunTopologyConvert(args);
+    }
+    if (command == "infer") {
+        return RunTopologyInfer(args);
+    }
+    if (command == "sweep") {
+        return RunSweep(args);
+    }
+    if (command == "scale") {
+        return RunScale(args);
+    }
+    if (command == "compare") {
+        return RunCompare(args);
+    }
+    PrintUsage();
+    return 1;
+}
@@ -0,0 +1,42 @@
+#ifndef UAV_TOOLS_H
+#define UAV_TOOLS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 各子命令入口，args 不含程序名和子命令名，返回进程退出码
+int RunTraceConvert(const std::vector<std::string>& args);
+int RunSweep(const std::vector<std::string>& args);
+int RunScale(const std::vector<std::string>& args);
+int RunTopologyConvert(const std::vector<std::string>& args);
+int RunTopologyInfer(const std::vector<std::string>& args);
+int RunCompare(const std::vector<std::string>& args);
+
+// 子进程运行结果
+struct ChildResult {
+    int exitStatus = -1;        // 退出码，被信号终止时为 128 + 信号值
+    double wallSeconds = 0.0;   // 墙钟耗时
+    long maxRssKb = 0;          // 峰值常驻内存
+};
+
+// 启动 args[0]，标准输出/错误重定向到 logPath，等待其结束（process.cc）
+ChildResult RunChild(std::vector<std::string> args, const std::string& logPath);
+// 逐级创建目录
+bool MakeDirectories(const std::string& path);
+// 按分隔符切分，忽略空项
+std::vector<std::string> SplitList(const std::string& text, char sep);
+// 解析 "1-10" 或 "1,3,5" 形式的整数列表
+std::vector<uint32_t> ParseRange(const std::string& text);
+
+// 解析 "--key=value" 形式的参数，匹配时写入 value 并返回 true
+inline bool ParseOption(const std::string& arg, const std::string& key, std::string& value) {
+    std::string prefix = "--" + key + "=";
+    if (arg.compare(0, prefix.size(), prefix) == 0) {
+        value = arg.substr(prefix.size());
+        return true;
+    }
+    return false;
+}
+
+#endif // UAV_TOOLS_H